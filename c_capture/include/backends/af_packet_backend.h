@@ -0,0 +1,91 @@
+#ifndef AF_PACKET_BACKEND_H
+#define AF_PACKET_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * AF_PACKET 后端默认环形缓冲区参数
+ */
+#define AF_PACKET_DEFAULT_BLOCK_SIZE   (1u << 22)  // 每个块 4 MiB
+#define AF_PACKET_DEFAULT_BLOCK_COUNT  64          // 块数量
+#define AF_PACKET_DEFAULT_FRAME_SIZE   2048        // 帧大小
+#define AF_PACKET_DEFAULT_RETIRE_MS    60          // 块超时退役时间
+#define AF_PACKET_MAX_FANOUT           64          // 最大扇出套接字数
+
+/**
+ * PACKET_FANOUT 分发模式
+ */
+typedef enum {
+    AF_PACKET_FANOUT_HASH,    // 按流哈希分发，同一流始终进入同一套接字
+    AF_PACKET_FANOUT_CPU,     // 按接收数据包的 CPU 分发
+    AF_PACKET_FANOUT_ROLLOVER,// 当前套接字积压时转入下一个
+    AF_PACKET_FANOUT_LB,      // 轮询分发
+    AF_PACKET_FANOUT_QM,      // 按网卡接收队列分发
+} af_packet_fanout_mode_t;
+
+/**
+ * AF_PACKET (TPACKET_V3) 后端特定配置
+ *
+ * 环形缓冲区参数为 0 时使用默认值，环形缓冲区按套接字分别分配。
+ * fanout_count 大于 1 时打开多个套接字并加入同一个 PACKET_FANOUT 组，
+ * 每个套接字由独立的接收线程处理。
+ */
+typedef struct {
+    const char* device;       // 设备名称
+    const char* filter;       // BPF 过滤器
+    int snaplen;              // 抓包长度
+    int timeout_ms;           // 块退役超时（毫秒）
+    bool promiscuous;         // 是否开启混杂模式
+    uint32_t block_size;      // 环形缓冲区块大小（页大小的整数倍）
+    uint32_t block_count;     // 环形缓冲区块数量
+    uint32_t frame_size;      // 帧大小（TPACKET_ALIGNMENT 的整数倍）
+    uint32_t fanout_count;    // 扇出套接字数，0 或 1 表示不使用扇出
+    af_packet_fanout_mode_t fanout_mode; // 扇出分发模式
+    uint16_t fanout_group;    // 扇出组 ID，0 表示自动分配
+    bool fanout_defrag;       // 分发前是否由内核重组 IP 分片
+    const uint32_t* cpus;     // 接收线程绑定的 CPU，第 i 个套接字使用 cpus[i % cpu_count]
+    uint32_t cpu_count;       // cpus 中的 CPU 数
+    uint64_t numa_nodes;      // 未指定 CPU 时接收线程与块环所在的 NUMA 节点（位掩码）
+} af_packet_backend_config_t;
+
+/**
+ * 创建 AF_PACKET 后端
+ *
+ * 打开 AF_PACKET 套接字并将 TPACKET_V3 块环映射到用户空间，
+ * 抓包时直接遍历块，回调中的 packet_t.data 指向环内存，不做拷贝。
+ * 数据仅在回调期间有效，整个块在其中所有数据包处理完后一次性归还内核。
+ *
+ * 使用扇出时，第一个套接字在调用 start 的线程上接收，其余套接字各有一个
+ * 接收线程，回调会被并发调用；start 在所有接收线程退出后返回。
+ *
+ * 指定了 cpus 或 numa_nodes 时，每个套接字的块环在其接收线程所在的节点上
+ * 建立，扇出接收线程绑定到对应 CPU；0 号套接字在调用 start 的线程上接收，
+ * 该线程的绑定由调用者负责。
+ *
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* af_packet_backend_create(
+    const af_packet_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁 AF_PACKET 后端
+ * @param backend 后端结构
+ */
+void af_packet_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AF_PACKET_BACKEND_H
@@ -3,6 +3,9 @@
 
 #include "../capture_types.h"
 #include "../capture.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,7 +29,22 @@ typedef struct {
     
     // 开始抓包
     int (*start)(void* backend, packet_callback_t callback, void* user_data);
+
+    // 以批量回调方式开始抓包（可选）
+    int (*start_batch)(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
     
+    // 以拉取方式获取一批数据包（可选），返回数量或负的错误码
+    int (*next_batch)(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+
+    // 获取可加入 poll/epoll 的文件描述符（可选）
+    int (*get_fd)(void* backend);
+
+    // 零拷贝租用数据包（可选），不支持时返回 CAPTURE_ERROR_NOT_SUPPORTED
+    int (*lease)(void* backend, const packet_t* packet);
+
+    // 归还零拷贝租用的数据包（可选），可在任意线程调用
+    void (*release)(void* backend, const packet_t* packet);
+
     // 停止抓包
     int (*stop)(void* backend);
     
@@ -41,6 +59,9 @@ typedef struct {
     
     // 获取统计信息
     int (*get_stats)(void* backend, capture_stats_t* stats);
+
+    // 获取各线程的统计信息（可选），返回线程总数或负的错误码
+    int (*get_thread_stats)(void* backend, capture_thread_stats_t* stats, uint32_t max);
     
     // 获取设备列表
     int (*get_devices)(void* backend, capture_device_t** devices, int* count);
@@ -76,8 +97,356 @@ typedef struct {
     capture_backend_type_t type;     // 后端类型
     error_callback_t error_cb;       // 错误回调
     void* error_user_data;          // 错误回调用户数据
+    atomic_bool stop_requested;      // 是否已请求停止，由启动方在启动前清除，start 不清除；拉取时由下一次 capture_next_batch 清除
 } capture_backend_t;
 
+/**
+ * 清除后端的停止请求
+ *
+ * 由启动方（capture_launch 与包装后端）在调用 start 之前调用。start 本身
+ * 不清除停止请求，早于 start 置位运行标志到达的 stop 因此不会被覆盖。
+ *
+ * @param backend 后端结构
+ */
+static inline void capture_backend_rearm(capture_backend_t* backend) {
+    atomic_store(&backend->stop_requested, false);
+}
+
+/**
+ * 接收循环开始时置位运行标志
+ *
+ * 先置位运行标志再检查停止请求，与 capture_backend_request_stop 按相反
+ * 顺序访问两个标志，无论如何交错运行标志最终都为 false。
+ *
+ * @param backend 后端结构
+ * @param running 后端的运行标志
+ * @return 可以开始接收返回 true，已请求停止返回 false
+ */
+static inline bool capture_backend_enter(capture_backend_t* backend, atomic_bool* running) {
+    atomic_store(running, true);
+    if (atomic_load(&backend->stop_requested)) {
+        atomic_store(running, false);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 请求停止并清除运行标志，调用方随后唤醒接收循环
+ * @param backend 后端结构
+ * @param running 后端的运行标志
+ */
+static inline void capture_backend_request_stop(capture_backend_t* backend, atomic_bool* running) {
+    atomic_store(&backend->stop_requested, true);
+    atomic_store(running, false);
+}
+
+/**
+ * 单个线程的计数器
+ *
+ * 每个计数器只由所属线程写入，写入用 relaxed 的加载加存储完成（编译为
+ * 普通的读写指令，没有带锁的读改写），其他线程随时以 relaxed 加载读取，
+ * 读取时再把各线程的计数器相加。按缓存行对齐，不同线程的计数器不会
+ * 落在同一缓存行上。
+ */
+typedef struct {
+    _Alignas(64) atomic_uint_fast64_t packets; // 交付的数据包数
+    atomic_uint_fast64_t bytes;      // 交付的字节数
+    atomic_uint_fast64_t batches;    // 交付的批数
+    atomic_uint_fast64_t batch_hist[CAPTURE_BATCH_HIST_BUCKETS]; // 批大小直方图
+    atomic_uint_fast64_t dropped_newest; // 队列满时丢弃的新数据包数
+    atomic_uint_fast64_t dropped_oldest; // 为新数据包让位而丢弃的积压数据包数
+    atomic_uint_fast64_t sampled_out; // 过载采样未保留的数据包数
+    atomic_uint_fast64_t blocked;    // 因队列满而等待的次数
+    atomic_uint_fast64_t blocked_ns; // 等待的总时间（纳秒）
+} capture_counters_t;
+
+/**
+ * 当前线程的接收线程序号
+ *
+ * 多个接收线程的后端（扇出）在每个接收线程开始接收前设置，下游按它
+ * 选择该线程独占的队列与计数器；单接收线程的后端不设置，保持为 0。
+ */
+extern _Thread_local uint32_t capture_rx_index;
+
+/**
+ * 增加计数器，只能由计数器所属的线程调用
+ * @param counter 计数器
+ * @param value 增量
+ */
+static inline void capture_counter_add(atomic_uint_fast64_t* counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+/**
+ * 读取计数器
+ * @param counter 计数器
+ * @return 当前值
+ */
+static inline uint64_t capture_counter_get(const atomic_uint_fast64_t* counter) {
+    return atomic_load_explicit((atomic_uint_fast64_t*)counter, memory_order_relaxed);
+}
+
+/**
+ * 记录逐包交付的一个数据包
+ * @param counters 计数器
+ * @param len 数据包长度
+ */
+static inline void capture_counters_packet(capture_counters_t* counters, uint32_t len) {
+    capture_counter_add(&counters->packets, 1);
+    capture_counter_add(&counters->bytes, len);
+}
+
+/**
+ * 记录一次成批交付
+ * @param counters 计数器
+ * @param count 数据包数，至少为 1
+ * @param bytes 字节数
+ */
+static inline void capture_counters_batch(capture_counters_t* counters, uint32_t count, uint64_t bytes) {
+    uint32_t bucket = 31 - (uint32_t)__builtin_clz(count);
+    if (bucket >= CAPTURE_BATCH_HIST_BUCKETS) {
+        bucket = CAPTURE_BATCH_HIST_BUCKETS - 1;
+    }
+    capture_counter_add(&counters->packets, count);
+    capture_counter_add(&counters->bytes, bytes);
+    capture_counter_add(&counters->batches, 1);
+    capture_counter_add(&counters->batch_hist[bucket], 1);
+}
+
+/**
+ * 把计数器累加到统计信息中
+ *
+ * 交付计数累加到 packets_received、bytes_received 与批大小直方图，
+ * 过载计数累加到 overload_*，其中丢弃的数据包同时计入 packets_dropped。
+ * 调用 get_stats 的一方（capture_get_stats 与包装后端）会先把 stats 清零。
+ *
+ * @param counters 计数器
+ * @param stats 统计信息结构
+ */
+void capture_counters_merge(const capture_counters_t* counters, capture_stats_t* stats);
+
+/**
+ * 把计数器写入一个线程的统计信息
+ * @param counters 计数器
+ * @param role 线程角色
+ * @param index 线程序号
+ * @param stats 线程统计信息
+ */
+void capture_counters_read(const capture_counters_t* counters, capture_thread_role_t role,
+                           uint32_t index, capture_thread_stats_t* stats);
+
+/**
+ * 把计数器中的过载计数累加到一个线程的统计信息中
+ *
+ * 包装后端用它把自己队列的过载计数归到写入队列的线程上。
+ *
+ * @param counters 计数器
+ * @param stats 线程统计信息
+ */
+void capture_counters_add_overload(const capture_counters_t* counters, capture_thread_stats_t* stats);
+
+/**
+ * 获取后端各线程的统计信息
+ *
+ * 后端没有实现 get_thread_stats 时把 get_stats 的结果作为 0 号接收线程。
+ *
+ * @param backend 后端结构
+ * @param stats 线程统计信息数组
+ * @param max 数组容量
+ * @return 线程总数（可能大于 max，只填写前 max 个），失败返回负的错误码
+ */
+int capture_backend_thread_stats(capture_backend_t* backend, capture_thread_stats_t* stats, uint32_t max);
+
+/**
+ * 数据包交付器
+ *
+ * 后端通过它把数据包交给单包回调或批量回调。批量模式下数据包先暂存在
+ * 数组中，攒满 burst_size 个或后端调用 capture_sink_flush 时一次性交付；
+ * 后端必须在数据包内存失效（归还内核块、复用接收缓冲区等）之前 flush。
+ * 交付的数据包计入 counters（单包模式逐包计数，批量模式按批计数）。
+ */
+typedef struct {
+    packet_callback_t packet_cb;     // 单包回调
+    packet_batch_callback_t batch_cb; // 批量回调，非 NULL 时使用批量模式
+    void* user_data;                 // 用户数据
+    capture_counters_t* counters;    // 交付计数器，由运行交付器的线程独占
+    packet_t* batch;                 // 暂存数组
+    uint32_t count;                  // 已暂存的数据包数
+    uint32_t burst_size;             // 每批最大数据包数
+    uint64_t bytes;                  // 已暂存数据包的字节数
+} capture_sink_t;
+
+/**
+ * 初始化数据包交付器
+ * @param sink 交付器
+ * @param packet_cb 单包回调，批量模式下为 NULL
+ * @param batch_cb 批量回调，单包模式下为 NULL
+ * @param burst_size 每批最大数据包数，0 表示默认值
+ * @param user_data 用户数据
+ * @param counters 交付计数器
+ * @return 成功返回 0，失败返回错误码
+ */
+static inline int capture_sink_init(capture_sink_t* sink, packet_callback_t packet_cb,
+                                    packet_batch_callback_t batch_cb, uint32_t burst_size,
+                                    void* user_data, capture_counters_t* counters) {
+    sink->packet_cb = packet_cb;
+    sink->batch_cb = batch_cb;
+    sink->user_data = user_data;
+    sink->counters = counters;
+    sink->batch = NULL;
+    sink->count = 0;
+    sink->burst_size = 1;
+    sink->bytes = 0;
+
+    if (batch_cb) {
+        if (burst_size == 0) {
+            burst_size = CAPTURE_DEFAULT_BURST_SIZE;
+        }
+        if (burst_size > CAPTURE_MAX_BURST_SIZE) {
+            burst_size = CAPTURE_MAX_BURST_SIZE;
+        }
+        sink->batch = (packet_t*)malloc(sizeof(packet_t) * burst_size);
+        if (!sink->batch) {
+            return CAPTURE_ERROR_MEMORY;
+        }
+        sink->burst_size = burst_size;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+/**
+ * 释放数据包交付器的暂存数组
+ * @param sink 交付器
+ */
+static inline void capture_sink_destroy(capture_sink_t* sink) {
+    free(sink->batch);
+    sink->batch = NULL;
+    sink->count = 0;
+    sink->bytes = 0;
+}
+
+/**
+ * 交付已暂存的数据包
+ * @param sink 交付器
+ * @return 回调要求继续返回 true
+ */
+static inline bool capture_sink_flush(capture_sink_t* sink) {
+    if (sink->count == 0) {
+        return true;
+    }
+    uint32_t count = sink->count;
+    capture_counters_batch(sink->counters, count, sink->bytes);
+    sink->count = 0;
+    sink->bytes = 0;
+    return sink->batch_cb(sink->batch, count, sink->user_data);
+}
+
+/**
+ * 交付或暂存一个数据包
+ * @param sink 交付器
+ * @param packet 数据包
+ * @return 回调要求继续返回 true
+ */
+static inline bool capture_sink_push(capture_sink_t* sink, const packet_t* packet) {
+    if (!sink->batch_cb) {
+        capture_counters_packet(sink->counters, packet->len);
+        return sink->packet_cb(packet, sink->user_data);
+    }
+    sink->bytes += packet->len;
+    sink->batch[sink->count++] = *packet;
+    if (sink->count < sink->burst_size) {
+        return true;
+    }
+    return capture_sink_flush(sink);
+}
+
+/**
+ * 一组同类线程（接收线程或工作线程）的放置
+ *
+ * 第 i 个线程绑定到 cpus[i % cpu_count]，内存放在该 CPU 所在的 NUMA 节点；
+ * 没有 CPU 列表但 numa_nodes 非 0 时，线程限制在这些节点的 CPU 上运行，
+ * 内存放在其中编号最小的节点；两者都为空时不做任何限制。
+ */
+typedef struct {
+    uint32_t* cpus;                  // 绑定的 CPU 列表（自有副本）
+    uint32_t cpu_count;              // CPU 数
+    uint64_t numa_nodes;             // 未绑定单个 CPU 时允许的 NUMA 节点（位掩码）
+} capture_affinity_t;
+
+/**
+ * 保存的线程 CPU 掩码，与 cpu_set_t 大小相同
+ */
+typedef struct {
+    unsigned long bits[1024 / (8 * sizeof(unsigned long))];
+} capture_cpu_mask_t;
+
+/**
+ * 初始化线程放置
+ * @param affinity 线程放置
+ * @param cpus CPU 列表，可为 NULL
+ * @param cpu_count CPU 数
+ * @param numa_nodes NUMA 节点掩码
+ * @param spread 没有 CPU 列表时，是否把线程依次绑定到允许的 CPU（受 numa_nodes 限制）
+ * @return 成功返回 0，CPU 不在进程允许范围内返回 CAPTURE_ERROR_INVALID_PARAM，
+ *         其他失败返回错误码
+ */
+int capture_affinity_init(capture_affinity_t* affinity, const uint32_t* cpus, uint32_t cpu_count,
+                          uint64_t numa_nodes, bool spread);
+
+/**
+ * 释放线程放置
+ * @param affinity 线程放置
+ */
+void capture_affinity_destroy(capture_affinity_t* affinity);
+
+/**
+ * 获取第 index 个线程的内存所在节点
+ * @param affinity 线程放置
+ * @param index 线程序号
+ * @return NUMA 节点，不指定时返回 -1
+ */
+int capture_affinity_node(const capture_affinity_t* affinity, uint32_t index);
+
+/**
+ * 为将要创建的第 index 个线程设置 CPU 亲和性
+ * @param affinity 线程放置
+ * @param index 线程序号
+ * @param attr 线程属性
+ */
+void capture_affinity_attr(const capture_affinity_t* affinity, uint32_t index, pthread_attr_t* attr);
+
+/**
+ * 把调用线程临时放到第 index 个线程的位置上
+ * @param affinity 线程放置
+ * @param index 线程序号
+ * @param saved 返回原来的 CPU 掩码
+ * @return 改变了亲和性返回 true，此时需要调用 capture_affinity_leave
+ */
+bool capture_affinity_enter(const capture_affinity_t* affinity, uint32_t index, capture_cpu_mask_t* saved);
+
+/**
+ * 恢复 capture_affinity_enter 之前的 CPU 掩码
+ * @param saved capture_affinity_enter 保存的掩码
+ */
+void capture_affinity_leave(const capture_cpu_mask_t* saved);
+
+/**
+ * 在指定 NUMA 节点上分配按页对齐的内存
+ * @param size 字节数
+ * @param node NUMA 节点，-1 表示不指定
+ * @return 成功返回内存，失败返回 NULL
+ */
+void* capture_numa_alloc(size_t size, int node);
+
+/**
+ * 释放 capture_numa_alloc 分配的内存
+ * @param ptr 内存
+ * @param size 分配时的字节数
+ */
+void capture_numa_free(void* ptr, size_t size);
+
 /**
  * 注册后端
  * @param backend 后端结构
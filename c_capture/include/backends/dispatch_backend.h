@@ -0,0 +1,85 @@
+#ifndef DISPATCH_BACKEND_H
+#define DISPATCH_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 按流分发后端默认参数
+ */
+#define DISPATCH_DEFAULT_QUEUE_BYTES (8u << 20)  // 每个工作线程的分发队列大小
+#define DISPATCH_MIN_QUEUE_BYTES     (256u << 10) // 每个接收线程到工作线程的队列的最小大小
+#define DISPATCH_MAX_WORKERS         64          // 最大工作线程数
+
+/**
+ * 按流分发后端配置
+ *
+ * 参数为 0 时使用默认值。
+ */
+typedef struct {
+    uint32_t worker_count;      // 工作线程数
+    uint32_t queue_bytes;       // 每个工作线程的分发队列大小（字节），由各接收线程的队列平分
+    uint32_t producer_count;    // 内部后端调用回调的接收线程数（扇出数），0 表示 1
+    const uint32_t* cpus;       // 工作线程绑定的 CPU，第 i 个工作线程使用 cpus[i % cpu_count]
+    uint32_t cpu_count;         // cpus 中的 CPU 数，0 表示依次使用进程允许的 CPU
+    uint64_t numa_nodes;        // 未指定 CPU 时只使用这些 NUMA 节点上的 CPU（位掩码）
+    capture_overload_t overload; // 队列满时的过载策略，未指定时丢弃新数据包
+} dispatch_backend_config_t;
+
+/**
+ * 创建按流分发后端
+ *
+ * 调用 start 的线程运行内部后端的接收循环，按对称五元组哈希把每个数据包
+ * 拷贝进某个工作线程的单生产者单消费者队列；工作线程绑定到 cpus 中的
+ * CPU（未指定时依次使用进程允许的 CPU），在自己的线程上调用用户回调，
+ * 队列分配在工作线程所在的 NUMA 节点上。同一条流两个方向的数据包总是
+ * 交给同一个工作线程，重组状态按工作线程划分即可，不需要加锁。
+ *
+ * 哈希取接收时解码得到的 packet_t.hash（未解码的数据包按以太网帧解码）。
+ * 非 IP 数据包交给 0 号工作线程；IP 分片只按地址对哈希，
+ * 同一个数据报的所有分片落在同一个工作线程上。内部后端有多个接收线程时
+ * （扇出），每个接收线程按 capture_rx_index 使用自己到各工作线程的队列，
+ * 每个队列只有一个生产者。队列满时按 overload 处理：
+ * DROP_OLDEST 由接收线程在写入前持队列锁推进队首、丢弃积压的记录，
+ * 工作线程取包时持同一把锁把记录拷贝出队列；BLOCK 让接收线程等待
+ * （capture_stop 可打断），丢弃的数据包按原因分别计数并计入
+ * packets_dropped。内部后端结束（如重放完毕）后，工作线程交付完队列中
+ * 剩余的数据包才退出；capture_stop 则立即停止。
+ *
+ * 拉取模式（next_batch、get_fd）直接转发给内部后端，不经过工作线程。
+ * 成功后内部后端归分发后端所有，随分发后端一起清理。
+ *
+ * @param inner 内部后端
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* dispatch_backend_create(
+    capture_backend_t* inner,
+    const dispatch_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁按流分发后端及其内部后端
+ * @param backend 后端结构
+ */
+void dispatch_backend_destroy(capture_backend_t* backend);
+
+/**
+ * 获取当前线程的工作线程序号
+ * @return 在分发工作线程上返回其序号，否则返回 -1
+ */
+int dispatch_backend_worker_id(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPATCH_BACKEND_H
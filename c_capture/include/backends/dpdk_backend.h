@@ -0,0 +1,64 @@
+#ifndef DPDK_BACKEND_H
+#define DPDK_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * DPDK 后端默认参数
+ */
+#define DPDK_DEFAULT_BURST_SIZE     32     // rte_eth_rx_burst 单次最大收包数
+#define DPDK_DEFAULT_MEMPOOL_SIZE   8191   // mbuf 池大小
+#define DPDK_DEFAULT_MEMPOOL_CACHE  256    // mbuf 池每核缓存大小
+#define DPDK_DEFAULT_RX_DESC        1024   // RX 描述符数量
+
+/**
+ * DPDK 后端特定配置
+ *
+ * 数值参数为 0 时使用默认值。
+ */
+typedef struct {
+    const char* device;       // 端口名称（如 "net_null0"），为 NULL 时使用 port_id
+    const char* eal_args;     // EAL 参数，以空格分隔（如 "--no-pci --vdev=net_null0"）
+    uint16_t port_id;         // 端口号
+    uint16_t queue_id;        // 接收队列
+    uint16_t burst_size;      // 单次收包最大数量
+    uint16_t rx_desc;         // RX 描述符数量
+    uint32_t mempool_size;    // mbuf 池大小
+    uint32_t mempool_cache;   // mbuf 池每核缓存大小
+    bool promiscuous;         // 是否开启混杂模式
+} dpdk_backend_config_t;
+
+/**
+ * 创建 DPDK 后端
+ *
+ * 首次调用时初始化 EAL，随后配置端口并按突发方式收包。
+ * 回调中的 packet_t.data 直接指向 mbuf 数据区，整批回调结束后 mbuf 批量释放。
+ * 可配合 net_null、net_ring、net_pcap 等虚拟 PMD 在普通 Linux 主机上运行。
+ *
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* dpdk_backend_create(
+    const dpdk_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁 DPDK 后端
+ * @param backend 后端结构
+ */
+void dpdk_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DPDK_BACKEND_H
@@ -0,0 +1,77 @@
+#ifndef MULTI_BACKEND_H
+#define MULTI_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 多设备聚合后端默认参数
+ */
+#define MULTI_DEFAULT_QUEUE_BYTES     (8u << 20)  // 每个成员的合并队列大小
+#define MULTI_DEFAULT_MERGE_WINDOW_US 1000        // 时间戳排序窗口（微秒）
+#define MULTI_MIN_QUEUE_BYTES         (256u << 10) // 每个接收线程的合并队列的最小大小
+#define MULTI_MAX_MEMBERS             32          // 最大成员数
+
+/**
+ * 多设备聚合后端配置
+ *
+ * 参数为 0 时使用默认值。
+ */
+typedef struct {
+    uint32_t queue_bytes;       // 每个成员的合并队列大小（字节），由该成员各接收线程的队列平分
+    uint32_t rx_threads;        // 每个成员调用回调的接收线程数（扇出数），0 表示 1
+    uint32_t merge_window_us;   // 等待其他成员数据包的最长时间（微秒）
+    const uint32_t* cpus;       // 成员抓包线程绑定的 CPU，第 i 个成员使用 cpus[i % cpu_count]
+    uint32_t cpu_count;         // cpus 中的 CPU 数
+    uint64_t numa_nodes;        // 未指定 CPU 时成员线程与队列所在的 NUMA 节点（位掩码）
+    capture_overload_t overload; // 队列满时的过载策略
+    const char* filter;         // 成员创建时使用的过滤器，更换失败时据此回滚
+} multi_backend_config_t;
+
+/**
+ * 创建多设备聚合后端
+ *
+ * 每个成员后端在独立线程上抓包，数据包拷贝进该成员的单生产者单消费者队列；
+ * 调用 start 的线程按时间戳归并各队列并交付，packet_t.device_index 设为成员在
+ * members 数组中的序号，if_index 保留成员后端填写的值。某个成员暂时没有数据包时，其他成员的数据包最多等待
+ * merge_window_us 后交付，因此空闲接口不会阻塞归并。队列满时按 overload
+ * 处理（未指定时丢弃新数据包），丢弃的数据包计入 packets_dropped。每个成员
+ * 的队列分配在其抓包线程所在的 NUMA 节点上。成员有多个接收线程时（扇出），
+ * 每个接收线程按 capture_rx_index 使用自己的队列，每个队列只有一个生产者。
+ * 归并线程交付时 capture_rx_index 为 0。
+ *
+ * set_filter 依次更换各成员的过滤器，某个成员失败时已更换的成员恢复为
+ * 原来的过滤器，各成员不会停留在不同的过滤器上。
+ *
+ * 成功后成员后端归聚合后端所有，随聚合后端一起清理。
+ *
+ * @param members 成员后端数组
+ * @param count 成员数量
+ * @param config 配置信息，可为 NULL
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* multi_backend_create(
+    capture_backend_t** members,
+    uint32_t count,
+    const multi_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁多设备聚合后端及其成员后端
+ * @param backend 后端结构
+ */
+void multi_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MULTI_BACKEND_H
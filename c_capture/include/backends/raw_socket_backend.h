@@ -0,0 +1,57 @@
+#ifndef RAW_SOCKET_BACKEND_H
+#define RAW_SOCKET_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 原始套接字后端默认参数
+ */
+#define RAW_SOCKET_DEFAULT_BATCH_SIZE  64   // 每次 recvmmsg 读取的最大数据包数
+#define RAW_SOCKET_MAX_BATCH_SIZE      1024 // 批量大小上限
+
+/**
+ * 原始套接字 (recvmmsg) 后端特定配置
+ */
+typedef struct {
+    const char* device;       // 设备名称
+    const char* filter;       // BPF 过滤器
+    int snaplen;              // 抓包长度，即每个接收缓冲区的大小
+    bool promiscuous;         // 是否开启混杂模式
+    uint32_t batch_size;      // 每次系统调用读取的最大数据包数，0 表示默认值
+    uint32_t rcvbuf_size;     // 套接字接收缓冲区大小（SO_RCVBUF），0 表示系统默认
+} raw_socket_backend_config_t;
+
+/**
+ * 创建原始套接字后端
+ *
+ * 在无法映射 PACKET_RX_RING 的环境中使用：从普通 AF_PACKET 套接字通过 recvmmsg
+ * 一次读取一批数据包到预分配的缓冲区数组，回调中的 packet_t.data 指向这些缓冲区，
+ * 仅在回调期间有效。
+ *
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* raw_socket_backend_create(
+    const raw_socket_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁原始套接字后端
+ * @param backend 后端结构
+ */
+void raw_socket_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RAW_SOCKET_BACKEND_H
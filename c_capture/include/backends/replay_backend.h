@@ -0,0 +1,75 @@
+#ifndef REPLAY_BACKEND_H
+#define REPLAY_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+#include "pcap_file.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 重放速度模式
+ */
+typedef enum {
+    REPLAY_SPEED_FASTEST,     // 尽可能快
+    REPLAY_SPEED_ORIGINAL,    // 按原始时间间隔
+    REPLAY_SPEED_MULTIPLIER,  // 按原始时间间隔的 N 倍速
+} replay_speed_mode_t;
+
+/**
+ * 文件读取方式
+ */
+typedef enum {
+    REPLAY_READER_LIBPCAP,    // 通过 pcap_next_ex 逐条读取
+    REPLAY_READER_MMAP,       // 映射整个文件，数据包直接指向映射内存
+    REPLAY_READER_IO_URING,   // 通过 io_uring 预读大块数据并流式解析
+} replay_reader_t;
+
+/**
+ * 文件重放后端特定配置
+ *
+ * first_packet/packet_count 仅对 REPLAY_READER_MMAP 有效，
+ * 可让多个后端实例按区间并行重放同一个文件。
+ */
+typedef struct {
+    const char* path;            // pcap/pcapng 文件路径
+    const char* filter;          // BPF 过滤器
+    replay_speed_mode_t mode;    // 速度模式
+    double speed;                // 倍速（仅 REPLAY_SPEED_MULTIPLIER 使用）
+    uint32_t loops;              // 重放次数，0 表示 1 次
+    replay_reader_t reader;      // 文件读取方式
+    uint64_t first_packet;       // 起始数据包索引
+    uint64_t packet_count;       // 重放的数据包数，0 表示到文件末尾
+    pcap_uring_config_t uring;   // io_uring 读取器配置（仅 REPLAY_READER_IO_URING 使用）
+} replay_backend_config_t;
+
+/**
+ * 创建文件重放后端
+ *
+ * 通过 pcap_open_offline、内存映射或 io_uring 读取抓包文件，并按与实时抓包相同的
+ * packet_callback_t 路径交付数据包。文件读完后 start 返回。
+ *
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* replay_backend_create(
+    const replay_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁文件重放后端
+ * @param backend 后端结构
+ */
+void replay_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REPLAY_BACKEND_H
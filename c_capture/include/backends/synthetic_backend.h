@@ -0,0 +1,86 @@
+#ifndef SYNTHETIC_BACKEND_H
+#define SYNTHETIC_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 合成流量生成器默认参数
+ */
+#define SYNTHETIC_DEFAULT_FLOW_COUNT    1024   // 并发流数
+#define SYNTHETIC_DEFAULT_FLOW_PACKETS  64     // 每条流的平均数据包数
+#define SYNTHETIC_DEFAULT_MIN_PAYLOAD   64     // 最小负载长度
+#define SYNTHETIC_DEFAULT_MAX_PAYLOAD   1400   // 最大负载长度
+#define SYNTHETIC_DEFAULT_MTU           1500   // 链路 MTU
+#define SYNTHETIC_DEFAULT_SEED          1      // 默认随机种子
+#define SYNTHETIC_MIN_MTU               576    // 最小 MTU
+#define SYNTHETIC_MAX_MTU               9216   // 最大 MTU
+#define SYNTHETIC_MAX_PAYLOAD           65000  // 单个数据报的最大负载长度
+
+/**
+ * 负载长度分布
+ */
+typedef enum {
+    SYNTHETIC_SIZE_FIXED,     // 固定为 min_payload
+    SYNTHETIC_SIZE_UNIFORM,   // 在 [min_payload, max_payload] 中均匀分布
+    SYNTHETIC_SIZE_IMIX,      // 简单 IMIX：18/528/1472 字节按 7:4:1 混合
+} synthetic_size_mode_t;
+
+/**
+ * 合成流量后端特定配置
+ *
+ * 比例参数取值范围为 [0, 1]；数值参数为 0 时使用默认值。
+ * 相同的配置与种子总是生成完全相同的数据包序列。
+ */
+typedef struct {
+    const char* filter;               // BPF 过滤器（在用户态执行）
+    uint64_t rate_pps;                // 目标速率（包每秒），0 表示不限速
+    uint64_t packet_count;            // 生成的数据包数，0 表示直到停止
+    uint32_t flow_count;              // 并发流数
+    uint32_t flow_packets;            // 每条流的平均数据包数，流结束后以新端口重建
+    double ipv6_ratio;                // IPv6 流的比例
+    double tcp_ratio;                 // TCP 流的比例，其余为 UDP
+    double fragment_ratio;            // 未超过 MTU 的数据报被主动分片的比例
+    double reorder_ratio;             // 帧被推迟到下一帧之后交付的比例
+    double tcp_gap_ratio;             // TCP 段被跳过（只推进序列号）的比例
+    synthetic_size_mode_t size_mode;  // 负载长度分布
+    uint32_t min_payload;             // 最小负载长度
+    uint32_t max_payload;             // 最大负载长度
+    uint32_t mtu;                     // 链路 MTU，超过 MTU 的数据报总会被分片
+    uint64_t seed;                    // 随机种子
+} synthetic_backend_config_t;
+
+/**
+ * 创建合成流量后端
+ *
+ * 在内存中生成以太网帧（IPv4/IPv6、TCP/UDP、IP 分片、乱序、TCP 空洞），
+ * 通过与实时抓包相同的 packet_callback_t 路径交付，不需要网卡和 root 权限。
+ * TCP 负载按流偏移填充，重组后的字节流可直接校验；L4 校验和不计算（置 0）。
+ * 生成完 packet_count 个数据包后 start 返回。
+ *
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* synthetic_backend_create(
+    const synthetic_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁合成流量后端
+ * @param backend 后端结构
+ */
+void synthetic_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYNTHETIC_BACKEND_H
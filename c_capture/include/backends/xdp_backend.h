@@ -0,0 +1,82 @@
+#ifndef XDP_BACKEND_H
+#define XDP_BACKEND_H
+
+#include "capture_types.h"
+#include "capture_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * AF_XDP 后端默认参数
+ */
+#define XDP_DEFAULT_FRAME_SIZE   2048   // UMEM 帧大小
+#define XDP_DEFAULT_FRAME_COUNT  4096   // UMEM 帧数量
+#define XDP_DEFAULT_RING_SIZE    2048   // RX/填充/完成环大小
+#define XDP_DEFAULT_BATCH_SIZE   64     // 单次从 RX 环取出的最大描述符数
+
+/**
+ * XDP 程序挂载模式
+ */
+typedef enum {
+    XDP_ATTACH_AUTO,      // 由内核选择（优先驱动模式）
+    XDP_ATTACH_GENERIC,   // 通用模式（SKB 模式），任何网卡（含 veth）可用
+    XDP_ATTACH_NATIVE,    // 驱动模式
+} xdp_attach_mode_t;
+
+/**
+ * AF_XDP 套接字绑定模式
+ */
+typedef enum {
+    XDP_BIND_AUTO,        // 由内核选择
+    XDP_BIND_COPY,        // 拷贝模式
+    XDP_BIND_ZEROCOPY,    // 零拷贝模式（需要驱动支持）
+} xdp_bind_mode_t;
+
+/**
+ * AF_XDP 后端特定配置
+ *
+ * 数值参数为 0 时使用默认值，帧大小和各环大小必须为 2 的幂。
+ */
+typedef struct {
+    const char* device;            // 设备名称
+    uint32_t queue_id;             // 绑定的接收队列
+    uint32_t frame_size;           // UMEM 帧大小
+    uint32_t frame_count;          // UMEM 帧数量
+    uint32_t ring_size;            // RX/填充/完成环大小
+    uint32_t batch_size;           // 单次处理的最大描述符数
+    xdp_attach_mode_t attach_mode; // XDP 程序挂载模式
+    xdp_bind_mode_t bind_mode;     // 套接字绑定模式
+    int timeout_ms;                // RX 环为空时的等待时间
+} xdp_backend_config_t;
+
+/**
+ * 创建 AF_XDP 后端
+ *
+ * 分配 UMEM 并注册到 AF_XDP 套接字，在网卡上挂载一个把指定队列重定向到
+ * 该套接字的 XDP 程序。回调中的 packet_t.data 直接指向 UMEM 帧，
+ * 回调返回后帧被回收到填充环。
+ *
+ * @param config 配置信息
+ * @param error_cb 错误回调函数
+ * @param error_user_data 错误回调用户数据
+ * @return 成功返回后端结构，失败返回 NULL
+ */
+capture_backend_t* xdp_backend_create(
+    const xdp_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+);
+
+/**
+ * 销毁 AF_XDP 后端
+ * @param backend 后端结构
+ */
+void xdp_backend_destroy(capture_backend_t* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // XDP_BACKEND_H
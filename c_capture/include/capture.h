@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "capture_types.h"
+#include "packet_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,21 +18,52 @@ typedef enum {
     CAPTURE_BACKEND_PFRING,  // PF_RING 后端
     CAPTURE_BACKEND_DPDK,    // DPDK 后端
     CAPTURE_BACKEND_EBPF,    // eBPF 后端
+    CAPTURE_BACKEND_AF_PACKET, // AF_PACKET TPACKET_V3 后端
+    CAPTURE_BACKEND_REPLAY,  // 离线文件重放后端
+    CAPTURE_BACKEND_RAW_SOCKET, // AF_PACKET 原始套接字 recvmmsg 后端
+    CAPTURE_BACKEND_SYNTHETIC, // 内存合成流量生成后端
 } capture_backend_type_t;
 
+/**
+ * 线程与内存放置
+ *
+ * 接收线程按序号编号：单设备时 0 号是运行 capture_start 的线程，其余为
+ * 扇出套接字的接收线程；多设备时第 i 个设备的接收线程从 i * 扇出数开始
+ * 编号。第 n 个接收线程绑定到 rx_cpus[n % rx_cpu_count]，工作线程同理。
+ * 环形缓冲区、队列和 UMEM 分配在使用它的线程所绑定 CPU 的 NUMA 节点上。
+ * 没有 CPU 列表时，numa_nodes 把线程限制在这些节点的 CPU 上，内存放在
+ * 其中编号最小的节点；全部为空时保持原来的行为。
+ */
+typedef struct {
+    const uint32_t* rx_cpus;      // 接收线程绑定的 CPU 列表
+    uint32_t rx_cpu_count;        // rx_cpus 中的 CPU 数
+    const uint32_t* worker_cpus;  // 按流分发工作线程绑定的 CPU 列表，为空时依次使用允许的 CPU
+    uint32_t worker_cpu_count;    // worker_cpus 中的 CPU 数
+    uint64_t numa_nodes;          // 未指定 CPU 列表时线程与内存所在的 NUMA 节点（位掩码）
+} capture_placement_t;
+
 /**
  * 抓包配置结构
  */
 typedef struct {
-    const char* device;           // 网络接口名称
+    const char* device;           // 网络接口名称（重放后端为文件路径）
+    const char* const* devices;   // 多设备抓包的设备列表，非空时忽略 device
+    uint32_t device_count;        // devices 中的设备数量
+    uint32_t merge_window_us;     // 多设备按时间戳归并的等待窗口（微秒），0 表示默认
     const char* filter;           // BPF 过滤器
     int snaplen;                  // 抓包长度
     int timeout_ms;               // 超时时间（毫秒）
     bool promiscuous;             // 是否开启混杂模式
     bool immediate;               // 是否立即返回
     uint32_t buffer_size;         // 缓冲区大小
+    uint32_t fanout_count;        // 扇出套接字/接收线程数，0 表示使用后端配置
+    uint32_t worker_count;        // 按流分发的工作线程数，大于 1 时在工作线程上调用回调
+    bool background;              // capture_start 在句柄自有的接收线程上运行并立即返回
+    capture_overload_t overload;  // 下游处理不过来时用户态队列的过载策略
     capture_backend_type_t type;  // 后端类型
     void* backend_config;         // 后端特定配置
+    packet_pool_t* lease_pool;    // 租用拷贝使用的缓冲池，NULL 表示使用 malloc
+    capture_placement_t placement; // 线程与内存放置
 } capture_config_t;
 
 /**
@@ -47,6 +79,24 @@ typedef struct capture_handle capture_handle_t;
  */
 typedef bool (*packet_callback_t)(const packet_t* packet, void* user_data);
 
+/**
+ * 批量数据包回调函数类型
+ *
+ * packets 及其指向的数据只在回调期间有效。
+ *
+ * @param packets 数据包数组
+ * @param count 数据包数量，至少为 1
+ * @param user_data 用户数据
+ * @return 返回 true 继续抓包，false 停止抓包
+ */
+typedef bool (*packet_batch_callback_t)(const packet_t* packets, uint32_t count, void* user_data);
+
+/**
+ * 批量回调默认与最大突发大小
+ */
+#define CAPTURE_DEFAULT_BURST_SIZE 64
+#define CAPTURE_MAX_BURST_SIZE     1024
+
 /**
  * 错误回调函数类型
  * @param error 错误信息
@@ -56,6 +106,20 @@ typedef void (*error_callback_t)(const char* error, void* user_data);
 
 /**
  * 初始化抓包系统
+ *
+ * device_count 大于 1 时，为每个设备各创建一个同类型后端，由一个句柄统一
+ * 管理；各设备的数据包按时间戳归并后交付，packet_t.device_index 为设备在
+ * devices 中的序号。
+ *
+ * worker_count 大于 1 时，接收线程按对称五元组哈希把数据包分发给
+ * worker_count 个绑定 CPU 的工作线程，回调在工作线程上并发执行；同一条流
+ * 两个方向的数据包总在同一个工作线程上，可用 capture_worker_id 区分。
+ *
+ * 指定 overload 策略时即使只有一个工作线程也会在接收线程之后加一级队列，
+ * 回调处理不过来时按策略丢弃新数据包、丢弃积压的旧数据包、按 1/N 采样或
+ * 让接收线程等待，并在 capture_stats_t 的 overload_* 中分别计数，而不是
+ * 让内核缓冲区静默溢出。多设备时各设备的归并队列使用同一策略。
+ *
  * @param config 配置信息
  * @param error_cb 错误回调函数
  * @param error_user_data 错误回调用户数据
@@ -69,6 +133,11 @@ capture_handle_t* capture_init(
 
 /**
  * 开始抓包
+ *
+ * 默认在调用线程上运行接收循环，直到 capture_stop、回调返回 false 或数据
+ * 源结束才返回。配置了 background 时创建句柄自有的接收线程（单设备时按
+ * 0 号接收线程绑定）后立即返回，由 capture_stop 停止并 join 该线程。
+ *
  * @param handle 抓包句柄
  * @param packet_cb 数据包回调函数
  * @param user_data 用户数据
@@ -80,8 +149,68 @@ int capture_start(
     void* user_data
 );
 
+/**
+ * 以批量回调方式开始抓包
+ *
+ * 每次回调交付最多 burst_size 个数据包。支持批量交付的后端在其自然批次
+ * （内核块、recvmmsg、rx burst 等）内攒批，批次边界处即使未满也会交付，
+ * 因此不会引入额外延迟；其余后端每次回调交付一个数据包。线程模型与
+ * capture_start 相同。
+ *
+ * @param handle 抓包句柄
+ * @param batch_cb 批量数据包回调函数
+ * @param burst_size 每次回调的最大数据包数，0 表示默认值
+ * @param user_data 用户数据
+ * @return 成功返回 0，失败返回错误码
+ */
+int capture_start_batch(
+    capture_handle_t* handle,
+    packet_batch_callback_t batch_cb,
+    uint32_t burst_size,
+    void* user_data
+);
+
+/**
+ * 以拉取方式获取一批数据包
+ *
+ * 与 capture_start 互斥：由调用者的事件循环决定何时取包，不需要专门的
+ * 阻塞线程。返回的数据包及其数据在下一次调用 capture_next_batch 之前有效，
+ * 底层缓冲区（内核块、XDP 帧等）在下一次调用时才归还，调用者取包的快慢
+ * 直接形成反压。capture_stop 可从其他线程打断正在等待的调用。
+ *
+ * @param handle 抓包句柄
+ * @param packets 接收数据包描述的数组
+ * @param max 数组容量
+ * @param timeout_ms 没有数据包时的最长等待时间，0 表示不等待，-1 表示一直等待
+ * @return 成功返回数据包数量（超时或被打断时为 0），数据源结束返回
+ *         -CAPTURE_ERROR_EOF，失败返回负的错误码
+ */
+int capture_next_batch(
+    capture_handle_t* handle,
+    packet_t* packets,
+    uint32_t max,
+    int timeout_ms
+);
+
+/**
+ * 获取可加入 poll/epoll 的文件描述符
+ *
+ * 描述符可读时调用 capture_next_batch 很可能取到数据包；可读只是提示，
+ * 调用者仍需处理返回 0 的情况。描述符归句柄所有，不能关闭。
+ *
+ * @param handle 抓包句柄
+ * @return 成功返回文件描述符，后端不支持时返回 -1
+ */
+int capture_get_fd(capture_handle_t* handle);
+
 /**
  * 停止抓包
+ *
+ * 可在其他线程调用。使用自有接收线程时等待其退出后返回，返回后不会再有
+ * 回调；接收线程中启动失败时返回对应的错误码。在调用线程上运行时只通知
+ * 接收循环退出，capture_start 随后返回。拉取模式下打断正在等待的
+ * capture_next_batch，并让下一次调用立即返回 0。
+ *
  * @param handle 抓包句柄
  * @return 成功返回 0，失败返回错误码
  */
@@ -109,14 +238,67 @@ int capture_resume(capture_handle_t* handle);
  */
 int capture_get_stats(capture_handle_t* handle, capture_stats_t* stats);
 
+/**
+ * 获取各线程的统计信息
+ *
+ * 依次为接收线程、归并线程（多设备）和工作线程（按流分发），计数由各线程
+ * 独占写入，读取时不加锁，各项之间不保证是同一时刻的快照。
+ * @param handle 抓包句柄
+ * @param stats 线程统计数组
+ * @param max stats 的容量
+ * @return 成功返回线程数（可能大于 max，只填写前 max 项），失败返回负的错误码
+ */
+int capture_get_thread_stats(capture_handle_t* handle, capture_thread_stats_t* stats, uint32_t max);
+
 /**
  * 设置过滤器
+ *
+ * 抓包过程中也可以调用：后端在原有套接字或句柄上更换过滤器，不重新打开
+ * 设备，也不重建环形缓冲区。扇出组与多设备的各成员逐个更换，失败时恢复为
+ * 原来的过滤器；分发工作线程不受影响。已进入缓冲区的数据包按原过滤器交付。
  * @param handle 抓包句柄
  * @param filter BPF 过滤器
  * @return 成功返回 0，失败返回错误码
  */
 int capture_set_filter(capture_handle_t* handle, const char* filter);
 
+/**
+ * 租用数据包
+ *
+ * 只能在数据包回调期间，或拉取模式下下一次 capture_next_batch 之前，对刚
+ * 交付的数据包调用。packet 应是调用者自己的 packet_t 副本；成功后
+ * packet->data 在 capture_release 之前一直有效，可以跨线程排队处理，省去
+ * 拷贝负载。支持零拷贝的后端在租用期间不复用对应的缓冲区（内核块、XDP
+ * 帧、mbuf），长期持有会耗尽缓冲区并导致丢包；其余后端拷贝数据包内容，
+ * 并在 packet->flags 中设置 PACKET_FLAG_LEASE_COPY。配置了 lease_pool 时
+ * 副本从该缓冲池分配。
+ *
+ * @param handle 抓包句柄
+ * @param packet 要租用的数据包，data 与 flags 可能被修改
+ * @return 成功返回 0，失败返回错误码
+ */
+int capture_lease(capture_handle_t* handle, packet_t* packet);
+
+/**
+ * 归还租用的数据包
+ *
+ * 可在任意线程调用，但必须在 capture_cleanup 之前。每次成功的
+ * capture_lease 对应一次 capture_release。
+ *
+ * @param handle 抓包句柄
+ * @param packet capture_lease 修改后的数据包
+ */
+void capture_release(capture_handle_t* handle, const packet_t* packet);
+
+/**
+ * 获取当前线程的工作线程序号
+ *
+ * 在按流分发的回调中调用，可用于选择按工作线程划分的重组状态。
+ *
+ * @return 在工作线程上返回序号（从 0 开始），否则返回 -1
+ */
+int capture_worker_id(void);
+
 /**
  * 获取支持的设备列表
  * @param devices 设备列表
@@ -14,11 +14,41 @@ typedef struct {
     struct timespec ts;      // 时间戳
     uint32_t if_index;       // 接口索引
     uint32_t flags;          // 标志位
-    uint32_t protocol;       // 协议类型
-    uint32_t vlan_tci;       // VLAN 标签
-    uint32_t hash;           // 数据包哈希值
+    uint32_t protocol;       // 最内层网络层协议（EtherType），未识别时为 0
+    uint32_t vlan_tci;       // 最外层 VLAN 标签
+    uint32_t hash;           // 最内层对称五元组哈希，同一条流两个方向相同
+    uint16_t l3_offset;      // 最内层网络层头部在 data 中的偏移
+    uint16_t l4_offset;      // 最内层传输层头部在 data 中的偏移，没有时为 0
+    uint8_t l4_proto;        // 最内层传输层协议号，IPv6 为跳过扩展头后的上层协议
+    uint8_t device_index;    // 多设备句柄中设备在 devices 中的序号，单设备时为 0
+    uint16_t frag_hdr_offset; // 最内层 IPv6 分片扩展头在 data 中的偏移，没有时为 0（IPv4 分片字段在网络层头部中）
+    uint32_t encap;          // 剥离的封装层栈，每层 4 位，最外层在最低位，没有封装时为 0
 } packet_t;
 
+/**
+ * 数据包标志位定义
+ */
+#define PACKET_FLAG_DECODED    0x00000001  // 已解码，protocol、偏移与 hash 有效
+#define PACKET_FLAG_FRAGMENT   0x00000002  // IP 分片
+#define PACKET_FLAG_LEASE_COPY 0x80000000  // 数据包内容是租用时拷贝的副本
+
+/**
+ * 封装层类型，按从外到内的顺序记录在 packet_t.encap 中
+ */
+#define PACKET_ENCAP_NONE      0           // 栈结束
+#define PACKET_ENCAP_VLAN      1           // 802.1Q 标签
+#define PACKET_ENCAP_QINQ      2           // 802.1ad 外层标签
+#define PACKET_ENCAP_MPLS      3           // MPLS 标签栈（整个栈记为一层）
+#define PACKET_ENCAP_IPV4      4           // 外层 IPv4 头部
+#define PACKET_ENCAP_IPV6      5           // 外层 IPv6 头部
+#define PACKET_ENCAP_GRE       6           // GRE
+#define PACKET_ENCAP_VXLAN     7           // UDP + VXLAN
+#define PACKET_ENCAP_GENEVE    8           // UDP + GENEVE
+#define PACKET_ENCAP_MAX       8           // 最多记录的层数
+
+// 取第 index 层（0 为最外层）的封装类型
+#define PACKET_ENCAP_LAYER(encap, index) (((encap) >> ((index) * 4)) & 0xfu)
+
 /**
  * 设备信息结构
  */
@@ -35,8 +65,38 @@ typedef struct {
     uint32_t broadcast;      // 广播地址
 } capture_device_t;
 
+/**
+ * 用户态队列的过载策略
+ *
+ * 作用于接收线程与下游之间的队列（按流分发队列、多设备归并队列），
+ * 决定下游处理不过来、队列写满时如何处理。
+ */
+typedef enum {
+    CAPTURE_OVERLOAD_NONE = 0,     // 未指定：不为此单独排队，已有的队列丢弃新数据包
+    CAPTURE_OVERLOAD_DROP_NEWEST,  // 丢弃新到的数据包
+    CAPTURE_OVERLOAD_DROP_OLDEST,  // 丢弃队列中积压的旧数据包，保留新数据包
+    CAPTURE_OVERLOAD_SAMPLE,       // 队列超过一半时每 sample_rate 个数据包只保留 1 个
+    CAPTURE_OVERLOAD_BLOCK,        // 接收线程等待队列腾出空间，压力传回内核缓冲区
+} capture_overload_policy_t;
+
+#define CAPTURE_OVERLOAD_DEFAULT_SAMPLE_RATE 8  // 默认采样率（1/N）
+
+/**
+ * 过载策略配置
+ */
+typedef struct {
+    capture_overload_policy_t policy; // 过载策略
+    uint32_t sample_rate;             // SAMPLE 策略的 N，0 表示默认值
+} capture_overload_t;
+
+#define CAPTURE_BATCH_HIST_BUCKETS 8  // 批大小直方图的桶数
+
 /**
  * 统计信息结构
+ *
+ * overload_* 为用户态队列按过载策略处理的计数，其中丢弃的数据包同时
+ * 计入 packets_dropped。batch_size_hist[i] 为大小在 [2^i, 2^(i+1)) 内的
+ * 批数，最后一个桶包含所有更大的批；单包回调不计批数。
  */
 typedef struct {
     uint64_t packets_received;    // 接收的数据包数
@@ -45,8 +105,45 @@ typedef struct {
     uint64_t bytes_received;      // 接收的字节数
     struct timespec start_time;   // 开始时间
     struct timespec end_time;     // 结束时间
+    uint64_t overload_dropped_newest; // 队列满时丢弃的新数据包数
+    uint64_t overload_dropped_oldest; // 为新数据包让位而丢弃的积压数据包数
+    uint64_t overload_sampled_out;    // 过载采样时未保留的数据包数
+    uint64_t overload_blocked;        // 接收线程因队列满而等待的次数
+    uint64_t overload_blocked_ns;     // 接收线程等待的总时间（纳秒）
+    uint64_t batches_delivered;       // 批量回调（或拉取）交付的批数
+    uint64_t batch_size_hist[CAPTURE_BATCH_HIST_BUCKETS]; // 批大小直方图
 } capture_stats_t;
 
+/**
+ * 线程角色
+ */
+typedef enum {
+    CAPTURE_THREAD_RECEIVE = 0,    // 接收线程
+    CAPTURE_THREAD_MERGE,          // 多设备归并线程
+    CAPTURE_THREAD_WORKER,         // 按流分发工作线程
+} capture_thread_role_t;
+
+/**
+ * 单个线程的统计信息
+ *
+ * packets/bytes/batches 为该线程交给下一级（用户回调、归并队列或分发
+ * 队列）的数量；dropped_*、sampled_out 与 blocked* 为该线程向下一级队列
+ * 写入时按过载策略处理的计数。两次读取的差值除以时间间隔即为该级的速率。
+ */
+typedef struct {
+    capture_thread_role_t role;    // 线程角色
+    uint32_t index;                // 同一角色内的序号（接收线程与线程放置的编号一致）
+    uint64_t packets;              // 交付的数据包数
+    uint64_t bytes;                // 交付的字节数
+    uint64_t batches;              // 交付的批数
+    uint64_t batch_size_hist[CAPTURE_BATCH_HIST_BUCKETS]; // 批大小直方图
+    uint64_t dropped_newest;       // 队列满时丢弃的新数据包数
+    uint64_t dropped_oldest;       // 为新数据包让位而丢弃的积压数据包数
+    uint64_t sampled_out;          // 过载采样时未保留的数据包数
+    uint64_t blocked;              // 因队列满而等待的次数
+    uint64_t blocked_ns;           // 等待的总时间（纳秒）
+} capture_thread_stats_t;
+
 /**
  * 错误码定义
  */
@@ -67,6 +164,7 @@ typedef enum {
     CAPTURE_ERROR_MEMORY,          // 内存错误
     CAPTURE_ERROR_TIMEOUT,         // 超时错误
     CAPTURE_ERROR_INTERNAL,        // 内部错误
+    CAPTURE_ERROR_EOF,             // 数据源已结束（如离线重放完毕）
 } capture_error_t;
 
 /**
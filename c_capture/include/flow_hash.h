@@ -0,0 +1,44 @@
+#ifndef FLOW_HASH_H
+#define FLOW_HASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 计算对称流哈希
+ *
+ * 两个端点（地址与端口）按固定顺序排列后做 CRC32C，交换源和目的结果
+ * 不变，同一条流两个方向的数据包得到相同的哈希。x86 上 CPU 支持 SSE4.2
+ * 时使用 crc32 指令，ARMv8 编译时启用 CRC 扩展时使用 crc32c 指令，
+ * 否则查表计算，三种方式结果相同。
+ *
+ * 解码器用它填写 packet_t.hash；按流分发、流表、分片重组表等需要
+ * 同一个哈希的地方应直接使用 packet_t.hash，或用相同参数调用本函数。
+ * IP 分片与没有端口的协议传入端口 0、协议 0，只按地址对哈希。
+ *
+ * @param src 源地址（网络字节序）
+ * @param dst 目的地址（网络字节序）
+ * @param addr_len 地址长度，4（IPv4）或 16（IPv6）
+ * @param sport 源端口
+ * @param dport 目的端口
+ * @param proto 传输层协议号
+ * @return 哈希值
+ */
+uint32_t flow_hash(const uint8_t* src, const uint8_t* dst, uint32_t addr_len,
+                   uint16_t sport, uint16_t dport, uint8_t proto);
+
+/**
+ * 检查流哈希是否使用硬件 CRC32C 指令
+ * @return 使用硬件指令返回 true，查表计算返回 false
+ */
+bool flow_hash_accelerated(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLOW_HASH_H
@@ -0,0 +1,63 @@
+#ifndef PACKET_BATCH_H
+#define PACKET_BATCH_H
+
+#include <stdint.h>
+#include "capture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 批量元数据最多容纳的数据包数，与最大突发大小相同
+ */
+#define PACKET_BATCH_MAX CAPTURE_MAX_BURST_SIZE
+
+/**
+ * 按列存放的一批数据包头部信息
+ *
+ * 第 i 行对应批中第 i 个数据包，每列 64 字节对齐。地址与端口取自最内层
+ * 网络层头部：地址统一为 16 字节，IPv6 原样存放，IPv4 存为 IPv4 映射地址
+ * （::ffff:a.b.c.d），非 IP 或头部不完整时为全 0；端口只在有完整传输层
+ * 头部且不是分片时填写。
+ *
+ * 隧道内层头部被截断时 hash 退回按最后一个完整的外层 IP 头部计算，此时
+ * 地址与端口列仍对应（不完整的）内层，不能用来复现 hash；按列比较流键前
+ * 应先按 hash 分桶，并把地址全 0 的行单独处理。
+ *
+ * 结构体约 51 KiB，应放在堆上或静态存储中并在各批之间复用。
+ */
+typedef struct {
+    uint32_t count;                                       // 有效行数
+    _Alignas(64) uint32_t hash[PACKET_BATCH_MAX];         // 对称流哈希
+    _Alignas(64) uint32_t flags[PACKET_BATCH_MAX];        // 数据包标志位
+    _Alignas(64) uint16_t ethertype[PACKET_BATCH_MAX];    // 最内层网络层协议
+    _Alignas(64) uint16_t l3_offset[PACKET_BATCH_MAX];    // 最内层网络层头部偏移
+    _Alignas(64) uint16_t l4_offset[PACKET_BATCH_MAX];    // 最内层传输层头部偏移，没有时为 0
+    _Alignas(64) uint16_t sport[PACKET_BATCH_MAX];        // 源端口
+    _Alignas(64) uint16_t dport[PACKET_BATCH_MAX];        // 目的端口
+    _Alignas(64) uint8_t l4_proto[PACKET_BATCH_MAX];      // 传输层协议号
+    _Alignas(64) uint8_t src[PACKET_BATCH_MAX][16];       // 源地址
+    _Alignas(64) uint8_t dst[PACKET_BATCH_MAX][16];       // 目的地址
+} packet_batch_meta_t;
+
+/**
+ * 把一批数据包的头部信息按列填入批量元数据
+ *
+ * 在批量回调或 capture_next_batch 之后调用。数据包已由后端解码时直接
+ * 取用解码结果，否则按以太网解码一份副本。先收集各行的解码结果并预取
+ * 后续数据包的网络层头部，再一遍取出地址与端口；之后的流表查找可先
+ * 遍历 hash 列预取全部桶，再逐行比较键。
+ *
+ * @param meta 批量元数据
+ * @param packets 数据包数组
+ * @param count 数据包数量，超过 PACKET_BATCH_MAX 的部分被忽略
+ * @return 填写的行数
+ */
+uint32_t packet_batch_parse(packet_batch_meta_t* meta, const packet_t* packets, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PACKET_BATCH_H
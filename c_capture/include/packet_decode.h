@@ -0,0 +1,57 @@
+#ifndef PACKET_DECODE_H
+#define PACKET_DECODE_H
+
+#include <stdint.h>
+#include "capture_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 链路类型，取值与 pcap 文件的 LINKTYPE_* 相同
+ */
+#define PACKET_LINKTYPE_ETHERNET  1      // 以太网
+#define PACKET_LINKTYPE_DLT_RAW   12     // 原始 IP（部分平台上 libpcap 的 DLT_RAW）
+#define PACKET_LINKTYPE_RAW       101    // 原始 IP，没有链路层头部
+#define PACKET_LINKTYPE_LINUX_SLL 113    // Linux cooked capture
+#define PACKET_LINKTYPE_IPV4      228    // 原始 IPv4
+#define PACKET_LINKTYPE_IPV6      229    // 原始 IPv6
+#define PACKET_LINKTYPE_UNKNOWN   0xffffffffu // 未知链路类型，只标记为已解码
+
+/**
+ * 解码数据包的链路层、网络层与传输层头部
+ *
+ * 依次剥离 802.1Q/802.1ad 标签、MPLS 标签栈、GRE（版本 0）、VXLAN（UDP 4789）、
+ * GENEVE（UDP 6081）与 IP-in-IP/IPv6-in-IP 封装，剥离的各层按从外到内的顺序
+ * 记录在 encap 中，最多 PACKET_ENCAP_MAX 层，超出时停在当前层。
+ * 填写最内层的 protocol（网络层 EtherType）、l3_offset、l4_offset、l4_proto 与
+ * hash（flow_hash 计算的对称五元组哈希），设置 PACKET_FLAG_DECODED，使按流
+ * 分发与分片重组都以内层流为准；外层 IP 分片无法剥离，按外层处理。
+ * 帧内带标签且后端未给出 vlan_tci 时填写最外层标签。
+ * 识别不了的部分保持为 0：非 IP 数据包只有 protocol 与 l3_offset，
+ * 截断或非首片的 IP 分片没有 l4_offset，没有端口时哈希只覆盖地址对，
+ * 内层 IP 头部不完整时哈希退回最后一层完整的 IP 头部。
+ * IPv6 一次遍历最多 8 个扩展头（逐跳选项、路由、目的选项、分片、AH），
+ * l4_proto 为上层协议，找到分片扩展头时填写 frag_hdr_offset；扩展头截断或
+ * 过多时没有 l4_offset，l4_proto 为停下处的 Next Header。
+ *
+ * 只读取 data 的前 caplen 字节，不会越界。
+ *
+ * @param pkt 数据包
+ * @param linktype 链路类型
+ */
+void packet_decode(packet_t* pkt, uint32_t linktype);
+
+/**
+ * 把 Linux 接口硬件类型（ARPHRD_*）换算为链路类型
+ * @param hatype 硬件类型，如 sockaddr_ll.sll_hatype
+ * @return 链路类型，不支持时返回 PACKET_LINKTYPE_UNKNOWN
+ */
+uint32_t packet_linktype_arphrd(uint16_t hatype);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PACKET_DECODE_H
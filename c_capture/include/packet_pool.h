@@ -0,0 +1,124 @@
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 缓冲池参数
+ *
+ * 对象按 2 的幂分为 64 字节到 64 KiB 共 11 个尺寸类，从 1 MiB 对齐的
+ * slab 中切分；更大的请求直接向系统申请。
+ */
+#define PACKET_POOL_MIN_SIZE            64          // 最小尺寸类
+#define PACKET_POOL_MAX_SIZE            (64u << 10) // 最大尺寸类
+#define PACKET_POOL_CLASS_COUNT         11          // 尺寸类数量
+#define PACKET_POOL_SLAB_SIZE           (1u << 20)  // slab 大小（同时也是对齐）
+#define PACKET_POOL_DEFAULT_CACHE_COUNT 64          // 每线程每个尺寸类默认缓存的对象数
+#define PACKET_POOL_DEFAULT_CACHE_BYTES (256u << 10) // 每线程每个尺寸类默认缓存的字节数
+#define PACKET_POOL_MAX_NODES           64          // 支持的最大 NUMA 节点数
+
+/**
+ * 缓冲池配置
+ *
+ * 参数为 0 时使用默认值。每个尺寸类的线程缓存上限取 cache_count 与
+ * cache_bytes / 对象大小 中的较小者（至少为 2），缓存空或满时与全局
+ * 仓库成批交换一半。
+ */
+typedef struct {
+    uint32_t cache_count;   // 每线程每个尺寸类最多缓存的对象数
+    uint32_t cache_bytes;   // 每线程每个尺寸类最多缓存的字节数
+    size_t max_bytes;       // 向系统申请的内存上限，0 表示不限制
+} packet_pool_config_t;
+
+/**
+ * 缓冲池统计信息
+ */
+typedef struct {
+    uint64_t bytes_reserved;    // 当前向系统申请的字节数（slab 与大对象）
+    uint64_t slab_count;        // 当前 slab 数
+    uint64_t large_count;       // 当前未释放的大对象数
+    uint64_t depot_refills;     // 线程缓存从仓库补充的次数
+    uint64_t depot_flushes;     // 线程缓存归还仓库的次数
+    uint64_t alloc_failures;    // 分配失败次数（内存不足或超过 max_bytes）
+} packet_pool_stats_t;
+
+/**
+ * 缓冲池
+ */
+typedef struct packet_pool packet_pool_t;
+
+/**
+ * 创建缓冲池
+ *
+ * 每个线程第一次分配时建立自己的缓存，线程退出时缓存自动归还仓库。
+ * 仓库按 NUMA 节点划分，线程从其所在节点的仓库补充，新 slab 的页面
+ * 优先放在该节点上；释放其他节点的对象时直接归还对象所属节点的仓库。
+ *
+ * @param config 配置信息，可为 NULL
+ * @return 成功返回缓冲池，失败返回 NULL
+ */
+packet_pool_t* packet_pool_create(const packet_pool_config_t* config);
+
+/**
+ * 销毁缓冲池
+ *
+ * 释放全部内存，包括尚未归还的对象。调用前所有线程都应停止使用该缓冲池。
+ *
+ * @param pool 缓冲池
+ */
+void packet_pool_destroy(packet_pool_t* pool);
+
+/**
+ * 分配缓冲区
+ *
+ * 返回的地址至少按 64 字节对齐。可在任意线程调用。
+ *
+ * @param pool 缓冲池
+ * @param size 请求的字节数
+ * @return 成功返回缓冲区，失败返回 NULL
+ */
+void* packet_pool_alloc(packet_pool_t* pool, size_t size);
+
+/**
+ * 释放缓冲区
+ *
+ * 可在与分配不同的线程调用。ptr 为 NULL 时什么也不做。
+ *
+ * @param pool 缓冲池
+ * @param ptr packet_pool_alloc 返回的缓冲区
+ */
+void packet_pool_free(packet_pool_t* pool, void* ptr);
+
+/**
+ * 获取缓冲区的实际可用大小
+ * @param ptr packet_pool_alloc 返回的缓冲区
+ * @return 可用字节数，不小于分配时请求的大小
+ */
+size_t packet_pool_usable_size(const void* ptr);
+
+/**
+ * 将当前线程的缓存全部归还仓库
+ *
+ * 长时间空闲的线程可调用该函数让其他线程复用缓存的对象。
+ *
+ * @param pool 缓冲池
+ */
+void packet_pool_thread_flush(packet_pool_t* pool);
+
+/**
+ * 获取统计信息
+ * @param pool 缓冲池
+ * @param stats 统计信息结构
+ */
+void packet_pool_get_stats(packet_pool_t* pool, packet_pool_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PACKET_POOL_H
@@ -0,0 +1,203 @@
+#ifndef PCAP_FILE_H
+#define PCAP_FILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "capture_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 抓包文件格式
+ */
+typedef enum {
+    PCAP_FILE_FORMAT_PCAP,      // 经典 pcap（微秒或纳秒精度）
+    PCAP_FILE_FORMAT_PCAPNG,    // pcapng
+} pcap_file_format_t;
+
+#define PCAP_FILE_MAX_IFACES 64  // 每个 pcapng 节支持的最大接口数
+
+/**
+ * pcapng 接口描述
+ */
+typedef struct {
+    uint16_t linktype;          // 链路类型
+    uint8_t tsresol_base2;      // 时间戳精度底数是否为 2
+    uint8_t tsresol_exp;        // 时间戳精度指数
+} pcap_file_iface_t;
+
+/**
+ * 抓包文件记录解析器
+ *
+ * 解析器只保存格式状态，不持有数据，可用于整个文件映射，
+ * 也可用于逐块读取的流式缓冲区。
+ */
+typedef struct {
+    pcap_file_format_t format;  // 文件格式
+    bool swapped;               // 字节序是否与本机相反
+    bool nsec;                  // 经典 pcap 是否为纳秒精度
+    uint32_t linktype;          // 链路类型（pcapng 为第一个接口的链路类型）
+    uint32_t snaplen;           // 抓包长度
+    uint32_t section;           // 已解析的 pcapng 节数
+    uint32_t if_count;          // 当前节的接口数
+    pcap_file_iface_t ifaces[PCAP_FILE_MAX_IFACES]; // 当前节的接口
+    size_t record_offset;       // 最近一次返回的数据包记录在 buf 中的偏移
+} pcap_file_parser_t;
+
+/**
+ * 解析文件头
+ * @param parser 解析器
+ * @param buf 文件起始处的数据
+ * @param len 数据长度
+ * @param consumed 返回文件头占用的字节数
+ * @return 成功返回 1，数据不足返回 0，格式错误返回 -1
+ */
+int pcap_file_parser_init(
+    pcap_file_parser_t* parser,
+    const uint8_t* buf,
+    size_t len,
+    size_t* consumed
+);
+
+/**
+ * 解析下一条数据包记录
+ *
+ * 非数据包的 pcapng 块（接口描述、统计等）会被处理并跳过。
+ * 返回 1 时 pkt->data 指向 buf 内部，不做拷贝。
+ *
+ * @param parser 解析器
+ * @param buf 当前位置的数据
+ * @param len 数据长度
+ * @param consumed 返回本次消耗的字节数
+ * @param pkt 数据包
+ * @return 得到数据包返回 1，数据不足（记录不完整）返回 0，格式错误返回 -1
+ */
+int pcap_file_parser_next(
+    pcap_file_parser_t* parser,
+    const uint8_t* buf,
+    size_t len,
+    size_t* consumed,
+    packet_t* pkt
+);
+
+/**
+ * 内存映射的抓包文件读取器
+ */
+typedef struct pcap_mmap_reader pcap_mmap_reader_t;
+
+/**
+ * 打开抓包文件
+ *
+ * 将整个文件映射到内存，并线性扫描一次建立记录偏移索引。
+ *
+ * @param path 文件路径
+ * @param reader 返回读取器
+ * @return 成功返回 0，失败返回错误码
+ */
+int pcap_mmap_reader_open(const char* path, pcap_mmap_reader_t** reader);
+
+/**
+ * 关闭读取器并解除映射
+ * @param reader 读取器
+ */
+void pcap_mmap_reader_close(pcap_mmap_reader_t* reader);
+
+/**
+ * 获取文件中的数据包数量
+ * @param reader 读取器
+ * @return 数据包数量
+ */
+size_t pcap_mmap_reader_count(const pcap_mmap_reader_t* reader);
+
+/**
+ * 获取文件的链路类型
+ * @param reader 读取器
+ * @return 链路类型
+ */
+uint32_t pcap_mmap_reader_linktype(const pcap_mmap_reader_t* reader);
+
+/**
+ * 按索引读取数据包
+ *
+ * pkt->data 直接指向文件映射，在读取器关闭前一直有效。
+ * 该函数只读访问读取器，可由多个线程按不同区间并发调用。
+ *
+ * @param reader 读取器
+ * @param index 数据包索引
+ * @param pkt 数据包
+ * @return 成功返回 0，失败返回错误码
+ */
+int pcap_mmap_reader_get(const pcap_mmap_reader_t* reader, size_t index, packet_t* pkt);
+
+/**
+ * io_uring 读取器默认参数
+ */
+#define PCAP_URING_DEFAULT_CHUNK_SIZE   (4u << 20)  // 单次读取 4 MiB
+#define PCAP_URING_DEFAULT_QUEUE_DEPTH  8           // 在途读请求数
+
+/**
+ * io_uring 读取器配置
+ *
+ * 参数为 0 时使用默认值，chunk_size 必须是 4096 的整数倍。
+ */
+typedef struct {
+    uint32_t chunk_size;        // 单次读取大小
+    uint32_t queue_depth;       // 注册缓冲区数量，即同时在途的读请求数
+    bool direct_io;             // 是否以 O_DIRECT 打开文件
+} pcap_uring_config_t;
+
+/**
+ * 基于 io_uring 的流式抓包文件读取器
+ */
+typedef struct pcap_uring_reader pcap_uring_reader_t;
+
+/**
+ * 打开抓包文件
+ *
+ * 注册一组固定缓冲区，并立即提交多个大块读请求；
+ * 解析当前块的同时后续块已在读取中。
+ *
+ * @param path 文件路径
+ * @param config 配置信息，可为 NULL
+ * @param reader 返回读取器
+ * @return 成功返回 0，失败返回错误码
+ */
+int pcap_uring_reader_open(
+    const char* path,
+    const pcap_uring_config_t* config,
+    pcap_uring_reader_t** reader
+);
+
+/**
+ * 关闭读取器，等待在途读请求完成后释放缓冲区
+ * @param reader 读取器
+ */
+void pcap_uring_reader_close(pcap_uring_reader_t* reader);
+
+/**
+ * 获取文件的链路类型
+ * @param reader 读取器
+ * @return 链路类型
+ */
+uint32_t pcap_uring_reader_linktype(const pcap_uring_reader_t* reader);
+
+/**
+ * 读取下一个数据包
+ *
+ * pkt->data 通常直接指向注册缓冲区，只有跨越块边界的记录才会拷贝到拼接缓冲区；
+ * 数据在下一次调用前有效。
+ *
+ * @param reader 读取器
+ * @param pkt 数据包
+ * @return 得到数据包返回 1，文件结束返回 0，出错返回 -1
+ */
+int pcap_uring_reader_next(pcap_uring_reader_t* reader, packet_t* pkt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PCAP_FILE_H
@@ -0,0 +1,959 @@
+#include <pcap.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <stdatomic.h>
+#include "../../include/backends/af_packet_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
+
+struct af_packet_backend;
+
+// 单个套接字及其环形缓冲区，每个由一个接收线程独占
+struct af_packet_ring {
+    struct af_packet_backend* owner; // 所属后端
+    int fd;                          // AF_PACKET 套接字
+    uint8_t* ring;                   // 映射的环形缓冲区
+    atomic_uint* block_refs;         // 每个块的引用计数：遍历中或被租用时非 0
+    uint32_t current_block;          // 当前遍历的块
+    pthread_t thread;                // 接收线程
+    bool has_thread;                 // 是否创建了接收线程
+    int result;                      // 接收循环的返回值
+    capture_sink_t sink;             // 数据包交付器
+    capture_counters_t counters;     // 交付计数，只由该套接字的接收线程写入
+    atomic_uint_fast64_t kernel_drops; // 内核累计统计的丢包数
+};
+
+struct af_packet_backend {
+    capture_backend_t base;          // 基础后端结构
+    struct af_packet_ring* rings;    // 套接字数组
+    uint32_t ring_count;             // 套接字数量
+    int wake_fd;                     // 用于唤醒 poll 的 eventfd，所有接收线程共用
+    int epoll_fd;                    // 拉取模式下汇总所有套接字的 epoll 描述符
+    int ifindex;                     // 接口索引
+    char* device;                    // 设备名称
+    char* filter;                    // 过滤器
+    int snaplen;                     // 抓包长度
+    struct tpacket_req3 req;         // 环形缓冲区参数
+    size_t ring_size;                // 单个环形缓冲区大小
+    uint32_t fanout_arg;             // PACKET_FANOUT 参数
+    capture_affinity_t affinity;     // 接收线程放置
+    packet_callback_t packet_cb;     // 数据包回调
+    packet_batch_callback_t batch_cb; // 批量数据包回调
+    uint32_t burst_size;             // 批量回调的突发大小
+    void* user_data;                 // 用户数据
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    struct af_packet_ring* pull_ring; // 拉取模式下借出块所在的套接字
+    struct tpacket_block_desc* pull_block; // 拉取模式下借出的块
+    const uint8_t* pull_cursor;      // 借出块中下一个未取走的数据包
+    uint32_t pull_remaining;         // 借出块中未取走的数据包数
+    uint32_t pull_next;              // 下一个轮询的套接字
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// 自动分配扇出组 ID 时使用的计数器，避免同一进程内多个实例冲突
+static atomic_uint af_packet_fanout_seq;
+
+// 内部函数声明
+static void af_packet_report(struct af_packet_backend* backend, const char* what);
+static int af_packet_attach_filter(struct af_packet_backend* backend, uint32_t first, uint32_t count, const char* filter);
+static void af_packet_restore_filter(struct af_packet_backend* backend, uint32_t first, uint32_t count);
+static int af_packet_open_ring(struct af_packet_backend* backend, uint32_t index, bool promiscuous);
+static void af_packet_release(struct af_packet_backend* backend);
+static void af_packet_cleanup(void* backend);
+static int af_packet_start(void* backend, packet_callback_t callback, void* user_data);
+static int af_packet_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
+static int af_packet_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+static int af_packet_get_fd(void* backend);
+static int af_packet_lease(void* backend, const packet_t* packet);
+static void af_packet_release_packet(void* backend, const packet_t* packet);
+static int af_packet_stop(void* backend);
+static int af_packet_pause(void* backend);
+static int af_packet_resume(void* backend);
+static int af_packet_set_filter(void* backend, const char* filter);
+static int af_packet_get_stats(void* backend, capture_stats_t* stats);
+static int af_packet_get_thread_stats(void* backend, capture_thread_stats_t* stats, uint32_t max);
+static const char* af_packet_get_name(void* backend);
+static const char* af_packet_get_version(void* backend);
+static const char* af_packet_get_description(void* backend);
+static bool af_packet_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t af_packet_backend_ops = {
+    .cleanup = af_packet_cleanup,
+    .start = af_packet_start,
+    .start_batch = af_packet_start_batch,
+    .next_batch = af_packet_next_batch,
+    .get_fd = af_packet_get_fd,
+    .lease = af_packet_lease,
+    .release = af_packet_release_packet,
+    .stop = af_packet_stop,
+    .pause = af_packet_pause,
+    .resume = af_packet_resume,
+    .set_filter = af_packet_set_filter,
+    .get_stats = af_packet_get_stats,
+    .get_thread_stats = af_packet_get_thread_stats,
+    .get_name = af_packet_get_name,
+    .get_version = af_packet_get_version,
+    .get_description = af_packet_get_description,
+    .is_feature_supported = af_packet_is_feature_supported,
+};
+
+// 通过错误回调上报带 errno 描述的错误
+static void af_packet_report(struct af_packet_backend* backend, const char* what) {
+    char msg[256];
+    snprintf(msg, sizeof(msg), "%s: %s", what, strerror(errno));
+    backend->base.error_cb(msg, backend->base.error_user_data);
+}
+
+// 借助 libpcap 编译过滤器，再以经典 BPF 形式挂到 [first, first + count) 的套接字上
+static int af_packet_attach_filter(struct af_packet_backend* backend, uint32_t first, uint32_t count, const char* filter) {
+    pcap_t* dead = pcap_open_dead(DLT_EN10MB, backend->snaplen);
+    if (!dead) {
+        backend->base.error_cb("Failed to open dead pcap handle", backend->base.error_user_data);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    struct bpf_program fp;
+    if (pcap_compile(dead, &fp, filter, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        backend->base.error_cb(pcap_geterr(dead), backend->base.error_user_data);
+        pcap_close(dead);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    // struct bpf_insn 与 struct sock_filter 布局一致
+    struct sock_fprog prog = {
+        .len = (unsigned short)fp.bf_len,
+        .filter = (struct sock_filter*)fp.bf_insns,
+    };
+
+    // 扇出组中每个套接字各自挂一份过滤器，程序只编译一次，各套接字的
+    // 切换间隔只有几次系统调用
+    uint32_t attached = 0;
+    int ret = CAPTURE_SUCCESS;
+    for (uint32_t i = first; i < first + count; i++, attached++) {
+        if (setsockopt(backend->rings[i].fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) != 0) {
+            af_packet_report(backend, "SO_ATTACH_FILTER");
+            ret = CAPTURE_ERROR_SET_FILTER;
+            break;
+        }
+    }
+    pcap_freecode(&fp);
+    pcap_close(dead);
+
+    // 部分套接字失败时恢复已切换的套接字，扇出组内不留下两种过滤器
+    if (ret != CAPTURE_SUCCESS && attached > 0) {
+        af_packet_restore_filter(backend, first, attached);
+    }
+    return ret;
+}
+
+// 把 [first, first + count) 的套接字恢复为当前过滤器，没有过滤器时卸下
+static void af_packet_restore_filter(struct af_packet_backend* backend, uint32_t first, uint32_t count) {
+    if (backend->filter) {
+        af_packet_attach_filter(backend, first, count, backend->filter);
+        return;
+    }
+    int unused = 0;
+    for (uint32_t i = first; i < first + count; i++) {
+        setsockopt(backend->rings[i].fd, SOL_SOCKET, SO_DETACH_FILTER, &unused, sizeof(unused));
+    }
+}
+
+// 打开一个套接字、映射块环并绑定接口，需要时加入扇出组
+static int af_packet_open_ring(struct af_packet_backend* backend, uint32_t index, bool promiscuous) {
+    struct af_packet_ring* ring = &backend->rings[index];
+    ring->fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    if (ring->fd < 0) {
+        af_packet_report(backend, "socket(AF_PACKET)");
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    // 在绑定接口之前挂上过滤器，避免环中混入未过滤的数据包
+    if (backend->filter && af_packet_attach_filter(backend, index, 1, backend->filter) != CAPTURE_SUCCESS) {
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+        af_packet_report(backend, "PACKET_VERSION");
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_RX_RING, &backend->req, sizeof(backend->req)) != 0) {
+        af_packet_report(backend, "PACKET_RX_RING");
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    ring->ring = mmap(NULL, backend->ring_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_LOCKED, ring->fd, 0);
+    if (ring->ring == MAP_FAILED) {
+        // 没有 CAP_IPC_LOCK 时退回普通映射
+        ring->ring = mmap(NULL, backend->ring_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, ring->fd, 0);
+    }
+    if (ring->ring == MAP_FAILED) {
+        af_packet_report(backend, "mmap(PACKET_RX_RING)");
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    ring->block_refs = calloc(backend->req.tp_block_nr, sizeof(atomic_uint));
+    if (!ring->block_refs) {
+        backend->base.error_cb("Failed to allocate block reference counts", backend->base.error_user_data);
+        return CAPTURE_ERROR_MEMORY;
+    }
+
+    struct sockaddr_ll addr = {
+        .sll_family = AF_PACKET,
+        .sll_protocol = htons(ETH_P_ALL),
+        .sll_ifindex = backend->ifindex,
+    };
+    if (bind(ring->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        af_packet_report(backend, "bind(AF_PACKET)");
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    // 扇出组只能在套接字绑定之后加入
+    if (backend->ring_count > 1 &&
+        setsockopt(ring->fd, SOL_PACKET, PACKET_FANOUT, &backend->fanout_arg, sizeof(backend->fanout_arg)) != 0) {
+        af_packet_report(backend, "PACKET_FANOUT");
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    if (promiscuous) {
+        struct packet_mreq mreq = {
+            .mr_ifindex = backend->ifindex,
+            .mr_type = PACKET_MR_PROMISC,
+        };
+        if (setsockopt(ring->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            af_packet_report(backend, "PACKET_MR_PROMISC");
+            return CAPTURE_ERROR_OPEN_FAILED;
+        }
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// 把配置中的扇出模式转换为 PACKET_FANOUT 参数
+static uint32_t af_packet_fanout_arg(const af_packet_backend_config_t* config) {
+    uint32_t type;
+    switch (config->fanout_mode) {
+        case AF_PACKET_FANOUT_CPU:
+            type = PACKET_FANOUT_CPU;
+            break;
+        case AF_PACKET_FANOUT_ROLLOVER:
+            type = PACKET_FANOUT_ROLLOVER;
+            break;
+        case AF_PACKET_FANOUT_LB:
+            type = PACKET_FANOUT_LB;
+            break;
+        case AF_PACKET_FANOUT_QM:
+            type = PACKET_FANOUT_QM;
+            break;
+        default:
+            type = PACKET_FANOUT_HASH;
+            break;
+    }
+    if (config->fanout_defrag) {
+        type |= PACKET_FANOUT_FLAG_DEFRAG;
+    }
+
+    uint16_t group = config->fanout_group;
+    if (group == 0) {
+        // 组 ID 在网络命名空间内全局可见，按进程号和实例序号区分
+        group = (uint16_t)(getpid() + atomic_fetch_add(&af_packet_fanout_seq, 1));
+        if (group == 0) {
+            group = 1;
+        }
+    }
+    return (uint32_t)group | (type << 16);
+}
+
+// 释放套接字、环形缓冲区等资源
+static void af_packet_release(struct af_packet_backend* backend) {
+    for (uint32_t i = 0; backend->rings && i < backend->ring_count; i++) {
+        struct af_packet_ring* ring = &backend->rings[i];
+        if (ring->ring && ring->ring != MAP_FAILED) {
+            munmap(ring->ring, backend->ring_size);
+        }
+        if (ring->fd >= 0) {
+            close(ring->fd);
+        }
+        free(ring->block_refs);
+    }
+    free(backend->rings);
+    if (backend->wake_fd >= 0) {
+        close(backend->wake_fd);
+    }
+    if (backend->epoll_fd >= 0) {
+        close(backend->epoll_fd);
+    }
+    capture_affinity_destroy(&backend->affinity);
+    free(backend->device);
+    free(backend->filter);
+    free(backend);
+}
+
+// 创建 AF_PACKET 后端
+capture_backend_t* af_packet_backend_create(
+    const af_packet_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !config->device || !error_cb) {
+        return NULL;
+    }
+
+    struct af_packet_backend* backend = calloc(1, sizeof(struct af_packet_backend));
+    if (!backend) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    backend->base.private_data = backend;
+    backend->base.ops = &af_packet_backend_ops;
+    backend->base.type = CAPTURE_BACKEND_AF_PACKET;
+    backend->base.error_cb = error_cb;
+    backend->base.error_user_data = error_user_data;
+
+    backend->wake_fd = -1;
+    backend->epoll_fd = -1;
+    backend->snaplen = config->snaplen > 0 ? config->snaplen : 65535;
+    backend->device = strdup(config->device);
+    backend->filter = config->filter ? strdup(config->filter) : NULL;
+    backend->ring_count = config->fanout_count > 1 ? config->fanout_count : 1;
+    atomic_init(&backend->running, false);
+    atomic_init(&backend->paused, false);
+
+    if (backend->ring_count > AF_PACKET_MAX_FANOUT) {
+        error_cb("Fanout socket count exceeds AF_PACKET_MAX_FANOUT", error_user_data);
+        af_packet_release(backend);
+        return NULL;
+    }
+
+    if (capture_affinity_init(&backend->affinity, config->cpus, config->cpu_count,
+                              config->numa_nodes, false) != CAPTURE_SUCCESS) {
+        error_cb("Invalid receive CPU placement", error_user_data);
+        af_packet_release(backend);
+        return NULL;
+    }
+
+    backend->rings = calloc(backend->ring_count, sizeof(struct af_packet_ring));
+    if (!backend->rings) {
+        af_packet_release(backend);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < backend->ring_count; i++) {
+        backend->rings[i].owner = backend;
+        backend->rings[i].fd = -1;
+    }
+
+    backend->ifindex = (int)if_nametoindex(backend->device);
+    if (backend->ifindex == 0) {
+        af_packet_report(backend, backend->device);
+        af_packet_release(backend);
+        return NULL;
+    }
+
+    backend->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (backend->wake_fd < 0) {
+        af_packet_report(backend, "eventfd");
+        af_packet_release(backend);
+        return NULL;
+    }
+
+    // 配置块环
+    backend->req.tp_block_size = config->block_size ? config->block_size : AF_PACKET_DEFAULT_BLOCK_SIZE;
+    backend->req.tp_block_nr = config->block_count ? config->block_count : AF_PACKET_DEFAULT_BLOCK_COUNT;
+    backend->req.tp_frame_size = config->frame_size ? config->frame_size : AF_PACKET_DEFAULT_FRAME_SIZE;
+    backend->req.tp_frame_nr = (backend->req.tp_block_size / backend->req.tp_frame_size) * backend->req.tp_block_nr;
+    backend->req.tp_retire_blk_tov = config->timeout_ms > 0 ? (unsigned int)config->timeout_ms : AF_PACKET_DEFAULT_RETIRE_MS;
+    backend->req.tp_sizeof_priv = 0;
+    backend->req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+    backend->ring_size = (size_t)backend->req.tp_block_size * backend->req.tp_block_nr;
+    backend->fanout_arg = af_packet_fanout_arg(config);
+
+    for (uint32_t i = 0; i < backend->ring_count; i++) {
+        // 内核按当前 CPU 所在节点分配块环，建立时临时切到接收线程的位置
+        capture_cpu_mask_t saved;
+        bool moved = capture_affinity_enter(&backend->affinity, i, &saved);
+        int ret = af_packet_open_ring(backend, i, config->promiscuous);
+        if (moved) {
+            capture_affinity_leave(&saved);
+        }
+        if (ret != CAPTURE_SUCCESS) {
+            af_packet_release(backend);
+            return NULL;
+        }
+    }
+
+    return &backend->base;
+}
+
+// 销毁 AF_PACKET 后端
+void af_packet_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    af_packet_release((struct af_packet_backend*)backend);
+}
+
+static void af_packet_cleanup(void* backend) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af) {
+        return;
+    }
+    if (atomic_load(&af->running)) {
+        af_packet_stop(af);
+    }
+    af_packet_release(af);
+}
+
+static struct tpacket_block_desc* af_packet_block(struct af_packet_backend* af, struct af_packet_ring* ring, uint32_t index) {
+    return (struct tpacket_block_desc*)(ring->ring + (size_t)index * af->req.tp_block_size);
+}
+
+// 块已退役且没有被租用时才是新数据；先读引用计数，与 af_packet_block_put 的写入顺序配对
+static bool af_packet_block_ready(struct af_packet_backend* af, struct af_packet_ring* ring, uint32_t index) {
+    if (atomic_load_explicit(&ring->block_refs[index], memory_order_acquire) != 0) {
+        return false;
+    }
+    struct tpacket_block_desc* block = af_packet_block(af, ring, index);
+    return (__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0;
+}
+
+// 释放块的一个引用，最后一个引用释放时把块归还内核。
+// 遍历结束后不会再有新的租用，计数为 1 时调用者是唯一持有者，
+// 因此先归还块再清零计数，接收线程不会把尚未归还的旧块误当作新数据
+static void af_packet_block_put(struct af_packet_backend* af, struct af_packet_ring* ring, uint32_t index) {
+    atomic_uint* refs = &ring->block_refs[index];
+    unsigned int old = atomic_load_explicit(refs, memory_order_relaxed);
+    for (;;) {
+        if (old == 1) {
+            struct tpacket_block_desc* block = af_packet_block(af, ring, index);
+            __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            atomic_store_explicit(refs, 0, memory_order_release);
+            return;
+        }
+        if (atomic_compare_exchange_weak_explicit(refs, &old, old - 1,
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+// 根据数据包地址找到其所在的套接字与块
+static bool af_packet_locate(struct af_packet_backend* af, const uint8_t* data,
+                             struct af_packet_ring** ring_out, uint32_t* index_out) {
+    for (uint32_t i = 0; i < af->ring_count; i++) {
+        struct af_packet_ring* ring = &af->rings[i];
+        if (data >= ring->ring && data < ring->ring + af->ring_size) {
+            *ring_out = ring;
+            *index_out = (uint32_t)((size_t)(data - ring->ring) / af->req.tp_block_size);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 根据帧头填写数据包描述
+static void af_packet_fill(const uint8_t* frame, packet_t* pkt) {
+    const struct tpacket3_hdr* hdr = (const struct tpacket3_hdr*)frame;
+    pkt->data = frame + hdr->tp_mac;
+    pkt->len = hdr->tp_len;
+    pkt->caplen = hdr->tp_snaplen;
+    pkt->ts.tv_sec = hdr->tp_sec;
+    pkt->ts.tv_nsec = hdr->tp_nsec;
+    pkt->if_index = 0;
+    pkt->device_index = 0;
+    pkt->flags = 0;
+    pkt->protocol = 0;
+    pkt->vlan_tci = (hdr->tp_status & TP_STATUS_VLAN_VALID) ? hdr->hv1.tp_vlan_tci : 0;
+
+    // 帧头之后是来源地址，其中的硬件类型决定链路层格式
+    const struct sockaddr_ll* sll = (const struct sockaddr_ll*)(frame + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+    packet_decode(pkt, packet_linktype_arphrd(sll->sll_hatype));
+}
+
+// 遍历一个已归还用户空间的块，将其中的数据包交给回调；批量模式下块内数据包
+// 攒批交付，块归还内核前交付剩余部分
+static bool af_packet_walk_block(struct af_packet_ring* ring, struct tpacket_block_desc* block) {
+    struct af_packet_backend* backend = ring->owner;
+    uint32_t num_pkts = block->hdr.bh1.num_pkts;
+    const uint8_t* cursor = (const uint8_t*)block + block->hdr.bh1.offset_to_first_pkt;
+    bool deliver = !atomic_load_explicit(&backend->paused, memory_order_relaxed);
+    bool keep_going = true;
+
+    for (uint32_t i = 0; i < num_pkts; i++) {
+        const struct tpacket3_hdr* hdr = (const struct tpacket3_hdr*)cursor;
+
+        if (deliver && keep_going) {
+            packet_t pkt;
+            af_packet_fill(cursor, &pkt);
+            if (!capture_sink_push(&ring->sink, &pkt)) {
+                keep_going = false;
+            }
+        }
+
+        cursor += hdr->tp_next_offset;
+    }
+
+    if (keep_going && !capture_sink_flush(&ring->sink)) {
+        keep_going = false;
+    }
+    return keep_going;
+}
+
+// 唤醒所有阻塞在 poll 中的接收线程
+static int af_packet_wake(struct af_packet_backend* backend) {
+    uint64_t one = 1;
+    if (write(backend->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        af_packet_report(backend, "eventfd write");
+        return CAPTURE_ERROR_STOP_FAILED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// 单个套接字的接收循环
+static int af_packet_ring_loop(struct af_packet_ring* ring) {
+    struct af_packet_backend* af = ring->owner;
+    struct pollfd pfds[2] = {
+        { .fd = ring->fd, .events = POLLIN | POLLERR },
+        { .fd = af->wake_fd, .events = POLLIN },
+    };
+
+    // 下游按接收线程序号选择该线程独占的队列
+    capture_rx_index = (uint32_t)(ring - af->rings);
+    while (atomic_load_explicit(&af->running, memory_order_relaxed)) {
+        uint32_t index = ring->current_block;
+
+        if (!af_packet_block_ready(af, ring, index)) {
+            // 当前块还属于内核，等待其退役；块仍被租用时内核无法写入，只能定时重试
+            bool leased = atomic_load_explicit(&ring->block_refs[index], memory_order_relaxed) != 0;
+            if (poll(pfds, 2, leased ? 1 : -1) < 0 && errno != EINTR) {
+                af_packet_report(af, "poll");
+                atomic_store(&af->running, false);
+                af_packet_wake(af);
+                return CAPTURE_ERROR_BACKEND;
+            }
+            if ((pfds[1].revents & POLLIN) && atomic_load(&af->running)) {
+                // 残留的唤醒事件会让 poll 一直立即返回，读掉；期间到达的 stop
+                // 可能被一起读掉，此时重新通知，其他接收线程仍能被唤醒
+                uint64_t drain;
+                while (read(af->wake_fd, &drain, sizeof(drain)) > 0) {
+                }
+                if (!atomic_load(&af->running)) {
+                    af_packet_wake(af);
+                }
+            }
+            continue;
+        }
+
+        // 遍历期间持有一个引用，回调中的租用在此基础上累加
+        atomic_store_explicit(&ring->block_refs[index], 1, memory_order_relaxed);
+        bool keep_going = af_packet_walk_block(ring, af_packet_block(af, ring, index));
+
+        // 整块处理完毕后一次性归还内核，仍被租用时由最后一次 release 归还
+        af_packet_block_put(af, ring, index);
+        ring->current_block = (index + 1) % af->req.tp_block_nr;
+
+        if (!keep_going) {
+            // 回调要求停止时同时让其他接收线程退出
+            atomic_store(&af->running, false);
+            af_packet_wake(af);
+        }
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static void* af_packet_ring_thread(void* arg) {
+    struct af_packet_ring* ring = (struct af_packet_ring*)arg;
+    ring->result = af_packet_ring_loop(ring);
+    return NULL;
+}
+
+// 归还拉取模式下借出的块
+static void af_packet_pull_release(struct af_packet_backend* af) {
+    if (!af->pull_block) {
+        return;
+    }
+    struct af_packet_ring* ring = af->pull_ring;
+    af_packet_block_put(af, ring, ring->current_block);
+    ring->current_block = (ring->current_block + 1) % af->req.tp_block_nr;
+    af->pull_block = NULL;
+    af->pull_ring = NULL;
+    af->pull_remaining = 0;
+}
+
+// 依次检查各套接字，借出第一个已退役且非空的块
+static bool af_packet_pull_acquire(struct af_packet_backend* af) {
+    for (uint32_t k = 0; k < af->ring_count; k++) {
+        struct af_packet_ring* ring = &af->rings[af->pull_next];
+        af->pull_next = (af->pull_next + 1) % af->ring_count;
+
+        while (af_packet_block_ready(af, ring, ring->current_block)) {
+            struct tpacket_block_desc* block = af_packet_block(af, ring, ring->current_block);
+            atomic_store_explicit(&ring->block_refs[ring->current_block], 1, memory_order_relaxed);
+
+            af->pull_ring = ring;
+            af->pull_block = block;
+            af->pull_cursor = (const uint8_t*)block + block->hdr.bh1.offset_to_first_pkt;
+            af->pull_remaining = block->hdr.bh1.num_pkts;
+            if (af->pull_remaining > 0) {
+                return true;
+            }
+            // 超时退役的空块直接归还
+            af_packet_pull_release(af);
+        }
+    }
+    return false;
+}
+
+// 等待任一套接字可读，被 stop 唤醒时返回 0
+static int af_packet_pull_wait(struct af_packet_backend* af, int timeout_ms) {
+    struct pollfd pfds[AF_PACKET_MAX_FANOUT + 1];
+    for (uint32_t i = 0; i < af->ring_count; i++) {
+        pfds[i].fd = af->rings[i].fd;
+        pfds[i].events = POLLIN | POLLERR;
+        pfds[i].revents = 0;
+    }
+    pfds[af->ring_count].fd = af->wake_fd;
+    pfds[af->ring_count].events = POLLIN;
+    pfds[af->ring_count].revents = 0;
+
+    int ret = poll(pfds, af->ring_count + 1, timeout_ms);
+    if (ret < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        af_packet_report(af, "poll");
+        return -CAPTURE_ERROR_BACKEND;
+    }
+    if (pfds[af->ring_count].revents & POLLIN) {
+        uint64_t drain;
+        while (read(af->wake_fd, &drain, sizeof(drain)) > 0) {
+        }
+        return 0;
+    }
+    return ret;
+}
+
+static int af_packet_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !packets || max == 0 || !af->rings) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (af->start_time.tv_sec == 0) {
+        clock_gettime(CLOCK_REALTIME, &af->start_time);
+    }
+
+    // 上一次返回的数据包到此才失效，块取完后归还内核
+    if (af->pull_block && af->pull_remaining == 0) {
+        af_packet_pull_release(af);
+    }
+
+    if (!af->pull_block && !af_packet_pull_acquire(af)) {
+        if (timeout_ms == 0) {
+            return 0;
+        }
+        int ret = af_packet_pull_wait(af, timeout_ms);
+        if (ret <= 0 || !af_packet_pull_acquire(af)) {
+            return ret < 0 ? ret : 0;
+        }
+    }
+
+    struct af_packet_ring* ring = af->pull_ring;
+    bool deliver = !atomic_load_explicit(&af->paused, memory_order_relaxed);
+    uint32_t n = 0;
+    uint64_t bytes = 0;
+    while (af->pull_remaining > 0 && (n < max || !deliver)) {
+        const struct tpacket3_hdr* hdr = (const struct tpacket3_hdr*)af->pull_cursor;
+        if (deliver) {
+            af_packet_fill(af->pull_cursor, &packets[n++]);
+            bytes += hdr->tp_len;
+        }
+        af->pull_cursor += hdr->tp_next_offset;
+        af->pull_remaining--;
+    }
+    if (n > 0) {
+        capture_counters_batch(&ring->counters, n, bytes);
+    }
+    return (int)n;
+}
+
+// 租用回调中（或拉取模式下借出块中）的数据包：增加其所在块的引用计数
+static int af_packet_lease(void* backend, const packet_t* packet) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    struct af_packet_ring* ring;
+    uint32_t index;
+    if (!af || !af->rings || !af_packet_locate(af, packet->data, &ring, &index)) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    if (atomic_load_explicit(&ring->block_refs[index], memory_order_relaxed) == 0) {
+        // 块已归还内核，数据包已失效
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_fetch_add_explicit(&ring->block_refs[index], 1, memory_order_relaxed);
+    return CAPTURE_SUCCESS;
+}
+
+static void af_packet_release_packet(void* backend, const packet_t* packet) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    struct af_packet_ring* ring;
+    uint32_t index;
+    if (af && af->rings && af_packet_locate(af, packet->data, &ring, &index)) {
+        af_packet_block_put(af, ring, index);
+    }
+}
+
+static int af_packet_get_fd(void* backend) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !af->rings) {
+        return -1;
+    }
+    if (af->ring_count == 1) {
+        return af->rings[0].fd;
+    }
+
+    // 多个扇出套接字汇总到一个 epoll 描述符上，epoll 描述符本身可被 poll
+    if (af->epoll_fd < 0) {
+        int epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd < 0) {
+            af_packet_report(af, "epoll_create1");
+            return -1;
+        }
+        for (uint32_t i = 0; i < af->ring_count; i++) {
+            struct epoll_event ev = { .events = EPOLLIN, .data.u32 = i };
+            if (epoll_ctl(epfd, EPOLL_CTL_ADD, af->rings[i].fd, &ev) < 0) {
+                af_packet_report(af, "epoll_ctl");
+                close(epfd);
+                return -1;
+            }
+        }
+        af->epoll_fd = epfd;
+    }
+    return af->epoll_fd;
+}
+
+// 在调用线程上运行所有套接字的接收循环，直到停止
+static int af_packet_run(struct af_packet_backend* af) {
+    af_packet_pull_release(af);
+
+    for (uint32_t i = 0; i < af->ring_count; i++) {
+        if (capture_sink_init(&af->rings[i].sink, af->packet_cb, af->batch_cb,
+                              af->burst_size, af->user_data, &af->rings[i].counters) != CAPTURE_SUCCESS) {
+            af->base.error_cb("Failed to allocate packet batch", af->base.error_user_data);
+            while (i-- > 0) {
+                capture_sink_destroy(&af->rings[i].sink);
+            }
+            return CAPTURE_ERROR_MEMORY;
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &af->start_time);
+    capture_backend_enter(&af->base, &af->running);
+
+    // 第一个套接字在调用线程上接收，其余套接字各启动一个接收线程
+    int ret = CAPTURE_SUCCESS;
+    for (uint32_t i = 1; i < af->ring_count; i++) {
+        struct af_packet_ring* ring = &af->rings[i];
+        ring->result = CAPTURE_SUCCESS;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        capture_affinity_attr(&af->affinity, i, &attr);
+        int err = pthread_create(&ring->thread, &attr, af_packet_ring_thread, ring);
+        pthread_attr_destroy(&attr);
+        if (err != 0) {
+            errno = err;
+            af_packet_report(af, "pthread_create");
+            atomic_store(&af->running, false);
+            af_packet_wake(af);
+            ret = CAPTURE_ERROR_START_FAILED;
+            break;
+        }
+        ring->has_thread = true;
+    }
+
+    if (ret == CAPTURE_SUCCESS) {
+        ret = af_packet_ring_loop(&af->rings[0]);
+    }
+
+    for (uint32_t i = 1; i < af->ring_count; i++) {
+        struct af_packet_ring* ring = &af->rings[i];
+        if (!ring->has_thread) {
+            continue;
+        }
+        pthread_join(ring->thread, NULL);
+        ring->has_thread = false;
+        if (ret == CAPTURE_SUCCESS) {
+            ret = ring->result;
+        }
+    }
+
+    // 清除唤醒事件，便于再次启动
+    uint64_t drain;
+    while (read(af->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+
+    for (uint32_t i = 0; i < af->ring_count; i++) {
+        capture_sink_destroy(&af->rings[i].sink);
+    }
+
+    clock_gettime(CLOCK_REALTIME, &af->end_time);
+    return ret;
+}
+
+static int af_packet_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !callback || !af->rings) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    af->packet_cb = callback;
+    af->batch_cb = NULL;
+    af->user_data = user_data;
+    return af_packet_run(af);
+}
+
+static int af_packet_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !callback || !af->rings) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    af->packet_cb = NULL;
+    af->batch_cb = callback;
+    af->burst_size = burst_size;
+    af->user_data = user_data;
+    return af_packet_run(af);
+}
+
+static int af_packet_stop(void* backend) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&af->base, &af->running);
+
+    // 唤醒阻塞在 poll 中的抓包线程
+    return af_packet_wake(af);
+}
+
+static int af_packet_pause(void* backend) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    // 暂停期间继续归还块，避免内核环溢出，但不再交付数据包
+    atomic_store(&af->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int af_packet_resume(void* backend) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&af->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int af_packet_set_filter(void* backend, const char* filter) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    // SO_ATTACH_FILTER 会在内核中原子替换旧过滤器
+    int ret = af_packet_attach_filter(af, 0, af->ring_count, filter);
+    if (ret == CAPTURE_SUCCESS) {
+        free(af->filter);
+        af->filter = strdup(filter);
+    }
+    return ret;
+}
+
+static int af_packet_get_stats(void* backend, capture_stats_t* stats) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    uint64_t drops = 0;
+    for (uint32_t i = 0; i < af->ring_count; i++) {
+        struct af_packet_ring* ring = &af->rings[i];
+
+        // PACKET_STATISTICS 读取后内核计数清零，这里累加保存；get_stats 可能
+        // 在多个线程上同时调用，各自取走的增量用原子加累加
+        struct tpacket_stats_v3 kstats;
+        socklen_t len = sizeof(kstats);
+        if (getsockopt(ring->fd, SOL_PACKET, PACKET_STATISTICS, &kstats, &len) != 0) {
+            af_packet_report(af, "PACKET_STATISTICS");
+            return CAPTURE_ERROR_GET_STATS;
+        }
+        drops += atomic_fetch_add_explicit(&ring->kernel_drops, kstats.tp_drops, memory_order_relaxed) +
+                 kstats.tp_drops;
+    }
+
+    stats->packets_dropped = drops;
+    stats->packets_if_dropped = 0;
+    stats->start_time = af->start_time;
+    stats->end_time = af->end_time;
+    for (uint32_t i = 0; i < af->ring_count; i++) {
+        capture_counters_merge(&af->rings[i].counters, stats);
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// 每个扇出套接字对应一个接收线程
+static int af_packet_get_thread_stats(void* backend, capture_thread_stats_t* stats, uint32_t max) {
+    struct af_packet_backend* af = (struct af_packet_backend*)backend;
+    if (!af || !af->rings) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+    for (uint32_t i = 0; i < af->ring_count && i < max; i++) {
+        capture_counters_read(&af->rings[i].counters, CAPTURE_THREAD_RECEIVE, i, &stats[i]);
+    }
+    return (int)af->ring_count;
+}
+
+static const char* af_packet_get_name(void* backend) {
+    return "af_packet";
+}
+
+static const char* af_packet_get_version(void* backend) {
+    return "TPACKET_V3";
+}
+
+static const char* af_packet_get_description(void* backend) {
+    return "AF_PACKET TPACKET_V3 memory-mapped ring backend";
+}
+
+static bool af_packet_is_feature_supported(void* backend, const char* feature) {
+    if (!feature) {
+        return false;
+    }
+    return strcmp(feature, "zero_copy") == 0 ||
+           strcmp(feature, "filter") == 0 ||
+           strcmp(feature, "rx_hash") == 0 ||
+           strcmp(feature, "fanout") == 0 ||
+           strcmp(feature, "batch") == 0 ||
+           strcmp(feature, "lease") == 0;
+}
@@ -0,0 +1,895 @@
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <stdatomic.h>
+#include "../../include/backends/dispatch_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
+
+#define DISPATCH_RECORD_ALIGN 8
+#define DISPATCH_RECORD_PAD   1  // 队列末尾的回绕填充记录
+
+// 队列中的一条记录，数据包内容紧随其后
+typedef struct {
+    uint32_t size;                   // 记录总长度（含头部，按 8 字节对齐）
+    uint32_t flags;                  // 记录标志
+    packet_t meta;                   // 数据包元数据
+} dispatch_record_t;
+
+struct dispatch_backend;
+
+// 一个接收线程到一个工作线程的单生产者单消费者队列
+typedef struct {
+    uint8_t* buf;                    // 队列缓冲区
+    uint32_t size;                   // 队列大小（2 的幂）
+    int space_fd;                    // BLOCK 策略下唤醒接收线程的 eventfd
+    pthread_mutex_t lock;            // DROP_OLDEST：保护两端对 head 的修改
+    _Alignas(64) atomic_uint_fast64_t head; // 消费位置
+    _Alignas(64) atomic_uint_fast64_t tail; // 生产位置
+    atomic_bool space_waiting;       // 接收线程是否在等待队列空间
+    uint64_t sample_seq;             // 过载采样计数
+} dispatch_queue_t;
+
+// 一个工作线程及其分发队列
+typedef struct {
+    struct dispatch_backend* owner;  // 所属分发后端
+    uint32_t index;                  // 工作线程序号
+    pthread_t thread;                // 工作线程
+    bool has_thread;                 // 是否创建了工作线程
+    int wake_fd;                     // 唤醒工作线程的 eventfd
+    dispatch_queue_t* queues;        // 每个接收线程一个队列
+    uint32_t next_queue;             // 下一个优先检查的队列
+    packet_t* batch;                 // 批量模式的交付数组
+    uint8_t* scratch;                // DROP_OLDEST：取出记录的副本（队列大小的一半）
+    _Alignas(64) atomic_bool waiting; // 工作线程是否正在等待
+    capture_counters_t counters;     // 交付计数，只由工作线程写入
+} dispatch_worker_t;
+
+struct dispatch_backend {
+    capture_backend_t base;          // 基础后端结构
+    capture_backend_t* inner;        // 内部后端
+    dispatch_worker_t* workers;      // 工作线程数组
+    uint32_t worker_count;           // 工作线程数
+    uint32_t producer_count;         // 接收线程数（每个工作线程的队列数）
+    capture_counters_t* producers;   // 每个接收线程写入队列时的过载计数
+    capture_affinity_t affinity;     // 工作线程放置
+    capture_overload_policy_t policy; // 队列满时的过载策略
+    uint32_t sample_rate;            // SAMPLE 策略每 sample_rate 个保留 1 个
+    packet_callback_t packet_cb;     // 数据包回调
+    packet_batch_callback_t batch_cb; // 批量数据包回调
+    uint32_t burst_size;             // 批量模式每批最大数据包数
+    void* user_data;                 // 用户数据
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    atomic_bool input_done;          // 内部后端是否已结束
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+static _Thread_local int dispatch_current_worker = -1;
+
+// 内部函数声明
+static void dispatch_cleanup(void* backend);
+static int dispatch_start(void* backend, packet_callback_t callback, void* user_data);
+static int dispatch_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
+static int dispatch_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+static int dispatch_get_fd(void* backend);
+static int dispatch_stop(void* backend);
+static int dispatch_pause(void* backend);
+static int dispatch_resume(void* backend);
+static int dispatch_set_filter(void* backend, const char* filter);
+static int dispatch_get_stats(void* backend, capture_stats_t* stats);
+static int dispatch_get_thread_stats(void* backend, capture_thread_stats_t* stats, uint32_t max);
+static const char* dispatch_get_name(void* backend);
+static const char* dispatch_get_version(void* backend);
+static const char* dispatch_get_description(void* backend);
+static bool dispatch_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t dispatch_backend_ops = {
+    .cleanup = dispatch_cleanup,
+    .start = dispatch_start,
+    .start_batch = dispatch_start_batch,
+    .next_batch = dispatch_next_batch,
+    .get_fd = dispatch_get_fd,
+    .stop = dispatch_stop,
+    .pause = dispatch_pause,
+    .resume = dispatch_resume,
+    .set_filter = dispatch_set_filter,
+    .get_stats = dispatch_get_stats,
+    .get_thread_stats = dispatch_get_thread_stats,
+    .get_name = dispatch_get_name,
+    .get_version = dispatch_get_version,
+    .get_description = dispatch_get_description,
+    .is_feature_supported = dispatch_is_feature_supported,
+};
+
+// 对称五元组哈希：接收时已由解码器算好，未解码的数据包（外部后端）在此解码
+static uint32_t dispatch_flow_hash(const packet_t* packet) {
+    if (packet->flags & PACKET_FLAG_DECODED) {
+        return packet->hash;
+    }
+    packet_t decoded = *packet;
+    packet_decode(&decoded, PACKET_LINKTYPE_ETHERNET);
+    return decoded.hash;
+}
+
+static void dispatch_wake(dispatch_worker_t* worker) {
+    uint64_t one = 1;
+    if (write(worker->wake_fd, &one, sizeof(one)) < 0) {
+        // eventfd 计数已满时工作线程必然处于可唤醒状态
+    }
+}
+
+static void dispatch_wake_space(dispatch_queue_t* queue) {
+    uint64_t one = 1;
+    if (write(queue->space_fd, &one, sizeof(one)) < 0) {
+        // eventfd 计数已满时接收线程必然处于可唤醒状态
+    }
+}
+
+static int64_t dispatch_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void dispatch_notify(struct dispatch_backend* dispatch, uint64_t mask);
+
+// BLOCK 策略：等待工作线程腾出空间；返回 false 表示已停止
+static bool dispatch_wait_space(struct dispatch_backend* dispatch, dispatch_worker_t* worker,
+                                dispatch_queue_t* queue, uint64_t need) {
+    // 批量入队时工作线程可能还没被唤醒，先通知再等待
+    dispatch_notify(dispatch, 1ULL << worker->index);
+
+    struct pollfd pfd = { .fd = queue->space_fd, .events = POLLIN };
+    atomic_store(&queue->space_waiting, true);
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t used = atomic_load_explicit(&queue->tail, memory_order_relaxed) -
+                    atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (used + need > queue->size && atomic_load_explicit(&dispatch->running, memory_order_relaxed)) {
+        poll(&pfd, 1, -1);
+        uint64_t drain;
+        while (read(queue->space_fd, &drain, sizeof(drain)) > 0) {
+        }
+    }
+    atomic_store(&queue->space_waiting, false);
+    return atomic_load_explicit(&dispatch->running, memory_order_relaxed);
+}
+
+// 生产者：把数据包拷贝进接收线程到工作线程的队列，队列满时按过载策略处理，
+// 过载计数记在接收线程自己的 counters 上
+static void dispatch_push(struct dispatch_backend* dispatch, dispatch_worker_t* worker, dispatch_queue_t* queue,
+                          capture_counters_t* counters, const packet_t* packet) {
+    uint32_t need = (uint32_t)((sizeof(dispatch_record_t) + packet->caplen + DISPATCH_RECORD_ALIGN - 1) &
+                               ~(size_t)(DISPATCH_RECORD_ALIGN - 1));
+    if (need > queue->size / 2) {
+        capture_counter_add(&counters->dropped_newest, 1);
+        return;
+    }
+
+    uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    // 队列超过一半时确定性地按 1/N 采样
+    if (dispatch->policy == CAPTURE_OVERLOAD_SAMPLE && tail - head > queue->size / 2 &&
+        queue->sample_seq++ % dispatch->sample_rate != 0) {
+        capture_counter_add(&counters->sampled_out, 1);
+        return;
+    }
+
+    uint32_t offset = (uint32_t)(tail & (queue->size - 1));
+    uint32_t contiguous = queue->size - offset;
+    uint64_t total = contiguous < need ? (uint64_t)contiguous + need : need;
+
+    if (tail + total - head > queue->size) {
+        if (dispatch->policy == CAPTURE_OVERLOAD_BLOCK) {
+            int64_t begin = dispatch_now_ns();
+            capture_counter_add(&counters->blocked, 1);
+            do {
+                if (!dispatch_wait_space(dispatch, worker, queue, total)) {
+                    capture_counter_add(&counters->blocked_ns, (uint64_t)(dispatch_now_ns() - begin));
+                    capture_counter_add(&counters->dropped_newest, 1);
+                    return;
+                }
+                head = atomic_load_explicit(&queue->head, memory_order_acquire);
+            } while (tail + total - head > queue->size);
+            capture_counter_add(&counters->blocked_ns, (uint64_t)(dispatch_now_ns() - begin));
+        } else if (dispatch->policy == CAPTURE_OVERLOAD_DROP_OLDEST) {
+            // 工作线程交付的是取出时的副本，队首记录可以直接丢弃
+            uint64_t dropped = 0;
+            pthread_mutex_lock(&queue->lock);
+            head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+            while (tail + total - head > queue->size) {
+                const dispatch_record_t* old = (const dispatch_record_t*)(queue->buf + (head & (queue->size - 1)));
+                if (!(old->flags & DISPATCH_RECORD_PAD)) {
+                    dropped++;
+                }
+                head += old->size;
+            }
+            atomic_store_explicit(&queue->head, head, memory_order_relaxed);
+            pthread_mutex_unlock(&queue->lock);
+            capture_counter_add(&counters->dropped_oldest, dropped);
+        } else {
+            capture_counter_add(&counters->dropped_newest, 1);
+            return;
+        }
+    }
+
+    if (contiguous < need) {
+        // 剩余空间放不下整条记录，填充到队列末尾后从头写
+        dispatch_record_t* pad = (dispatch_record_t*)(queue->buf + offset);
+        pad->size = contiguous;
+        pad->flags = DISPATCH_RECORD_PAD;
+        tail += contiguous;
+        offset = 0;
+    }
+
+    dispatch_record_t* record = (dispatch_record_t*)(queue->buf + offset);
+    record->size = need;
+    record->flags = 0;
+    record->meta = *packet;
+    memcpy(record + 1, packet->data, packet->caplen);
+    atomic_store_explicit(&queue->tail, tail + need, memory_order_release);
+}
+
+// 唤醒 mask 中正在等待的工作线程
+static void dispatch_notify(struct dispatch_backend* dispatch, uint64_t mask) {
+    // 入队与读取等待标志之间需要完整屏障，与工作线程的检查配对
+    atomic_thread_fence(memory_order_seq_cst);
+    while (mask) {
+        dispatch_worker_t* worker = &dispatch->workers[__builtin_ctzll(mask)];
+        mask &= mask - 1;
+        if (atomic_load_explicit(&worker->waiting, memory_order_relaxed) &&
+            atomic_exchange(&worker->waiting, false)) {
+            dispatch_wake(worker);
+        }
+    }
+}
+
+static uint32_t dispatch_select(const struct dispatch_backend* dispatch, const packet_t* packet) {
+    return (uint32_t)(((uint64_t)dispatch_flow_hash(packet) * dispatch->worker_count) >> 32);
+}
+
+// 当前接收线程使用的队列序号
+static uint32_t dispatch_producer(const struct dispatch_backend* dispatch) {
+    uint32_t index = capture_rx_index;
+    return index < dispatch->producer_count ? index : index % dispatch->producer_count;
+}
+
+// 内部后端的数据包回调，运行在接收线程上
+static bool dispatch_callback(const packet_t* packet, void* user_data) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)user_data;
+    uint32_t producer = dispatch_producer(dispatch);
+    uint32_t index = dispatch_select(dispatch, packet);
+    dispatch_worker_t* worker = &dispatch->workers[index];
+
+    dispatch_push(dispatch, worker, &worker->queues[producer], &dispatch->producers[producer], packet);
+    dispatch_notify(dispatch, 1ULL << index);
+    return atomic_load_explicit(&dispatch->running, memory_order_relaxed);
+}
+
+// 内部后端的批量回调：整批入队后统一唤醒
+static bool dispatch_batch_callback(const packet_t* packets, uint32_t count, void* user_data) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)user_data;
+    uint32_t producer = dispatch_producer(dispatch);
+    capture_counters_t* counters = &dispatch->producers[producer];
+    uint64_t touched = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = dispatch_select(dispatch, &packets[i]);
+        dispatch_worker_t* worker = &dispatch->workers[index];
+        dispatch_push(dispatch, worker, &worker->queues[producer], counters, &packets[i]);
+        touched |= 1ULL << index;
+    }
+    dispatch_notify(dispatch, touched);
+    return atomic_load_explicit(&dispatch->running, memory_order_relaxed);
+}
+
+// 消费者：从 head 开始取得下一条数据包记录，队列为空返回 NULL
+static const dispatch_record_t* dispatch_peek(dispatch_queue_t* queue, uint64_t* head) {
+    for (;;) {
+        uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (*head == tail) {
+            return NULL;
+        }
+        const dispatch_record_t* record = (const dispatch_record_t*)(queue->buf + (*head & (queue->size - 1)));
+        if (!(record->flags & DISPATCH_RECORD_PAD)) {
+            return record;
+        }
+        *head += record->size;
+    }
+}
+
+// 消费者（DROP_OLDEST）：把最多 max 条记录拷贝出队列后立即释放，
+// 接收线程随时可以丢弃仍在队列中的记录
+static uint32_t dispatch_take(dispatch_worker_t* worker, dispatch_queue_t* queue, packet_t* packets,
+                              uint32_t max, uint64_t* bytes) {
+    uint32_t count = 0;
+    uint32_t used = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    const dispatch_record_t* record;
+    while (count < max && (record = dispatch_peek(queue, &head)) != NULL) {
+        if (used + record->size > queue->size / 2) {
+            break;
+        }
+        dispatch_record_t* copy = (dispatch_record_t*)(worker->scratch + used);
+        memcpy(copy, record, sizeof(*record) + record->meta.caplen);
+        packets[count] = copy->meta;
+        packets[count].data = (const uint8_t*)(copy + 1);
+        *bytes += copy->meta.len;
+        used += record->size;
+        head += record->size;
+        count++;
+    }
+    atomic_store_explicit(&queue->head, head, memory_order_release);
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+// 消费者：释放已交付的记录，BLOCK 策略下唤醒等待空间的接收线程
+static void dispatch_release_to(struct dispatch_backend* dispatch, dispatch_queue_t* queue, uint64_t head) {
+    atomic_store_explicit(&queue->head, head, memory_order_release);
+    if (dispatch->policy == CAPTURE_OVERLOAD_BLOCK) {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&queue->space_waiting, memory_order_relaxed) &&
+            atomic_exchange(&queue->space_waiting, false)) {
+            dispatch_wake_space(queue);
+        }
+    }
+}
+
+// 工作线程的所有队列是否都为空
+static bool dispatch_worker_empty(const dispatch_worker_t* worker) {
+    for (uint32_t i = 0; i < worker->owner->producer_count; i++) {
+        dispatch_queue_t* queue = &worker->queues[i];
+        if (atomic_load_explicit(&queue->tail, memory_order_relaxed) !=
+            atomic_load_explicit(&queue->head, memory_order_relaxed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 没有数据包时等待生产者唤醒；返回 false 表示工作线程应退出
+static bool dispatch_worker_wait(dispatch_worker_t* worker) {
+    struct dispatch_backend* dispatch = worker->owner;
+    struct pollfd pfd = { .fd = worker->wake_fd, .events = POLLIN };
+
+    atomic_store(&worker->waiting, true);
+    atomic_thread_fence(memory_order_seq_cst);
+    bool empty = dispatch_worker_empty(worker);
+    if (empty && atomic_load(&dispatch->input_done)) {
+        atomic_store(&worker->waiting, false);
+        return false;
+    }
+    if (empty && atomic_load_explicit(&dispatch->running, memory_order_relaxed)) {
+        poll(&pfd, 1, -1);
+        uint64_t drain;
+        while (read(worker->wake_fd, &drain, sizeof(drain)) > 0) {
+        }
+    }
+    atomic_store(&worker->waiting, false);
+    return true;
+}
+
+static void* dispatch_worker_thread(void* arg) {
+    dispatch_worker_t* worker = (dispatch_worker_t*)arg;
+    struct dispatch_backend* dispatch = worker->owner;
+    uint32_t burst = dispatch->batch_cb ? dispatch->burst_size : 1;
+    bool copied = dispatch->policy == CAPTURE_OVERLOAD_DROP_OLDEST;
+
+    dispatch_current_worker = (int)worker->index;
+    while (atomic_load_explicit(&dispatch->running, memory_order_relaxed)) {
+        dispatch_queue_t* queue = NULL;
+        uint64_t head = 0;
+        uint32_t count = 0;
+        uint64_t bytes = 0;
+        packet_t single;
+        packet_t* packets = dispatch->batch_cb ? worker->batch : &single;
+
+        // 每批只取一个队列，依次轮换，各接收线程的队列都能得到处理
+        for (uint32_t k = 0; k < dispatch->producer_count && count == 0; k++) {
+            queue = &worker->queues[worker->next_queue];
+            worker->next_queue = worker->next_queue + 1 < dispatch->producer_count ? worker->next_queue + 1 : 0;
+            if (copied) {
+                count = dispatch_take(worker, queue, packets, burst, &bytes);
+                continue;
+            }
+            head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+            const dispatch_record_t* record;
+            while (count < burst && (record = dispatch_peek(queue, &head)) != NULL) {
+                packets[count] = record->meta;
+                packets[count].data = (const uint8_t*)(record + 1);
+                bytes += record->meta.len;
+                head += record->size;
+                count++;
+            }
+            if (count == 0) {
+                // 释放跳过的填充记录
+                dispatch_release_to(dispatch, queue, head);
+            }
+        }
+        if (count == 0) {
+            if (!dispatch_worker_wait(worker)) {
+                break;
+            }
+            continue;
+        }
+
+        bool keep_going = true;
+        if (!atomic_load_explicit(&dispatch->paused, memory_order_relaxed)) {
+            if (dispatch->batch_cb) {
+                capture_counters_batch(&worker->counters, count, bytes);
+                keep_going = dispatch->batch_cb(packets, count, dispatch->user_data);
+            } else {
+                capture_counters_packet(&worker->counters, (uint32_t)bytes);
+                keep_going = dispatch->packet_cb(packets, dispatch->user_data);
+            }
+        }
+        if (!copied) {
+            dispatch_release_to(dispatch, queue, head);
+        }
+        if (!keep_going) {
+            dispatch_stop(dispatch);
+        }
+    }
+    dispatch_current_worker = -1;
+    return NULL;
+}
+
+static int dispatch_run(struct dispatch_backend* dispatch) {
+    clock_gettime(CLOCK_REALTIME, &dispatch->start_time);
+    atomic_store(&dispatch->input_done, false);
+
+    // 先清除内部后端的停止请求再置位自己的运行标志，此后到达的 stop 对内部后端同样生效
+    capture_backend_rearm(dispatch->inner);
+    if (!capture_backend_enter(&dispatch->base, &dispatch->running)) {
+        clock_gettime(CLOCK_REALTIME, &dispatch->end_time);
+        return CAPTURE_SUCCESS;
+    }
+
+    int ret = CAPTURE_SUCCESS;
+    for (uint32_t i = 0; i < dispatch->worker_count; i++) {
+        dispatch_worker_t* worker = &dispatch->workers[i];
+        if (dispatch->batch_cb && !worker->batch) {
+            worker->batch = (packet_t*)malloc(sizeof(packet_t) * dispatch->burst_size);
+            if (!worker->batch) {
+                ret = CAPTURE_ERROR_MEMORY;
+                break;
+            }
+        }
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        capture_affinity_attr(&dispatch->affinity, i, &attr);
+        int err = pthread_create(&worker->thread, &attr, dispatch_worker_thread, worker);
+        pthread_attr_destroy(&attr);
+        if (err != 0) {
+            dispatch->base.error_cb("Failed to create dispatch worker thread", dispatch->base.error_user_data);
+            ret = CAPTURE_ERROR_START_FAILED;
+            break;
+        }
+        worker->has_thread = true;
+    }
+
+    // 接收循环运行在调用者线程上
+    if (ret == CAPTURE_SUCCESS) {
+        capture_backend_t* inner = dispatch->inner;
+        if (inner->ops->start_batch) {
+            ret = inner->ops->start_batch(inner, dispatch_batch_callback, 0, dispatch);
+        } else {
+            ret = inner->ops->start(inner, dispatch_callback, dispatch);
+        }
+    } else {
+        atomic_store(&dispatch->running, false);
+    }
+
+    // 内部后端结束后让工作线程交付完剩余数据包
+    atomic_store(&dispatch->input_done, true);
+    for (uint32_t i = 0; i < dispatch->worker_count; i++) {
+        dispatch_worker_t* worker = &dispatch->workers[i];
+        if (!worker->has_thread) {
+            continue;
+        }
+        dispatch_wake(worker);
+        pthread_join(worker->thread, NULL);
+        worker->has_thread = false;
+
+        // 丢弃被停止时未交付的数据包，便于再次启动
+        uint64_t drain;
+        while (read(worker->wake_fd, &drain, sizeof(drain)) > 0) {
+        }
+        for (uint32_t j = 0; j < dispatch->producer_count; j++) {
+            dispatch_queue_t* queue = &worker->queues[j];
+            atomic_store(&queue->head, atomic_load(&queue->tail));
+            while (read(queue->space_fd, &drain, sizeof(drain)) > 0) {
+            }
+        }
+    }
+
+    atomic_store(&dispatch->running, false);
+    clock_gettime(CLOCK_REALTIME, &dispatch->end_time);
+    return ret;
+}
+
+static void dispatch_release(struct dispatch_backend* dispatch) {
+    for (uint32_t i = 0; dispatch->workers && i < dispatch->worker_count; i++) {
+        dispatch_worker_t* worker = &dispatch->workers[i];
+        for (uint32_t j = 0; worker->queues && j < dispatch->producer_count; j++) {
+            dispatch_queue_t* queue = &worker->queues[j];
+            capture_numa_free(queue->buf, queue->size);
+            if (queue->space_fd >= 0) {
+                close(queue->space_fd);
+            }
+            pthread_mutex_destroy(&queue->lock);
+        }
+        free(worker->queues);
+        free(worker->scratch);
+        free(worker->batch);
+        if (worker->wake_fd >= 0) {
+            close(worker->wake_fd);
+        }
+    }
+    free(dispatch->workers);
+    free(dispatch->producers);
+    capture_affinity_destroy(&dispatch->affinity);
+    if (dispatch->inner) {
+        dispatch->inner->ops->cleanup(dispatch->inner);
+    }
+    free(dispatch);
+}
+
+// 创建按流分发后端
+capture_backend_t* dispatch_backend_create(
+    capture_backend_t* inner,
+    const dispatch_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!inner || !config || !error_cb) {
+        return NULL;
+    }
+    if (config->worker_count == 0 || config->worker_count > DISPATCH_MAX_WORKERS) {
+        error_cb("Worker count must be between 1 and DISPATCH_MAX_WORKERS", error_user_data);
+        return NULL;
+    }
+
+    struct dispatch_backend* dispatch = calloc(1, sizeof(struct dispatch_backend));
+    if (!dispatch) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    dispatch->base.private_data = dispatch;
+    dispatch->base.ops = &dispatch_backend_ops;
+    dispatch->base.type = inner->type;
+    dispatch->base.error_cb = error_cb;
+    dispatch->base.error_user_data = error_user_data;
+
+    // 每个工作线程的队列空间由各接收线程的队列平分
+    uint32_t producer_count = config->producer_count ? config->producer_count : 1;
+    uint32_t queue_bytes = (config->queue_bytes ? config->queue_bytes : DISPATCH_DEFAULT_QUEUE_BYTES) / producer_count;
+    if (queue_bytes < DISPATCH_MIN_QUEUE_BYTES) {
+        queue_bytes = DISPATCH_MIN_QUEUE_BYTES;
+    }
+    uint32_t size = 4096;
+    while (size < queue_bytes && size < (1u << 31)) {
+        size <<= 1;
+    }
+
+    atomic_init(&dispatch->running, false);
+    atomic_init(&dispatch->paused, false);
+    atomic_init(&dispatch->input_done, false);
+
+    // 未指定时保持原来的丢弃新数据包
+    dispatch->policy = config->overload.policy == CAPTURE_OVERLOAD_NONE ? CAPTURE_OVERLOAD_DROP_NEWEST
+                                                                        : config->overload.policy;
+    dispatch->sample_rate = config->overload.sample_rate ? config->overload.sample_rate
+                                                         : CAPTURE_OVERLOAD_DEFAULT_SAMPLE_RATE;
+
+    dispatch->workers = calloc(config->worker_count, sizeof(dispatch_worker_t));
+    dispatch->producers = calloc(producer_count, sizeof(capture_counters_t));
+    int aff_ret = capture_affinity_init(&dispatch->affinity, config->cpus, config->cpu_count,
+                                        config->numa_nodes, true);
+    if (!dispatch->workers || !dispatch->producers || aff_ret != CAPTURE_SUCCESS) {
+        error_cb(aff_ret == CAPTURE_ERROR_INVALID_PARAM ? "Invalid worker CPU placement"
+                                                        : "Failed to allocate dispatch state",
+                 error_user_data);
+        capture_affinity_destroy(&dispatch->affinity);
+        free(dispatch->workers);
+        free(dispatch->producers);
+        free(dispatch);
+        return NULL;
+    }
+    dispatch->worker_count = config->worker_count;
+    dispatch->producer_count = producer_count;
+
+    // 先让所有描述符处于可释放状态，任一步失败都能统一清理
+    for (uint32_t i = 0; i < config->worker_count; i++) {
+        dispatch_worker_t* worker = &dispatch->workers[i];
+        worker->owner = dispatch;
+        worker->index = i;
+        worker->wake_fd = -1;
+        atomic_init(&worker->waiting, false);
+        worker->queues = calloc(producer_count, sizeof(dispatch_queue_t));
+        for (uint32_t j = 0; worker->queues && j < producer_count; j++) {
+            dispatch_queue_t* queue = &worker->queues[j];
+            queue->space_fd = -1;
+            atomic_init(&queue->head, 0);
+            atomic_init(&queue->tail, 0);
+            atomic_init(&queue->space_waiting, false);
+            pthread_mutex_init(&queue->lock, NULL);
+        }
+    }
+
+    for (uint32_t i = 0; i < config->worker_count; i++) {
+        dispatch_worker_t* worker = &dispatch->workers[i];
+        bool ok = worker->queues != NULL;
+        int node = capture_affinity_node(&dispatch->affinity, i);
+        worker->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        ok = ok && worker->wake_fd >= 0;
+        if (ok && dispatch->policy == CAPTURE_OVERLOAD_DROP_OLDEST) {
+            worker->scratch = (uint8_t*)malloc(size / 2);
+            ok = worker->scratch != NULL;
+        }
+        // 队列由工作线程读取，分配在工作线程所在的节点
+        for (uint32_t j = 0; ok && j < producer_count; j++) {
+            dispatch_queue_t* queue = &worker->queues[j];
+            queue->buf = capture_numa_alloc(size, node);
+            queue->size = size;
+            queue->space_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            ok = queue->buf && queue->space_fd >= 0;
+        }
+        if (!ok) {
+            error_cb("Failed to allocate dispatch queue", error_user_data);
+            // 内部后端仍归调用者所有
+            dispatch_release(dispatch);
+            return NULL;
+        }
+    }
+
+    // 全部资源就绪后才接管内部后端
+    dispatch->inner = inner;
+    return &dispatch->base;
+}
+
+// 销毁按流分发后端
+void dispatch_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    dispatch_release((struct dispatch_backend*)backend);
+}
+
+int dispatch_backend_worker_id(void) {
+    return dispatch_current_worker;
+}
+
+static void dispatch_cleanup(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch) {
+        return;
+    }
+    if (atomic_load(&dispatch->running)) {
+        dispatch_stop(dispatch);
+    }
+    dispatch_release(dispatch);
+}
+
+static int dispatch_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    dispatch->packet_cb = callback;
+    dispatch->batch_cb = NULL;
+    dispatch->user_data = user_data;
+    return dispatch_run(dispatch);
+}
+
+static int dispatch_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (burst_size == 0) {
+        burst_size = CAPTURE_DEFAULT_BURST_SIZE;
+    }
+    if (burst_size > CAPTURE_MAX_BURST_SIZE) {
+        burst_size = CAPTURE_MAX_BURST_SIZE;
+    }
+    // 突发大小变化时重新分配交付数组
+    if (burst_size != dispatch->burst_size) {
+        for (uint32_t i = 0; i < dispatch->worker_count; i++) {
+            free(dispatch->workers[i].batch);
+            dispatch->workers[i].batch = NULL;
+        }
+    }
+
+    dispatch->packet_cb = NULL;
+    dispatch->batch_cb = callback;
+    dispatch->burst_size = burst_size;
+    dispatch->user_data = user_data;
+    return dispatch_run(dispatch);
+}
+
+static int dispatch_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch->inner->ops->next_batch) {
+        return -CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+    // 与 dispatch_run 相同：先清除内部后端的停止请求再检查自己的，此后到达的 stop 对内部后端同样生效
+    capture_backend_rearm(dispatch->inner);
+    if (atomic_load(&dispatch->base.stop_requested)) {
+        return 0;
+    }
+    return dispatch->inner->ops->next_batch(dispatch->inner, packets, max, timeout_ms);
+}
+
+static int dispatch_get_fd(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch->inner->ops->get_fd) {
+        return -1;
+    }
+    return dispatch->inner->ops->get_fd(dispatch->inner);
+}
+
+static int dispatch_stop(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&dispatch->base, &dispatch->running);
+    int ret = dispatch->inner->ops->stop(dispatch->inner);
+    for (uint32_t i = 0; i < dispatch->worker_count; i++) {
+        // 同时唤醒等待队列空间的接收线程
+        dispatch_worker_t* worker = &dispatch->workers[i];
+        dispatch_wake(worker);
+        for (uint32_t j = 0; j < dispatch->producer_count; j++) {
+            dispatch_wake_space(&worker->queues[j]);
+        }
+    }
+    return ret;
+}
+
+static int dispatch_pause(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    // 接收线程继续运行并保持队列流动，只是不再交付
+    atomic_store(&dispatch->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int dispatch_resume(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&dispatch->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int dispatch_set_filter(void* backend, const char* filter) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    if (!dispatch->inner->ops->set_filter) {
+        return CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+    return dispatch->inner->ops->set_filter(dispatch->inner, filter);
+}
+
+static int dispatch_get_stats(void* backend, capture_stats_t* stats) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_stats_t inner_stats;
+    memset(&inner_stats, 0, sizeof(inner_stats));
+    if (dispatch->inner->ops->get_stats) {
+        int ret = dispatch->inner->ops->get_stats(dispatch->inner, &inner_stats);
+        if (ret != CAPTURE_SUCCESS) {
+            return ret;
+        }
+    }
+
+    // 接收数据包数以工作线程实际交付的为准，丢包数为内部后端与分发队列之和
+    stats->packets_dropped = inner_stats.packets_dropped;
+    stats->packets_if_dropped = inner_stats.packets_if_dropped;
+    stats->overload_dropped_newest = inner_stats.overload_dropped_newest;
+    stats->overload_dropped_oldest = inner_stats.overload_dropped_oldest;
+    stats->overload_sampled_out = inner_stats.overload_sampled_out;
+    stats->overload_blocked = inner_stats.overload_blocked;
+    stats->overload_blocked_ns = inner_stats.overload_blocked_ns;
+    stats->start_time = dispatch->start_time;
+    stats->end_time = dispatch->end_time;
+    for (uint32_t i = 0; i < dispatch->worker_count; i++) {
+        capture_counters_merge(&dispatch->workers[i].counters, stats);
+    }
+    for (uint32_t i = 0; i < dispatch->producer_count; i++) {
+        capture_counters_merge(&dispatch->producers[i], stats);
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// 内部后端的线程之后依次是各工作线程
+static int dispatch_get_thread_stats(void* backend, capture_thread_stats_t* stats, uint32_t max) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    int ret = capture_backend_thread_stats(dispatch->inner, stats, max);
+    if (ret < 0) {
+        return ret;
+    }
+    uint32_t count = (uint32_t)ret;
+    uint32_t filled = count < max ? count : max;
+
+    // 分发队列的过载计数归到写入队列的线程：内部后端有归并线程时为归并
+    // 线程，否则为同序号的接收线程
+    bool merged = false;
+    for (uint32_t i = 0; i < filled; i++) {
+        merged = merged || stats[i].role == CAPTURE_THREAD_MERGE;
+    }
+    for (uint32_t i = 0; i < filled; i++) {
+        capture_thread_stats_t* entry = &stats[i];
+        if (merged && entry->role == CAPTURE_THREAD_MERGE) {
+            capture_counters_add_overload(&dispatch->producers[0], entry);
+        } else if (!merged && entry->role == CAPTURE_THREAD_RECEIVE && entry->index < dispatch->producer_count) {
+            capture_counters_add_overload(&dispatch->producers[entry->index], entry);
+        }
+    }
+
+    for (uint32_t i = 0; i < dispatch->worker_count; i++, count++) {
+        if (count < max) {
+            capture_counters_read(&dispatch->workers[i].counters, CAPTURE_THREAD_WORKER, i, &stats[count]);
+        }
+    }
+    return (int)count;
+}
+
+static const char* dispatch_get_name(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    return dispatch->inner->ops->get_name ? dispatch->inner->ops->get_name(dispatch->inner) : "dispatch";
+}
+
+static const char* dispatch_get_version(void* backend) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    return dispatch->inner->ops->get_version ? dispatch->inner->ops->get_version(dispatch->inner) : "";
+}
+
+static const char* dispatch_get_description(void* backend) {
+    return "Flow-affine multi-worker dispatch stage";
+}
+
+static bool dispatch_is_feature_supported(void* backend, const char* feature) {
+    struct dispatch_backend* dispatch = (struct dispatch_backend*)backend;
+    if (!dispatch || !feature) {
+        return false;
+    }
+    if (strcmp(feature, "dispatch") == 0 || strcmp(feature, "batch") == 0) {
+        return true;
+    }
+    // 工作线程交付的是队列中的副本，不能零拷贝租用
+    if (strcmp(feature, "lease") == 0) {
+        return false;
+    }
+    capture_backend_t* inner = dispatch->inner;
+    return inner->ops->is_feature_supported && inner->ops->is_feature_supported(inner, feature);
+}
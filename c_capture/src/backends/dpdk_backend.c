@@ -0,0 +1,602 @@
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <rte_cycles.h>
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_version.h>
+#include "../../include/backends/dpdk_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
+
+#define DPDK_MAX_EAL_ARGS 64
+
+// 租用表项
+typedef struct {
+    const uint8_t* data;             // 数据包地址，NULL 表示空槽
+    struct rte_mbuf* mbuf;           // 被租用的 mbuf
+} dpdk_lease_entry_t;
+
+struct dpdk_backend {
+    capture_backend_t base;          // 基础后端结构
+    uint16_t port_id;                // 端口号
+    uint16_t queue_id;               // 接收队列
+    uint16_t burst_size;             // 单次收包最大数量
+    bool port_started;               // 端口是否已启动
+    struct rte_mempool* pool;        // mbuf 池
+    struct rte_mbuf** burst;         // 收包数组
+    packet_t* packets;               // 与 burst 对应的数据包描述
+    uint16_t burst_count;            // burst 中正在交付的 mbuf 数
+    packet_callback_t packet_cb;     // 数据包回调
+    packet_batch_callback_t batch_cb; // 批量数据包回调
+    uint32_t batch_burst;            // 批量回调每次交付的最大数据包数
+    uint16_t pull_pending;           // 拉取模式下已借出、尚未归还的 mbuf 数
+    void* user_data;                 // 用户数据
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    capture_counters_t counters;     // 交付计数
+    pthread_mutex_t lease_lock;      // 保护租用表
+    dpdk_lease_entry_t* leases;      // 租用表：数据地址到 mbuf 的开放寻址散列表
+    uint32_t lease_mask;             // 租用表容量减 1
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// EAL 在进程内只能初始化一次
+static bool dpdk_eal_initialized = false;
+
+// 内部函数声明
+static void dpdk_cleanup(void* backend);
+static int dpdk_start(void* backend, packet_callback_t callback, void* user_data);
+static int dpdk_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
+static int dpdk_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+static int dpdk_lease(void* backend, const packet_t* packet);
+static void dpdk_release_packet(void* backend, const packet_t* packet);
+static int dpdk_stop(void* backend);
+static int dpdk_pause(void* backend);
+static int dpdk_resume(void* backend);
+static int dpdk_get_stats(void* backend, capture_stats_t* stats);
+static const char* dpdk_get_name(void* backend);
+static const char* dpdk_get_version(void* backend);
+static const char* dpdk_get_description(void* backend);
+static bool dpdk_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t dpdk_backend_ops = {
+    .cleanup = dpdk_cleanup,
+    .start = dpdk_start,
+    .start_batch = dpdk_start_batch,
+    .next_batch = dpdk_next_batch,
+    .lease = dpdk_lease,
+    .release = dpdk_release_packet,
+    .stop = dpdk_stop,
+    .pause = dpdk_pause,
+    .resume = dpdk_resume,
+    .get_stats = dpdk_get_stats,
+    .get_name = dpdk_get_name,
+    .get_version = dpdk_get_version,
+    .get_description = dpdk_get_description,
+    .is_feature_supported = dpdk_is_feature_supported,
+};
+
+static void dpdk_report(struct dpdk_backend* backend, const char* what, int err) {
+    char msg[256];
+    snprintf(msg, sizeof(msg), "%s: %s", what, rte_strerror(err < 0 ? -err : err));
+    backend->base.error_cb(msg, backend->base.error_user_data);
+}
+
+// 将空格分隔的参数串拆成 argv 后初始化 EAL
+static int dpdk_eal_init(struct dpdk_backend* backend, const char* eal_args) {
+    if (dpdk_eal_initialized) {
+        return CAPTURE_SUCCESS;
+    }
+
+    char* args = strdup(eal_args ? eal_args : "");
+    if (!args) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+
+    char* argv[DPDK_MAX_EAL_ARGS + 1];
+    int argc = 0;
+    argv[argc++] = "c_capture";
+    for (char* save = NULL, *tok = strtok_r(args, " \t", &save);
+         tok && argc < DPDK_MAX_EAL_ARGS;
+         tok = strtok_r(NULL, " \t", &save)) {
+        argv[argc++] = tok;
+    }
+    argv[argc] = NULL;
+
+    // rte_eal_init 会保留 argv 中的指针，args 在进程生命周期内不释放
+    int ret = rte_eal_init(argc, argv);
+    if (ret < 0) {
+        dpdk_report(backend, "rte_eal_init", rte_errno);
+        free(args);
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+
+    dpdk_eal_initialized = true;
+    return CAPTURE_SUCCESS;
+}
+
+static void dpdk_release(struct dpdk_backend* backend) {
+    if (backend->port_started) {
+        rte_eth_dev_stop(backend->port_id);
+        rte_eth_dev_close(backend->port_id);
+    }
+    if (backend->pool) {
+        rte_mempool_free(backend->pool);
+    }
+    free(backend->burst);
+    free(backend->packets);
+    free(backend->leases);
+    pthread_mutex_destroy(&backend->lease_lock);
+    free(backend);
+}
+
+// 创建 DPDK 后端
+capture_backend_t* dpdk_backend_create(
+    const dpdk_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !error_cb) {
+        return NULL;
+    }
+
+    struct dpdk_backend* backend = calloc(1, sizeof(struct dpdk_backend));
+    if (!backend) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    backend->base.private_data = backend;
+    backend->base.ops = &dpdk_backend_ops;
+    backend->base.type = CAPTURE_BACKEND_DPDK;
+    backend->base.error_cb = error_cb;
+    backend->base.error_user_data = error_user_data;
+    pthread_mutex_init(&backend->lease_lock, NULL);
+
+    backend->port_id = config->port_id;
+    backend->queue_id = config->queue_id;
+    backend->burst_size = config->burst_size ? config->burst_size : DPDK_DEFAULT_BURST_SIZE;
+    atomic_init(&backend->running, false);
+    atomic_init(&backend->paused, false);
+
+    backend->burst = calloc(backend->burst_size, sizeof(struct rte_mbuf*));
+    backend->packets = calloc(backend->burst_size, sizeof(packet_t));
+    if (!backend->burst || !backend->packets) {
+        dpdk_release(backend);
+        return NULL;
+    }
+
+    if (dpdk_eal_init(backend, config->eal_args) != CAPTURE_SUCCESS) {
+        dpdk_release(backend);
+        return NULL;
+    }
+
+    if (config->device) {
+        int ret = rte_eth_dev_get_port_by_name(config->device, &backend->port_id);
+        if (ret != 0) {
+            dpdk_report(backend, config->device, ret);
+            dpdk_release(backend);
+            return NULL;
+        }
+    }
+    if (!rte_eth_dev_is_valid_port(backend->port_id)) {
+        error_cb("Invalid DPDK port", error_user_data);
+        dpdk_release(backend);
+        return NULL;
+    }
+
+    int socket_id = rte_eth_dev_socket_id(backend->port_id);
+    if (socket_id < 0) {
+        socket_id = (int)rte_socket_id();
+    }
+
+    char pool_name[RTE_MEMPOOL_NAMESIZE];
+    snprintf(pool_name, sizeof(pool_name), "capture_p%u_q%u", backend->port_id, backend->queue_id);
+    backend->pool = rte_pktmbuf_pool_create(
+        pool_name,
+        config->mempool_size ? config->mempool_size : DPDK_DEFAULT_MEMPOOL_SIZE,
+        config->mempool_cache ? config->mempool_cache : DPDK_DEFAULT_MEMPOOL_CACHE,
+        0,
+        RTE_MBUF_DEFAULT_BUF_SIZE,
+        socket_id);
+    if (!backend->pool) {
+        dpdk_report(backend, "rte_pktmbuf_pool_create", rte_errno);
+        dpdk_release(backend);
+        return NULL;
+    }
+
+    // 最坏情况下池中所有 mbuf 都被租用，表容量取其两倍以上
+    uint32_t lease_cap = 64;
+    while (lease_cap < 2 * (config->mempool_size ? config->mempool_size : DPDK_DEFAULT_MEMPOOL_SIZE)) {
+        lease_cap <<= 1;
+    }
+    backend->leases = calloc(lease_cap, sizeof(dpdk_lease_entry_t));
+    if (!backend->leases) {
+        dpdk_release(backend);
+        return NULL;
+    }
+    backend->lease_mask = lease_cap - 1;
+
+    // 只收包，但部分 PMD 要求至少一个发送队列
+    struct rte_eth_conf port_conf;
+    memset(&port_conf, 0, sizeof(port_conf));
+    uint16_t nb_rxq = backend->queue_id + 1;
+    int ret = rte_eth_dev_configure(backend->port_id, nb_rxq, 1, &port_conf);
+    if (ret != 0) {
+        dpdk_report(backend, "rte_eth_dev_configure", ret);
+        dpdk_release(backend);
+        return NULL;
+    }
+
+    uint16_t rx_desc = config->rx_desc ? config->rx_desc : DPDK_DEFAULT_RX_DESC;
+    uint16_t tx_desc = 512;
+    rte_eth_dev_adjust_nb_rx_tx_desc(backend->port_id, &rx_desc, &tx_desc);
+
+    for (uint16_t q = 0; q < nb_rxq; q++) {
+        ret = rte_eth_rx_queue_setup(backend->port_id, q, rx_desc, (unsigned int)socket_id, NULL, backend->pool);
+        if (ret != 0) {
+            dpdk_report(backend, "rte_eth_rx_queue_setup", ret);
+            dpdk_release(backend);
+            return NULL;
+        }
+    }
+
+    ret = rte_eth_tx_queue_setup(backend->port_id, 0, tx_desc, (unsigned int)socket_id, NULL);
+    if (ret != 0) {
+        dpdk_report(backend, "rte_eth_tx_queue_setup", ret);
+        dpdk_release(backend);
+        return NULL;
+    }
+
+    ret = rte_eth_dev_start(backend->port_id);
+    if (ret != 0) {
+        dpdk_report(backend, "rte_eth_dev_start", ret);
+        dpdk_release(backend);
+        return NULL;
+    }
+    backend->port_started = true;
+
+    if (config->promiscuous) {
+        // 虚拟 PMD 可能不支持混杂模式，失败不视为错误
+        rte_eth_promiscuous_enable(backend->port_id);
+    }
+
+    return &backend->base;
+}
+
+// 销毁 DPDK 后端
+void dpdk_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    dpdk_release((struct dpdk_backend*)backend);
+}
+
+static void dpdk_cleanup(void* backend) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk) {
+        return;
+    }
+    if (atomic_load(&dpdk->running)) {
+        dpdk_stop(dpdk);
+    }
+    dpdk_release(dpdk);
+}
+
+// 为一次 rx burst 收到的 mbuf 填写数据包描述，返回总字节数
+static uint64_t dpdk_fill(struct dpdk_backend* dpdk, uint16_t nb, packet_t* packets) {
+    dpdk->burst_count = nb;
+    uint64_t bytes = 0;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    for (uint16_t i = 0; i < nb; i++) {
+        struct rte_mbuf* m = dpdk->burst[i];
+        packet_t* pkt = &packets[i];
+
+        // 多段 mbuf 只交付第一段，caplen 反映实际可访问的长度
+        pkt->data = rte_pktmbuf_mtod(m, const uint8_t*);
+        pkt->len = rte_pktmbuf_pkt_len(m);
+        pkt->caplen = rte_pktmbuf_data_len(m);
+        pkt->ts = ts;
+        pkt->if_index = 0;
+        pkt->device_index = 0;
+        pkt->flags = 0;
+        pkt->protocol = 0;
+        pkt->vlan_tci = (m->ol_flags & RTE_MBUF_F_RX_VLAN_STRIPPED) ? m->vlan_tci : 0;
+        // 网卡的 RSS 哈希一般不对称，由解码器重新计算
+        packet_decode(pkt, PACKET_LINKTYPE_ETHERNET);
+        bytes += pkt->len;
+    }
+    return bytes;
+}
+
+// 交付一次 rx burst 中已填好的数据包描述，返回 false 表示回调要求停止
+static bool dpdk_deliver(struct dpdk_backend* dpdk, uint16_t nb) {
+    if (dpdk->batch_cb) {
+        // packets 数组直接作为批量回调的参数，无需拷贝
+        for (uint16_t off = 0; off < nb; off += dpdk->batch_burst) {
+            uint16_t n = nb - off < dpdk->batch_burst ? nb - off : dpdk->batch_burst;
+            uint64_t bytes = 0;
+            for (uint16_t i = off; i < off + n; i++) {
+                bytes += dpdk->packets[i].len;
+            }
+            capture_counters_batch(&dpdk->counters, n, bytes);
+            if (!dpdk->batch_cb(&dpdk->packets[off], n, dpdk->user_data)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    for (uint16_t i = 0; i < nb; i++) {
+        capture_counters_packet(&dpdk->counters, dpdk->packets[i].len);
+        if (!dpdk->packet_cb(&dpdk->packets[i], dpdk->user_data)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 归还拉取模式下借出的 mbuf
+static void dpdk_pull_release(struct dpdk_backend* dpdk) {
+    if (dpdk->pull_pending) {
+        rte_pktmbuf_free_bulk(dpdk->burst, dpdk->pull_pending);
+        dpdk->pull_pending = 0;
+        dpdk->burst_count = 0;
+    }
+}
+
+// 拉取模式：DPDK 没有可等待的描述符，超时内忙轮询，mbuf 在下一次调用时归还
+static int dpdk_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk || !packets || max == 0) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (dpdk->start_time.tv_sec == 0) {
+        clock_gettime(CLOCK_REALTIME, &dpdk->start_time);
+    }
+
+    dpdk_pull_release(dpdk);
+
+    uint16_t want = max < dpdk->burst_size ? (uint16_t)max : dpdk->burst_size;
+    uint64_t deadline = 0;
+    if (timeout_ms > 0) {
+        deadline = rte_get_timer_cycles() + rte_get_timer_hz() * (uint64_t)timeout_ms / 1000;
+    }
+
+    // stop 置位停止请求以打断等待，请求由下一次 capture_next_batch 清除
+    for (;;) {
+        uint16_t nb = rte_eth_rx_burst(dpdk->port_id, dpdk->queue_id, dpdk->burst, want);
+        if (nb > 0) {
+            if (atomic_load_explicit(&dpdk->paused, memory_order_relaxed)) {
+                rte_pktmbuf_free_bulk(dpdk->burst, nb);
+                return 0;
+            }
+            capture_counters_batch(&dpdk->counters, nb, dpdk_fill(dpdk, nb, packets));
+            dpdk->pull_pending = nb;
+            return nb;
+        }
+        if (timeout_ms == 0 || atomic_load_explicit(&dpdk->base.stop_requested, memory_order_relaxed) ||
+            (timeout_ms > 0 && rte_get_timer_cycles() >= deadline)) {
+            return 0;
+        }
+    }
+}
+
+static uint32_t dpdk_lease_slot(const struct dpdk_backend* dpdk, const uint8_t* data) {
+    uint64_t key = (uint64_t)(uintptr_t)data;
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & dpdk->lease_mask;
+}
+
+// 租用当前 burst 中的数据包：增加 mbuf 引用计数并记录在租用表中
+static int dpdk_lease(void* backend, const packet_t* packet) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    struct rte_mbuf* m = NULL;
+    for (uint16_t i = 0; i < dpdk->burst_count; i++) {
+        if (rte_pktmbuf_mtod(dpdk->burst[i], const uint8_t*) == packet->data) {
+            m = dpdk->burst[i];
+            break;
+        }
+    }
+    if (!m) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    rte_mbuf_refcnt_update(m, 1);
+    pthread_mutex_lock(&dpdk->lease_lock);
+    uint32_t slot = dpdk_lease_slot(dpdk, packet->data);
+    while (dpdk->leases[slot].data) {
+        slot = (slot + 1) & dpdk->lease_mask;
+    }
+    dpdk->leases[slot].data = packet->data;
+    dpdk->leases[slot].mbuf = m;
+    pthread_mutex_unlock(&dpdk->lease_lock);
+    return CAPTURE_SUCCESS;
+}
+
+// 归还租用的数据包，线性探测表采用后移删除，不留墓碑
+static void dpdk_release_packet(void* backend, const packet_t* packet) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk) {
+        return;
+    }
+
+    struct rte_mbuf* m = NULL;
+    pthread_mutex_lock(&dpdk->lease_lock);
+    uint32_t slot = dpdk_lease_slot(dpdk, packet->data);
+    while (dpdk->leases[slot].data && dpdk->leases[slot].data != packet->data) {
+        slot = (slot + 1) & dpdk->lease_mask;
+    }
+    if (dpdk->leases[slot].data) {
+        m = dpdk->leases[slot].mbuf;
+        uint32_t hole = slot;
+        for (uint32_t next = (hole + 1) & dpdk->lease_mask; dpdk->leases[next].data;
+             next = (next + 1) & dpdk->lease_mask) {
+            uint32_t home = dpdk_lease_slot(dpdk, dpdk->leases[next].data);
+            // home 不在 (hole, next] 区间内时该项可以前移填补空洞
+            if (((next - home) & dpdk->lease_mask) >= ((next - hole) & dpdk->lease_mask)) {
+                dpdk->leases[hole] = dpdk->leases[next];
+                hole = next;
+            }
+        }
+        dpdk->leases[hole].data = NULL;
+        dpdk->leases[hole].mbuf = NULL;
+    }
+    pthread_mutex_unlock(&dpdk->lease_lock);
+
+    if (m) {
+        rte_pktmbuf_free(m);
+    }
+}
+
+// 忙轮询接收循环
+static int dpdk_run(struct dpdk_backend* dpdk) {
+    dpdk_pull_release(dpdk);
+
+    clock_gettime(CLOCK_REALTIME, &dpdk->start_time);
+    capture_backend_enter(&dpdk->base, &dpdk->running);
+
+    // DPDK 采用忙轮询，stop 只需清除运行标志
+    while (atomic_load_explicit(&dpdk->running, memory_order_relaxed)) {
+        uint16_t nb = rte_eth_rx_burst(dpdk->port_id, dpdk->queue_id, dpdk->burst, dpdk->burst_size);
+        if (nb == 0) {
+            continue;
+        }
+
+        if (atomic_load_explicit(&dpdk->paused, memory_order_relaxed)) {
+            rte_pktmbuf_free_bulk(dpdk->burst, nb);
+            continue;
+        }
+
+        dpdk_fill(dpdk, nb, dpdk->packets);
+
+        bool keep_going = dpdk_deliver(dpdk, nb);
+
+        // 整批处理完后批量归还 mbuf，被租用的 mbuf 因引用计数保留到 release
+        rte_pktmbuf_free_bulk(dpdk->burst, nb);
+        dpdk->burst_count = 0;
+
+        if (!keep_going) {
+            atomic_store(&dpdk->running, false);
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &dpdk->end_time);
+    return CAPTURE_SUCCESS;
+}
+
+static int dpdk_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    dpdk->packet_cb = callback;
+    dpdk->batch_cb = NULL;
+    dpdk->user_data = user_data;
+    return dpdk_run(dpdk);
+}
+
+static int dpdk_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (burst_size == 0) {
+        burst_size = CAPTURE_DEFAULT_BURST_SIZE;
+    }
+    dpdk->packet_cb = NULL;
+    dpdk->batch_cb = callback;
+    dpdk->batch_burst = burst_size < dpdk->burst_size ? burst_size : dpdk->burst_size;
+    dpdk->user_data = user_data;
+    return dpdk_run(dpdk);
+}
+
+static int dpdk_stop(void* backend) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    capture_backend_request_stop(&dpdk->base, &dpdk->running);
+    return CAPTURE_SUCCESS;
+}
+
+static int dpdk_pause(void* backend) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&dpdk->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int dpdk_resume(void* backend) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&dpdk->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int dpdk_get_stats(void* backend, capture_stats_t* stats) {
+    struct dpdk_backend* dpdk = (struct dpdk_backend*)backend;
+    if (!dpdk || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    struct rte_eth_stats eth_stats;
+    int ret = rte_eth_stats_get(dpdk->port_id, &eth_stats);
+    if (ret != 0) {
+        dpdk_report(dpdk, "rte_eth_stats_get", ret);
+        return CAPTURE_ERROR_GET_STATS;
+    }
+
+    stats->packets_dropped = eth_stats.imissed + eth_stats.rx_nombuf;
+    stats->packets_if_dropped = eth_stats.ierrors;
+    stats->start_time = dpdk->start_time;
+    stats->end_time = dpdk->end_time;
+    capture_counters_merge(&dpdk->counters, stats);
+    return CAPTURE_SUCCESS;
+}
+
+static const char* dpdk_get_name(void* backend) {
+    return "dpdk";
+}
+
+static const char* dpdk_get_version(void* backend) {
+    return rte_version();
+}
+
+static const char* dpdk_get_description(void* backend) {
+    return "DPDK poll-mode driver backend";
+}
+
+static bool dpdk_is_feature_supported(void* backend, const char* feature) {
+    if (!feature) {
+        return false;
+    }
+    return strcmp(feature, "zero_copy") == 0 ||
+           strcmp(feature, "kernel_bypass") == 0 ||
+           strcmp(feature, "rx_hash") == 0 ||
+           strcmp(feature, "batch") == 0 ||
+           strcmp(feature, "lease") == 0;
+}
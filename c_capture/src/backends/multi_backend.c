@@ -0,0 +1,827 @@
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <stdatomic.h>
+#include "../../include/backends/multi_backend.h"
+#include "../../include/capture_types.h"
+
+#define NSEC_PER_SEC 1000000000LL
+#define MULTI_RECORD_ALIGN 8
+#define MULTI_RECORD_PAD   1  // 队列末尾的回绕填充记录
+
+// 队列中的一条记录，数据包内容紧随其后
+typedef struct {
+    uint32_t size;                   // 记录总长度（含头部，按 8 字节对齐）
+    uint32_t flags;                  // 记录标志
+    int64_t enqueue_ns;              // 入队时间（单调时钟）
+    packet_t meta;                   // 数据包元数据
+} multi_record_t;
+
+struct multi_backend;
+
+struct multi_member;
+
+// 成员的一个接收线程到归并线程的单生产者单消费者队列
+typedef struct {
+    struct multi_member* member;     // 所属成员
+    uint32_t rx_index;               // 成员内的接收线程序号
+    uint8_t* buf;                    // 队列缓冲区
+    uint32_t size;                   // 队列大小（2 的幂）
+    int space_fd;                    // BLOCK 策略下唤醒接收线程的 eventfd
+    pthread_mutex_t lock;            // DROP_OLDEST：保护两端对 head 的修改
+    uint8_t* staged;                 // DROP_OLDEST：已取出待归并的队首记录副本
+    bool has_staged;                 // staged 中是否有记录
+    _Alignas(64) atomic_uint_fast64_t head; // 消费位置
+    _Alignas(64) atomic_uint_fast64_t tail; // 生产位置
+    atomic_bool space_waiting;       // 接收线程是否在等待队列空间
+    uint64_t seen_tail;              // 归并线程最近一次选择时看到的生产位置
+    uint64_t sample_seq;             // 过载采样计数
+    capture_counters_t counters;     // 写入队列时的过载计数，只由接收线程写入
+} multi_queue_t;
+
+// 一个成员后端
+typedef struct multi_member {
+    struct multi_backend* owner;     // 所属聚合后端
+    capture_backend_t* backend;      // 成员后端
+    uint32_t index;                  // 成员序号
+    pthread_t thread;                // 抓包线程
+    bool has_thread;                 // 是否创建了抓包线程
+    int result;                      // 成员 start 的返回值
+    multi_queue_t* queues;           // 该成员各接收线程的队列
+    atomic_bool done;                // 成员 start 是否已返回
+} multi_member_t;
+
+struct multi_backend {
+    capture_backend_t base;          // 基础后端结构
+    multi_member_t* members;         // 成员数组
+    uint32_t member_count;           // 成员数量
+    multi_queue_t* queues;           // 所有队列，第 i 个成员的队列从 i * rx_threads 开始
+    uint32_t queue_count;            // 队列数量
+    uint32_t rx_threads;             // 每个成员的接收线程数
+    char* filter;                    // 各成员当前的过滤器
+    int64_t merge_window_ns;         // 排序窗口
+    capture_overload_policy_t policy; // 队列满时的过载策略
+    uint32_t sample_rate;            // SAMPLE 策略每 sample_rate 个保留 1 个
+    capture_affinity_t affinity;     // 成员抓包线程放置
+    int wake_fd;                     // 唤醒归并线程的 eventfd
+    atomic_bool merge_waiting;       // 归并线程是否正在等待
+    packet_callback_t packet_cb;     // 数据包回调
+    void* user_data;                 // 用户数据
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    capture_counters_t counters;     // 交付计数，只由归并线程写入
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// 内部函数声明
+static void multi_cleanup(void* backend);
+static int multi_start(void* backend, packet_callback_t callback, void* user_data);
+static int multi_stop(void* backend);
+static int multi_pause(void* backend);
+static int multi_resume(void* backend);
+static int multi_set_filter(void* backend, const char* filter);
+static int multi_get_stats(void* backend, capture_stats_t* stats);
+static int multi_get_thread_stats(void* backend, capture_thread_stats_t* stats, uint32_t max);
+static const char* multi_get_name(void* backend);
+static const char* multi_get_version(void* backend);
+static const char* multi_get_description(void* backend);
+static bool multi_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t multi_backend_ops = {
+    .cleanup = multi_cleanup,
+    .start = multi_start,
+    .stop = multi_stop,
+    .pause = multi_pause,
+    .resume = multi_resume,
+    .set_filter = multi_set_filter,
+    .get_stats = multi_get_stats,
+    .get_thread_stats = multi_get_thread_stats,
+    .get_name = multi_get_name,
+    .get_version = multi_get_version,
+    .get_description = multi_get_description,
+    .is_feature_supported = multi_is_feature_supported,
+};
+
+static int64_t multi_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+static int multi_ts_cmp(const struct timespec* a, const struct timespec* b) {
+    if (a->tv_sec != b->tv_sec) {
+        return a->tv_sec < b->tv_sec ? -1 : 1;
+    }
+    if (a->tv_nsec != b->tv_nsec) {
+        return a->tv_nsec < b->tv_nsec ? -1 : 1;
+    }
+    return 0;
+}
+
+static void multi_wake(struct multi_backend* multi) {
+    uint64_t one = 1;
+    if (write(multi->wake_fd, &one, sizeof(one)) < 0) {
+        // eventfd 计数已满时归并线程必然处于可唤醒状态
+    }
+}
+
+static void multi_wake_space(multi_queue_t* queue) {
+    uint64_t one = 1;
+    if (write(queue->space_fd, &one, sizeof(one)) < 0) {
+        // eventfd 计数已满时接收线程必然处于可唤醒状态
+    }
+}
+
+// 唤醒正在等待的归并线程
+static void multi_notify(struct multi_backend* multi) {
+    // 入队与读取等待标志之间需要完整屏障，与归并线程的检查配对
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&multi->merge_waiting, memory_order_relaxed) &&
+        atomic_exchange(&multi->merge_waiting, false)) {
+        multi_wake(multi);
+    }
+}
+
+// BLOCK 策略：等待归并线程腾出空间；返回 false 表示已停止
+static bool multi_wait_space(multi_queue_t* queue, uint64_t need) {
+    struct multi_backend* multi = queue->member->owner;
+    struct pollfd pfd = { .fd = queue->space_fd, .events = POLLIN };
+
+    atomic_store(&queue->space_waiting, true);
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t used = atomic_load_explicit(&queue->tail, memory_order_relaxed) -
+                    atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (used + need > queue->size && atomic_load_explicit(&multi->running, memory_order_relaxed)) {
+        poll(&pfd, 1, -1);
+        uint64_t drain;
+        while (read(queue->space_fd, &drain, sizeof(drain)) > 0) {
+        }
+    }
+    atomic_store(&queue->space_waiting, false);
+    return atomic_load_explicit(&multi->running, memory_order_relaxed);
+}
+
+// 生产者：把数据包拷贝进接收线程的队列，队列满时按过载策略处理
+static void multi_push(multi_queue_t* queue, const packet_t* packet) {
+    struct multi_backend* multi = queue->member->owner;
+    capture_counters_t* counters = &queue->counters;
+    uint32_t need = (uint32_t)((sizeof(multi_record_t) + packet->caplen + MULTI_RECORD_ALIGN - 1) &
+                               ~(size_t)(MULTI_RECORD_ALIGN - 1));
+    if (need > queue->size / 2) {
+        capture_counter_add(&counters->dropped_newest, 1);
+        return;
+    }
+
+    uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    // 队列超过一半时确定性地按 1/N 采样
+    if (multi->policy == CAPTURE_OVERLOAD_SAMPLE && tail - head > queue->size / 2 &&
+        queue->sample_seq++ % multi->sample_rate != 0) {
+        capture_counter_add(&counters->sampled_out, 1);
+        return;
+    }
+
+    uint32_t offset = (uint32_t)(tail & (queue->size - 1));
+    uint32_t contiguous = queue->size - offset;
+    uint64_t total = contiguous < need ? (uint64_t)contiguous + need : need;
+
+    if (tail + total - head > queue->size) {
+        if (multi->policy == CAPTURE_OVERLOAD_BLOCK) {
+            int64_t begin = multi_now_ns();
+            capture_counter_add(&counters->blocked, 1);
+            multi_notify(multi);
+            do {
+                if (!multi_wait_space(queue, total)) {
+                    capture_counter_add(&counters->blocked_ns, (uint64_t)(multi_now_ns() - begin));
+                    capture_counter_add(&counters->dropped_newest, 1);
+                    return;
+                }
+                head = atomic_load_explicit(&queue->head, memory_order_acquire);
+            } while (tail + total - head > queue->size);
+            capture_counter_add(&counters->blocked_ns, (uint64_t)(multi_now_ns() - begin));
+        } else if (multi->policy == CAPTURE_OVERLOAD_DROP_OLDEST) {
+            // 归并线程使用的是取出时的副本，队首记录可以直接丢弃
+            uint64_t dropped = 0;
+            pthread_mutex_lock(&queue->lock);
+            head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+            while (tail + total - head > queue->size) {
+                const multi_record_t* old = (const multi_record_t*)(queue->buf + (head & (queue->size - 1)));
+                if (!(old->flags & MULTI_RECORD_PAD)) {
+                    dropped++;
+                }
+                head += old->size;
+            }
+            atomic_store_explicit(&queue->head, head, memory_order_relaxed);
+            pthread_mutex_unlock(&queue->lock);
+            capture_counter_add(&counters->dropped_oldest, dropped);
+        } else {
+            capture_counter_add(&counters->dropped_newest, 1);
+            return;
+        }
+    }
+
+    if (contiguous < need) {
+        // 剩余空间放不下整条记录，填充到队列末尾后从头写
+        multi_record_t* pad = (multi_record_t*)(queue->buf + offset);
+        pad->size = contiguous;
+        pad->flags = MULTI_RECORD_PAD;
+        tail += contiguous;
+        offset = 0;
+    }
+
+    multi_record_t* record = (multi_record_t*)(queue->buf + offset);
+    record->size = need;
+    record->flags = 0;
+    record->enqueue_ns = multi_now_ns();
+    record->meta = *packet;
+    memcpy(record + 1, packet->data, packet->caplen);
+    atomic_store_explicit(&queue->tail, tail + need, memory_order_release);
+}
+
+// 消费者（DROP_OLDEST）：把队首记录拷贝出队列后立即释放，
+// 接收线程随时可以丢弃仍在队列中的记录
+static const multi_record_t* multi_stage(multi_queue_t* queue) {
+    if (queue->has_staged) {
+        return (const multi_record_t*)queue->staged;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    const multi_record_t* record = NULL;
+    while (head != tail) {
+        record = (const multi_record_t*)(queue->buf + (head & (queue->size - 1)));
+        head += record->size;
+        if (!(record->flags & MULTI_RECORD_PAD)) {
+            memcpy(queue->staged, record, sizeof(*record) + record->meta.caplen);
+            queue->has_staged = true;
+            break;
+        }
+    }
+    atomic_store_explicit(&queue->head, head, memory_order_release);
+    pthread_mutex_unlock(&queue->lock);
+    return queue->has_staged ? (const multi_record_t*)queue->staged : NULL;
+}
+
+// 消费者：取得队首记录，队列为空返回 NULL
+static const multi_record_t* multi_peek(multi_queue_t* queue) {
+    if (queue->member->owner->policy == CAPTURE_OVERLOAD_DROP_OLDEST) {
+        return multi_stage(queue);
+    }
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    for (;;) {
+        uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head == tail) {
+            return NULL;
+        }
+        const multi_record_t* record = (const multi_record_t*)(queue->buf + (head & (queue->size - 1)));
+        if (!(record->flags & MULTI_RECORD_PAD)) {
+            return record;
+        }
+        head += record->size;
+        atomic_store_explicit(&queue->head, head, memory_order_release);
+    }
+}
+
+static void multi_pop(multi_queue_t* queue, const multi_record_t* record) {
+    if (queue->has_staged) {
+        queue->has_staged = false;
+        return;
+    }
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    atomic_store_explicit(&queue->head, head + record->size, memory_order_release);
+    if (queue->member->owner->policy == CAPTURE_OVERLOAD_BLOCK) {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&queue->space_waiting, memory_order_relaxed) &&
+            atomic_exchange(&queue->space_waiting, false)) {
+            multi_wake_space(queue);
+        }
+    }
+}
+
+// 成员后端的数据包回调，运行在成员的接收线程上
+static bool multi_member_callback(const packet_t* packet, void* user_data) {
+    multi_member_t* member = (multi_member_t*)user_data;
+    struct multi_backend* multi = member->owner;
+    uint32_t rx = capture_rx_index;
+
+    multi_push(&member->queues[rx < multi->rx_threads ? rx : rx % multi->rx_threads], packet);
+    multi_notify(multi);
+    return atomic_load_explicit(&multi->running, memory_order_relaxed);
+}
+
+static void* multi_member_thread(void* arg) {
+    multi_member_t* member = (multi_member_t*)arg;
+    capture_backend_t* backend = member->backend;
+
+    member->result = backend->ops->start(backend, multi_member_callback, member);
+    atomic_store(&member->done, true);
+    multi_wake(member->owner);
+    return NULL;
+}
+
+// 唤醒成员所有等待队列空间的接收线程
+static void multi_wake_member(multi_member_t* member) {
+    for (uint32_t j = 0; j < member->owner->rx_threads; j++) {
+        multi_wake_space(&member->queues[j]);
+    }
+}
+
+static void multi_release(struct multi_backend* multi) {
+    for (uint32_t i = 0; multi->members && i < multi->member_count; i++) {
+        multi_member_t* member = &multi->members[i];
+        if (member->backend) {
+            member->backend->ops->cleanup(member->backend);
+        }
+    }
+    for (uint32_t i = 0; multi->queues && i < multi->queue_count; i++) {
+        multi_queue_t* queue = &multi->queues[i];
+        capture_numa_free(queue->buf, queue->size);
+        if (queue->space_fd >= 0) {
+            close(queue->space_fd);
+        }
+        free(queue->staged);
+        pthread_mutex_destroy(&queue->lock);
+    }
+    free(multi->queues);
+    free(multi->members);
+    free(multi->filter);
+    capture_affinity_destroy(&multi->affinity);
+    if (multi->wake_fd >= 0) {
+        close(multi->wake_fd);
+    }
+    free(multi);
+}
+
+// 创建多设备聚合后端
+capture_backend_t* multi_backend_create(
+    capture_backend_t** members,
+    uint32_t count,
+    const multi_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!members || count == 0 || !error_cb) {
+        return NULL;
+    }
+    if (count > MULTI_MAX_MEMBERS) {
+        error_cb("Member count exceeds MULTI_MAX_MEMBERS", error_user_data);
+        return NULL;
+    }
+
+    struct multi_backend* multi = calloc(1, sizeof(struct multi_backend));
+    if (!multi) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    multi->base.private_data = multi;
+    multi->base.ops = &multi_backend_ops;
+    multi->base.type = members[0]->type;
+    multi->base.error_cb = error_cb;
+    multi->base.error_user_data = error_user_data;
+
+    // 每个成员的队列空间由其各接收线程的队列平分
+    uint32_t rx_threads = (config && config->rx_threads) ? config->rx_threads : 1;
+    uint32_t queue_bytes = ((config && config->queue_bytes) ? config->queue_bytes : MULTI_DEFAULT_QUEUE_BYTES) / rx_threads;
+    if (queue_bytes < MULTI_MIN_QUEUE_BYTES) {
+        queue_bytes = MULTI_MIN_QUEUE_BYTES;
+    }
+    uint32_t window_us = (config && config->merge_window_us) ? config->merge_window_us : MULTI_DEFAULT_MERGE_WINDOW_US;
+    uint32_t size = 4096;
+    while (size < queue_bytes && size < (1u << 31)) {
+        size <<= 1;
+    }
+
+    multi->merge_window_ns = (int64_t)window_us * 1000;
+    // 未指定时保持原来的丢弃新数据包
+    multi->policy = (config && config->overload.policy != CAPTURE_OVERLOAD_NONE) ? config->overload.policy
+                                                                                : CAPTURE_OVERLOAD_DROP_NEWEST;
+    multi->sample_rate = (config && config->overload.sample_rate) ? config->overload.sample_rate
+                                                                  : CAPTURE_OVERLOAD_DEFAULT_SAMPLE_RATE;
+    multi->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    atomic_init(&multi->merge_waiting, false);
+    atomic_init(&multi->running, false);
+    atomic_init(&multi->paused, false);
+
+    multi->members = calloc(count, sizeof(multi_member_t));
+    multi->queues = calloc((size_t)count * rx_threads, sizeof(multi_queue_t));
+    int aff_ret = capture_affinity_init(&multi->affinity, config ? config->cpus : NULL,
+                                        config ? config->cpu_count : 0,
+                                        config ? config->numa_nodes : 0, false);
+    if (!multi->members || !multi->queues || multi->wake_fd < 0 || aff_ret != CAPTURE_SUCCESS) {
+        error_cb(aff_ret == CAPTURE_ERROR_INVALID_PARAM ? "Invalid member CPU placement"
+                                                        : "Failed to allocate multi-device state",
+                 error_user_data);
+        capture_affinity_destroy(&multi->affinity);
+        free(multi->members);
+        free(multi->queues);
+        if (multi->wake_fd >= 0) {
+            close(multi->wake_fd);
+        }
+        free(multi);
+        return NULL;
+    }
+    multi->member_count = count;
+    multi->rx_threads = rx_threads;
+    multi->filter = (config && config->filter) ? strdup(config->filter) : NULL;
+    multi->queue_count = count * rx_threads;
+
+    for (uint32_t i = 0; i < count; i++) {
+        multi_member_t* member = &multi->members[i];
+        member->owner = multi;
+        member->index = i;
+        member->queues = &multi->queues[i * rx_threads];
+        atomic_init(&member->done, false);
+    }
+    for (uint32_t i = 0; i < multi->queue_count; i++) {
+        multi_queue_t* queue = &multi->queues[i];
+        queue->member = &multi->members[i / rx_threads];
+        queue->rx_index = i % rx_threads;
+        queue->space_fd = -1;
+        atomic_init(&queue->head, 0);
+        atomic_init(&queue->tail, 0);
+        atomic_init(&queue->space_waiting, false);
+        pthread_mutex_init(&queue->lock, NULL);
+    }
+
+    for (uint32_t i = 0; i < multi->queue_count; i++) {
+        multi_queue_t* queue = &multi->queues[i];
+        queue->size = size;
+        queue->buf = capture_numa_alloc(size, capture_affinity_node(&multi->affinity, i / rx_threads));
+        queue->space_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (multi->policy == CAPTURE_OVERLOAD_DROP_OLDEST) {
+            queue->staged = (uint8_t*)malloc(size / 2);
+        }
+        if (!queue->buf || queue->space_fd < 0 ||
+            (multi->policy == CAPTURE_OVERLOAD_DROP_OLDEST && !queue->staged)) {
+            error_cb("Failed to allocate merge queue", error_user_data);
+            // 成员后端仍归调用者所有
+            multi_release(multi);
+            return NULL;
+        }
+    }
+
+    // 全部资源就绪后才接管成员后端
+    for (uint32_t i = 0; i < count; i++) {
+        multi->members[i].backend = members[i];
+    }
+    return &multi->base;
+}
+
+// 销毁多设备聚合后端
+void multi_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    multi_release((struct multi_backend*)backend);
+}
+
+static void multi_cleanup(void* backend) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi) {
+        return;
+    }
+    if (atomic_load(&multi->running)) {
+        multi_stop(multi);
+    }
+    multi_release(multi);
+}
+
+// 选出时间戳最小的队首记录；ready 表示所有仍在运行的成员的每个队列都有数据包。
+// 同时记下各队列的生产位置，等待前据此判断选择之后是否有新数据包到达
+static multi_queue_t* multi_select(struct multi_backend* multi, const multi_record_t** out, bool* ready, bool* finished) {
+    multi_queue_t* best = NULL;
+    const multi_record_t* best_record = NULL;
+    *ready = true;
+    *finished = true;
+
+    for (uint32_t i = 0; i < multi->queue_count; i++) {
+        multi_queue_t* queue = &multi->queues[i];
+        bool done = atomic_load_explicit(&queue->member->done, memory_order_acquire);
+        queue->seen_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        const multi_record_t* record = multi_peek(queue);
+        if (!record) {
+            if (!done) {
+                *ready = false;
+                *finished = false;
+            }
+            continue;
+        }
+        *finished = false;
+        if (!best_record || multi_ts_cmp(&record->meta.ts, &best_record->meta.ts) < 0) {
+            best = queue;
+            best_record = record;
+        }
+    }
+
+    *out = best_record;
+    return best;
+}
+
+// 按时间戳归并各队列，直到停止或所有成员结束
+static void multi_merge(struct multi_backend* multi) {
+    struct pollfd pfd = { .fd = multi->wake_fd, .events = POLLIN };
+
+    // 下游（如按流分发）把归并线程视为唯一的接收线程
+    capture_rx_index = 0;
+    while (atomic_load_explicit(&multi->running, memory_order_relaxed)) {
+        const multi_record_t* record;
+        bool ready;
+        bool finished;
+        multi_queue_t* queue = multi_select(multi, &record, &ready, &finished);
+
+        if (finished) {
+            break;
+        }
+
+        int timeout_ms = -1;
+        if (record) {
+            int64_t waited = multi_now_ns() - record->enqueue_ns;
+            if (ready || waited >= multi->merge_window_ns) {
+                packet_t pkt = record->meta;
+                pkt.data = (const uint8_t*)(record + 1);
+                pkt.device_index = (uint8_t)queue->member->index;
+
+                bool keep_going = true;
+                if (!atomic_load_explicit(&multi->paused, memory_order_relaxed)) {
+                    capture_counters_packet(&multi->counters, pkt.len);
+                    keep_going = multi->packet_cb(&pkt, multi->user_data);
+                }
+                multi_pop(queue, record);
+                if (!keep_going) {
+                    atomic_store(&multi->running, false);
+                }
+                continue;
+            }
+            // 等到窗口结束或其他队列送来数据包
+            timeout_ms = (int)((multi->merge_window_ns - waited + 999999) / 1000000);
+        }
+
+        // 设置等待标志之后再确认选择以来没有新数据包，否则入队方可能看不到标志而不唤醒
+        atomic_store(&multi->merge_waiting, true);
+        atomic_thread_fence(memory_order_seq_cst);
+        bool changed = false;
+        for (uint32_t i = 0; i < multi->queue_count && !changed; i++) {
+            multi_queue_t* q = &multi->queues[i];
+            changed = atomic_load_explicit(&q->tail, memory_order_relaxed) != q->seen_tail;
+        }
+        if (!changed) {
+            poll(&pfd, 1, timeout_ms);
+            uint64_t drain;
+            while (read(multi->wake_fd, &drain, sizeof(drain)) > 0) {
+            }
+        }
+        atomic_store(&multi->merge_waiting, false);
+    }
+}
+
+static int multi_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    multi->packet_cb = callback;
+    multi->user_data = user_data;
+    clock_gettime(CLOCK_REALTIME, &multi->start_time);
+
+    // 先清除成员的停止请求再置位自己的运行标志，此后到达的 stop 对成员同样生效
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        capture_backend_rearm(multi->members[i].backend);
+    }
+    bool started = capture_backend_enter(&multi->base, &multi->running);
+
+    int ret = CAPTURE_SUCCESS;
+    for (uint32_t i = 0; started && i < multi->member_count; i++) {
+        multi_member_t* member = &multi->members[i];
+        atomic_store(&member->done, false);
+        member->result = CAPTURE_SUCCESS;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        capture_affinity_attr(&multi->affinity, i, &attr);
+        int err = pthread_create(&member->thread, &attr, multi_member_thread, member);
+        pthread_attr_destroy(&attr);
+        if (err != 0) {
+            multi->base.error_cb("Failed to create member capture thread", multi->base.error_user_data);
+            atomic_store(&multi->running, false);
+            ret = CAPTURE_ERROR_START_FAILED;
+            break;
+        }
+        member->has_thread = true;
+    }
+
+    if (started && ret == CAPTURE_SUCCESS) {
+        multi_merge(multi);
+    }
+
+    // 归并结束后停止仍在运行的成员
+    atomic_store(&multi->running, false);
+    uint64_t drain;
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        multi_member_t* member = &multi->members[i];
+        if (!member->has_thread) {
+            continue;
+        }
+        if (!atomic_load(&member->done)) {
+            member->backend->ops->stop(member->backend);
+            multi_wake_member(member);
+        }
+        pthread_join(member->thread, NULL);
+        member->has_thread = false;
+        if (ret == CAPTURE_SUCCESS) {
+            ret = member->result;
+        }
+    }
+
+    // 丢弃未交付的数据包，便于再次启动
+    for (uint32_t i = 0; i < multi->queue_count; i++) {
+        multi_queue_t* queue = &multi->queues[i];
+        atomic_store(&queue->head, atomic_load(&queue->tail));
+        queue->has_staged = false;
+        while (read(queue->space_fd, &drain, sizeof(drain)) > 0) {
+        }
+    }
+
+    while (read(multi->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+
+    clock_gettime(CLOCK_REALTIME, &multi->end_time);
+    return ret;
+}
+
+static int multi_stop(void* backend) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&multi->base, &multi->running);
+
+    int ret = CAPTURE_SUCCESS;
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        capture_backend_t* member = multi->members[i].backend;
+        int err = member->ops->stop(member);
+        if (err != CAPTURE_SUCCESS && ret == CAPTURE_SUCCESS) {
+            ret = err;
+        }
+        // 同时唤醒等待队列空间的接收线程
+        multi_wake_member(&multi->members[i]);
+    }
+    multi_wake(multi);
+    return ret;
+}
+
+static int multi_pause(void* backend) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    // 成员继续抓包并保持队列流动，只是不再交付
+    atomic_store(&multi->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int multi_resume(void* backend) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&multi->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int multi_set_filter(void* backend, const char* filter) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        if (!multi->members[i].backend->ops->set_filter) {
+            return CAPTURE_ERROR_NOT_SUPPORTED;
+        }
+    }
+
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        capture_backend_t* member = multi->members[i].backend;
+        int ret = member->ops->set_filter(member, filter);
+        if (ret != CAPTURE_SUCCESS) {
+            // 恢复已更换的成员，原来没有过滤器时用空表达式接受所有数据包
+            while (i-- > 0) {
+                member = multi->members[i].backend;
+                member->ops->set_filter(member, multi->filter ? multi->filter : "");
+            }
+            return ret;
+        }
+    }
+
+    char* copy = strdup(filter);
+    if (copy) {
+        free(multi->filter);
+        multi->filter = copy;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static int multi_get_stats(void* backend, capture_stats_t* stats) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    // 接收数据包数以归并后实际交付的为准，丢包数为各成员与合并队列之和
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        multi_member_t* member = &multi->members[i];
+        capture_stats_t member_stats;
+        memset(&member_stats, 0, sizeof(member_stats));
+        if (member->backend->ops->get_stats) {
+            int ret = member->backend->ops->get_stats(member->backend, &member_stats);
+            if (ret != CAPTURE_SUCCESS) {
+                return ret;
+            }
+        }
+        stats->packets_dropped += member_stats.packets_dropped;
+        stats->packets_if_dropped += member_stats.packets_if_dropped;
+    }
+    for (uint32_t i = 0; i < multi->queue_count; i++) {
+        capture_counters_merge(&multi->queues[i].counters, stats);
+    }
+    capture_counters_merge(&multi->counters, stats);
+    stats->start_time = multi->start_time;
+    stats->end_time = multi->end_time;
+    return CAPTURE_SUCCESS;
+}
+
+// 各成员的接收线程（第 i 个成员从 i * rx_threads 开始编号）之后是归并线程
+static int multi_get_thread_stats(void* backend, capture_thread_stats_t* stats, uint32_t max) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        uint32_t room = count < max ? max - count : 0;
+        int ret = capture_backend_thread_stats(multi->members[i].backend, room ? &stats[count] : NULL, room);
+        if (ret < 0) {
+            return ret;
+        }
+        uint32_t filled = (uint32_t)ret < room ? (uint32_t)ret : room;
+        for (uint32_t k = count; k < count + filled; k++) {
+            // 合并队列的过载计数归到写入它的接收线程
+            if (stats[k].role == CAPTURE_THREAD_RECEIVE && stats[k].index < multi->rx_threads) {
+                capture_counters_add_overload(&multi->members[i].queues[stats[k].index].counters, &stats[k]);
+            }
+            stats[k].index += i * multi->rx_threads;
+        }
+        count += (uint32_t)ret;
+    }
+    if (count < max) {
+        capture_counters_read(&multi->counters, CAPTURE_THREAD_MERGE, 0, &stats[count]);
+    }
+    return (int)count + 1;
+}
+
+static const char* multi_get_name(void* backend) {
+    return "multi";
+}
+
+static const char* multi_get_version(void* backend) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    capture_backend_t* member = multi->members[0].backend;
+    return member->ops->get_version ? member->ops->get_version(member) : "";
+}
+
+static const char* multi_get_description(void* backend) {
+    return "Timestamp-merged multi-device capture backend";
+}
+
+static bool multi_is_feature_supported(void* backend, const char* feature) {
+    struct multi_backend* multi = (struct multi_backend*)backend;
+    if (!multi || !feature) {
+        return false;
+    }
+    if (strcmp(feature, "multi_device") == 0) {
+        return true;
+    }
+
+    // 其余功能要求所有成员都支持
+    for (uint32_t i = 0; i < multi->member_count; i++) {
+        capture_backend_t* member = multi->members[i].backend;
+        if (!member->ops->is_feature_supported ||
+            !member->ops->is_feature_supported(member, feature)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -5,24 +5,40 @@
 #include <time.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <net/if.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "../../include/backends/pcap_backend.h"
 #include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
 
 struct pcap_backend {
     capture_backend_t base;          // 基础后端结构
     pcap_t* handle;                  // libpcap 句柄
     char* device;                    // 设备名称
+    uint32_t if_index;               // 设备的系统接口索引
     char* filter;                    // 过滤器
     int snaplen;                     // 抓包长度
     int timeout_ms;                  // 超时时间
     bool promiscuous;                // 是否开启混杂模式
     bool immediate;                  // 是否立即返回
+    uint32_t linktype;               // 链路类型
     uint32_t buffer_size;            // 缓冲区大小
     packet_callback_t packet_cb;     // 数据包回调
     error_callback_t error_cb;       // 错误回调
     void* user_data;                 // 用户数据
     void* error_user_data;           // 错误回调用户数据
-    bool running;                    // 是否正在运行
+    atomic_bool running;             // 是否正在运行
+    capture_counters_t counters;     // 交付计数
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+    pthread_mutex_t filter_lock;     // 保护过滤器与待应用的过滤程序
+    pthread_cond_t filter_cond;      // 抓包线程应用过滤程序后通知
+    pthread_t loop_thread;           // 运行 pcap_loop 的线程
+    bool looping;                    // pcap_loop 是否在运行
+    bool has_pending;                // 是否有待抓包线程应用的过滤程序
+    struct bpf_program pending;      // 待应用的过滤程序
+    int* pending_ret;                // 应用结果写回的位置
 };
 
 // 内部函数声明
@@ -33,6 +49,7 @@ static int pcap_backend_get_devices(void* backend, capture_device_t** devices, i
 static void pcap_backend_free_devices(void* backend, capture_device_t* devices, int count);
 static const char* pcap_backend_get_name(void* backend);
 static const char* pcap_backend_get_description(void* backend);
+static int pcap_backend_set_filter(void* backend, const char* filter);
 
 // 公共接口实现
 capture_handle_t* pcap_backend_init(
@@ -62,7 +79,9 @@ capture_handle_t* pcap_backend_init(
     backend->error_cb = error_cb;
     backend->user_data = user_data;
     backend->error_user_data = error_user_data;
-    backend->running = false;
+    atomic_init(&backend->running, false);
+    pthread_mutex_init(&backend->filter_lock, NULL);
+    pthread_cond_init(&backend->filter_cond, NULL);
 
     char errbuf[PCAP_ERRBUF_SIZE];
     backend->handle = pcap_create(backend->device, errbuf);
@@ -149,24 +168,14 @@ capture_handle_t* pcap_backend_init(
 // pcap_callback 回调实现，修正 .ts 字段类型
 static void pcap_callback(u_char* user, const struct pcap_pkthdr* header, const u_char* packet) {
     struct pcap_backend* backend = (struct pcap_backend*)user;
-    printf("[pcap_callback] enter, backend=%p, running=%d, user_data=%p\n", 
-           backend, backend ? backend->running : -1, backend ? backend->user_data : NULL);
-    
-    if (!backend) {
-        printf("[pcap_callback] ERROR: backend is NULL\n");
-        return;
-    }
-    
-    if (!backend->running) {
-        printf("[pcap_callback] backend not running, return\n");
+    if (!backend || !backend->packet_cb) {
         return;
     }
-    
-    if (!backend->packet_cb) {
-        printf("[pcap_callback] ERROR: packet_cb is NULL\n");
+
+    if (!atomic_load_explicit(&backend->running, memory_order_relaxed)) {
         return;
     }
-    
+
     struct timespec ts;
     ts.tv_sec = header->ts.tv_sec;
     ts.tv_nsec = header->ts.tv_usec * 1000;
@@ -175,103 +184,126 @@ static void pcap_callback(u_char* user, const struct pcap_pkthdr* header, const
         .len = header->len,
         .caplen = header->caplen,
         .ts = ts,
-        .if_index = 0,
+        .if_index = backend->if_index,
         .flags = 0,
         .protocol = 0,
         .vlan_tci = 0,
         .hash = 0,
     };
-    
-    printf("[pcap_callback] before user callback, packet len=%d, caplen=%d\n", 
-           pkt.len, pkt.caplen);
-           
+    packet_decode(&pkt, backend->linktype);
+
+    capture_counters_packet(&backend->counters, header->len);
     if (!backend->packet_cb(&pkt, backend->user_data)) {
-        printf("[pcap_callback] user callback returned false, set running=0\n");
-        backend->running = false;
+        atomic_store(&backend->running, false);
+        pcap_breakloop(backend->handle);
+    }
+}
+
+// 应用过滤程序并释放，调用者持有 filter_lock
+static int pcap_backend_install(struct pcap_backend* backend, struct bpf_program* fp) {
+    int ret = CAPTURE_SUCCESS;
+    if (pcap_setfilter(backend->handle, fp) != 0) {
+        backend->error_cb(pcap_geterr(backend->handle), backend->error_user_data);
+        ret = CAPTURE_ERROR_SET_FILTER;
     }
-    printf("[pcap_callback] leave\n");
+    pcap_freecode(fp);
+    return ret;
+}
+
+// 在抓包线程上应用等待中的过滤程序并通知 set_filter 的调用者
+static void pcap_backend_apply_pending(struct pcap_backend* backend) {
+    *backend->pending_ret = pcap_backend_install(backend, &backend->pending);
+    backend->has_pending = false;
+    pthread_cond_broadcast(&backend->filter_cond);
 }
 
 int pcap_backend_start(capture_handle_t* handle, packet_callback_t packet_cb, void* user_data) {
     struct pcap_backend* backend = (struct pcap_backend*)handle;
-    printf("[pcap_backend_start] enter, handle=%p, backend=%p, packet_cb=%p, user_data=%p\n",
-           handle, backend, packet_cb, user_data);
-           
     if (!backend || !backend->handle) {
-        printf("[pcap_backend_start] ERROR: Invalid handle or backend\n");
         return -1;
     }
-    
+
     backend->user_data = user_data;
     backend->packet_cb = packet_cb;  // 确保设置回调函数
-    
+
     char errbuf[PCAP_ERRBUF_SIZE];
-    pcap_t* test_handle = pcap_open_live(backend->device, backend->snaplen, 
+    pcap_t* test_handle = pcap_open_live(backend->device, backend->snaplen,
                                         backend->promiscuous, 1000, errbuf);
     if (!test_handle) {
-        printf("[pcap_backend_start] ERROR: Device not available: %s\n", errbuf);
+        backend->error_cb(errbuf, backend->error_user_data);
         return -1;
     }
     pcap_close(test_handle);
-    
-    printf("[pcap_backend_start] Starting capture on device %s\n", backend->device);
-    backend->running = true;
-    
-    int ret = pcap_loop(backend->handle, 10, pcap_callback, (u_char*)backend);
-    if (ret < 0) {
-        printf("[pcap_backend_start] ERROR: pcap_loop failed: %s\n", pcap_geterr(backend->handle));
-        backend->running = false;
+
+    backend->linktype = (uint32_t)pcap_datalink(backend->handle);
+    clock_gettime(CLOCK_REALTIME, &backend->start_time);
+    if (!capture_backend_enter(&backend->base, &backend->running)) {
+        // 启动前已请求停止
+        clock_gettime(CLOCK_REALTIME, &backend->end_time);
+        return 0;
+    }
+    pthread_mutex_lock(&backend->filter_lock);
+    backend->loop_thread = pthread_self();
+    backend->looping = true;
+    pthread_mutex_unlock(&backend->filter_lock);
+
+    // 一直抓包直到 pcap_breakloop（返回 -2）或读到文件末尾；为更换过滤器
+    // 而打断时应用新过滤器后继续，句柄与内核缓冲区保持不变
+    int ret;
+    for (;;) {
+        ret = pcap_loop(backend->handle, -1, pcap_callback, (u_char*)backend);
+        pthread_mutex_lock(&backend->filter_lock);
+        bool swapped = backend->has_pending;
+        if (swapped) {
+            pcap_backend_apply_pending(backend);
+        }
+        bool again = swapped && ret == PCAP_ERROR_BREAK && atomic_load(&backend->running);
+        backend->looping = again;
+        pthread_mutex_unlock(&backend->filter_lock);
+        if (!again) {
+            break;
+        }
+    }
+    atomic_store(&backend->running, false);
+    clock_gettime(CLOCK_REALTIME, &backend->end_time);
+    if (ret == -1) {
+        backend->error_cb(pcap_geterr(backend->handle), backend->error_user_data);
         return -1;
     }
-    
-    printf("[pcap_backend_start] leave, ret=%d\n", ret);
-    return ret;
+    return 0;
 }
 
 int pcap_backend_stop(capture_handle_t* handle) {
     struct pcap_backend* backend = (struct pcap_backend*)handle;
-    printf("[pcap_backend_stop] enter, handle=%p, backend=%p, running=%d\n", 
-           handle, backend, backend ? backend->running : -1);
-           
     if (!backend) {
-        printf("[pcap_backend_stop] ERROR: backend is NULL\n");
         return -1;
     }
 
-    backend->running = false;
+    // 只请求退出，pcap_loop 在当前批次处理完后返回；需要等待时由调用者
+    // join 接收线程，句柄留到 cleanup 再关闭
+    capture_backend_request_stop(&backend->base, &backend->running);
     if (backend->handle) {
-        printf("[pcap_backend_stop] calling pcap_breakloop, handle=%p\n", backend->handle);
         pcap_breakloop(backend->handle);
-        usleep(100000);  // 等待100ms确保回调完成
-        
-        if (backend->handle) {
-            printf("[pcap_backend_stop] calling pcap_close, handle=%p\n", backend->handle);
-        pcap_close(backend->handle);
-        backend->handle = NULL;
     }
-    }
-    
-    printf("[pcap_backend_stop] leave\n");
     return 0;
 }
 
 void pcap_backend_cleanup(capture_handle_t* handle) {
     struct pcap_backend* backend = (struct pcap_backend*)handle;
-    printf("[pcap_backend_cleanup] called, handle=%p, backend=%p\n", handle, backend);
     if (!backend) {
-        printf("[pcap_backend_cleanup] backend is NULL\n");
         return;
     }
-    if (backend->running) {
-        printf("[pcap_backend_cleanup] backend running, call stop\n");
+    if (atomic_load(&backend->running)) {
         pcap_backend_stop(handle);
     }
-    if (backend->filter) {
-        printf("[pcap_backend_cleanup] free filter %p\n", backend->filter);
-        free(backend->filter);
-        backend->filter = NULL;
+    if (backend->handle) {
+        pcap_close(backend->handle);
+        backend->handle = NULL;
     }
-    printf("[pcap_backend_cleanup] free backend struct %p\n", backend);
+    pthread_mutex_destroy(&backend->filter_lock);
+    pthread_cond_destroy(&backend->filter_cond);
+    free(backend->device);
+    free(backend->filter);
     free(backend);
 }
 
@@ -284,9 +316,13 @@ int pcap_backend_get_stats(capture_handle_t* handle, capture_stats_t* stats) {
     if (pcap_stats(backend->handle, &stat_info) != 0) {
         return -1;
     }
-    stats->packets_received = stat_info.ps_recv;
+    // 与其他后端一致，接收数据包数为实际交付的数量（ps_recv 在部分平台上
+    // 包含尚未读取的数据包）
     stats->packets_dropped = stat_info.ps_drop;
     stats->packets_if_dropped = stat_info.ps_ifdrop;
+    stats->start_time = backend->start_time;
+    stats->end_time = backend->end_time;
+    capture_counters_merge(&backend->counters, stats);
     return 0;
 }
 
@@ -334,6 +370,7 @@ static capture_backend_ops_t pcap_backend_ops = {
     .cleanup = (void (*)(void*))pcap_backend_cleanup,
     .start = (int (*)(void*, packet_callback_t, void*))pcap_backend_start,
     .stop = (int (*)(void*))pcap_backend_stop,
+    .set_filter = pcap_backend_set_filter,
     .get_stats = (int (*)(void*, capture_stats_t*))pcap_backend_get_stats,
     .get_version = (const char* (*)(void*))pcap_backend_get_version,
     .is_feature_supported = (bool (*)(void*, const char*))pcap_backend_is_feature_supported,
@@ -375,8 +412,13 @@ capture_backend_t* pcap_backend_create(
     backend->base.type = CAPTURE_BACKEND_PCAP;
     backend->base.error_cb = error_cb;
     backend->base.error_user_data = error_user_data;
+    backend->error_cb = error_cb;
+    backend->error_user_data = error_user_data;
+    pthread_mutex_init(&backend->filter_lock, NULL);
+    pthread_cond_init(&backend->filter_cond, NULL);
 
     backend->device = strdup(config->device);
+    backend->if_index = if_nametoindex(config->device);
     printf("[pcap_backend_create] backend->device strdup result: %p, str=%s\n", backend->device, backend->device);
     backend->filter = config->filter ? strdup(config->filter) : NULL;
     if (backend->filter) printf("[pcap_backend_create] backend->filter strdup result: %p, str=%s\n", backend->filter, backend->filter);
@@ -481,10 +523,60 @@ void pcap_backend_destroy(capture_backend_t* backend) {
         printf("[pcap_backend_destroy] closing pcap handle %p\n", pcap_backend->handle);
         pcap_close(pcap_backend->handle);
     }
+    pthread_mutex_destroy(&pcap_backend->filter_lock);
+    pthread_cond_destroy(&pcap_backend->filter_cond);
     printf("[pcap_backend_destroy] freeing backend %p\n", backend);
     free(backend);
 }
 
+// 更换过滤器，抓包过程中调用时不重新打开设备
+static int pcap_backend_set_filter(void* backend, const char* filter) {
+    struct pcap_backend* pcap_backend = (struct pcap_backend*)backend;
+    if (!pcap_backend || !pcap_backend->handle || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    // 在独立的句柄上编译，不触碰正在抓包的句柄
+    pcap_t* dead = pcap_open_dead(pcap_datalink(pcap_backend->handle), pcap_snapshot(pcap_backend->handle));
+    if (!dead) {
+        pcap_backend->error_cb("Failed to open dead pcap handle", pcap_backend->error_user_data);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    struct bpf_program fp;
+    if (pcap_compile(dead, &fp, filter, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        pcap_backend->error_cb(pcap_geterr(dead), pcap_backend->error_user_data);
+        pcap_close(dead);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    pcap_close(dead);
+
+    pthread_mutex_lock(&pcap_backend->filter_lock);
+    int ret;
+    if (!pcap_backend->looping || pthread_equal(pcap_backend->loop_thread, pthread_self())) {
+        // 未在抓包或在回调中调用，直接在当前线程应用
+        ret = pcap_backend_install(pcap_backend, &fp);
+    } else {
+        // pcap_t 不能跨线程使用：打断 pcap_loop，由抓包线程应用后继续抓包
+        while (pcap_backend->has_pending) {
+            pthread_cond_wait(&pcap_backend->filter_cond, &pcap_backend->filter_lock);
+        }
+        ret = -1;
+        pcap_backend->pending = fp;
+        pcap_backend->pending_ret = &ret;
+        pcap_backend->has_pending = true;
+        pcap_breakloop(pcap_backend->handle);
+        while (ret < 0) {
+            pthread_cond_wait(&pcap_backend->filter_cond, &pcap_backend->filter_lock);
+        }
+    }
+    if (ret == CAPTURE_SUCCESS) {
+        free(pcap_backend->filter);
+        pcap_backend->filter = strdup(filter);
+    }
+    pthread_mutex_unlock(&pcap_backend->filter_lock);
+    return ret;
+}
+
 // 打开设备
 static int pcap_backend_open(void* backend, const char* device) {
     if (!backend || !device) {
@@ -0,0 +1,595 @@
+#include <pcap.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <stdatomic.h>
+#include "../../include/backends/raw_socket_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
+
+// 每条消息的控制信息：纳秒时间戳与 PACKET_AUXDATA
+#define RAW_SOCKET_CMSG_SIZE \
+    (CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(struct tpacket_auxdata)))
+
+struct raw_socket_backend {
+    capture_backend_t base;          // 基础后端结构
+    int fd;                          // AF_PACKET 套接字
+    int wake_fd;                     // 用于唤醒 poll 的 eventfd
+    int ifindex;                     // 接口索引
+    char* device;                    // 设备名称
+    char* filter;                    // 过滤器
+    int snaplen;                     // 抓包长度
+    uint32_t batch_size;             // 批量大小
+    uint8_t* buffers;                // 接收缓冲区，batch_size 个 snaplen 大小的槽
+    uint8_t* cmsg_buffers;           // 控制信息缓冲区
+    struct mmsghdr* msgs;            // recvmmsg 消息数组
+    struct iovec* iovs;              // 每条消息的缓冲区描述
+    struct sockaddr_ll* addrs;       // 每条消息的来源地址
+    capture_sink_t sink;             // 数据包交付器
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    capture_counters_t counters;     // 交付计数
+    atomic_uint_fast64_t kernel_drops; // 内核累计统计的丢包数
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// 内部函数声明
+static void raw_socket_report(struct raw_socket_backend* backend, const char* what);
+static int raw_socket_attach_filter(struct raw_socket_backend* backend, const char* filter);
+static void raw_socket_release(struct raw_socket_backend* backend);
+static void raw_socket_cleanup(void* backend);
+static int raw_socket_start(void* backend, packet_callback_t callback, void* user_data);
+static int raw_socket_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
+static int raw_socket_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+static int raw_socket_get_fd(void* backend);
+static int raw_socket_stop(void* backend);
+static int raw_socket_pause(void* backend);
+static int raw_socket_resume(void* backend);
+static int raw_socket_set_filter(void* backend, const char* filter);
+static int raw_socket_get_stats(void* backend, capture_stats_t* stats);
+static const char* raw_socket_get_name(void* backend);
+static const char* raw_socket_get_version(void* backend);
+static const char* raw_socket_get_description(void* backend);
+static bool raw_socket_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t raw_socket_backend_ops = {
+    .cleanup = raw_socket_cleanup,
+    .start = raw_socket_start,
+    .start_batch = raw_socket_start_batch,
+    .next_batch = raw_socket_next_batch,
+    .get_fd = raw_socket_get_fd,
+    .stop = raw_socket_stop,
+    .pause = raw_socket_pause,
+    .resume = raw_socket_resume,
+    .set_filter = raw_socket_set_filter,
+    .get_stats = raw_socket_get_stats,
+    .get_name = raw_socket_get_name,
+    .get_version = raw_socket_get_version,
+    .get_description = raw_socket_get_description,
+    .is_feature_supported = raw_socket_is_feature_supported,
+};
+
+// 通过错误回调上报带 errno 描述的错误
+static void raw_socket_report(struct raw_socket_backend* backend, const char* what) {
+    char msg[256];
+    snprintf(msg, sizeof(msg), "%s: %s", what, strerror(errno));
+    backend->base.error_cb(msg, backend->base.error_user_data);
+}
+
+// 借助 libpcap 编译过滤器，再以经典 BPF 形式挂到套接字上
+static int raw_socket_attach_filter(struct raw_socket_backend* backend, const char* filter) {
+    pcap_t* dead = pcap_open_dead(DLT_EN10MB, backend->snaplen);
+    if (!dead) {
+        backend->base.error_cb("Failed to open dead pcap handle", backend->base.error_user_data);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    struct bpf_program fp;
+    if (pcap_compile(dead, &fp, filter, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        backend->base.error_cb(pcap_geterr(dead), backend->base.error_user_data);
+        pcap_close(dead);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    // struct bpf_insn 与 struct sock_filter 布局一致
+    struct sock_fprog prog = {
+        .len = (unsigned short)fp.bf_len,
+        .filter = (struct sock_filter*)fp.bf_insns,
+    };
+    int ret = setsockopt(backend->fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog));
+    pcap_freecode(&fp);
+    pcap_close(dead);
+
+    if (ret != 0) {
+        raw_socket_report(backend, "SO_ATTACH_FILTER");
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// 释放套接字与缓冲区
+static void raw_socket_release(struct raw_socket_backend* backend) {
+    if (backend->fd >= 0) {
+        close(backend->fd);
+    }
+    if (backend->wake_fd >= 0) {
+        close(backend->wake_fd);
+    }
+    free(backend->buffers);
+    free(backend->cmsg_buffers);
+    free(backend->msgs);
+    free(backend->iovs);
+    free(backend->addrs);
+    free(backend->device);
+    free(backend->filter);
+    free(backend);
+}
+
+// 分配批量接收缓冲区并预先填好消息数组
+static int raw_socket_alloc_batch(struct raw_socket_backend* backend) {
+    uint32_t n = backend->batch_size;
+    backend->buffers = malloc((size_t)n * backend->snaplen);
+    backend->cmsg_buffers = calloc(n, RAW_SOCKET_CMSG_SIZE);
+    backend->msgs = calloc(n, sizeof(struct mmsghdr));
+    backend->iovs = calloc(n, sizeof(struct iovec));
+    backend->addrs = calloc(n, sizeof(struct sockaddr_ll));
+    if (!backend->buffers || !backend->cmsg_buffers || !backend->msgs ||
+        !backend->iovs || !backend->addrs) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        backend->iovs[i].iov_base = backend->buffers + (size_t)i * backend->snaplen;
+        backend->iovs[i].iov_len = (size_t)backend->snaplen;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// recvmmsg 会改写 msg_namelen/msg_controllen，每批之前需要复位
+static void raw_socket_reset_batch(struct raw_socket_backend* backend) {
+    for (uint32_t i = 0; i < backend->batch_size; i++) {
+        struct msghdr* hdr = &backend->msgs[i].msg_hdr;
+        hdr->msg_name = &backend->addrs[i];
+        hdr->msg_namelen = sizeof(struct sockaddr_ll);
+        hdr->msg_iov = &backend->iovs[i];
+        hdr->msg_iovlen = 1;
+        hdr->msg_control = backend->cmsg_buffers + (size_t)i * RAW_SOCKET_CMSG_SIZE;
+        hdr->msg_controllen = RAW_SOCKET_CMSG_SIZE;
+        hdr->msg_flags = 0;
+    }
+}
+
+// 创建原始套接字后端
+capture_backend_t* raw_socket_backend_create(
+    const raw_socket_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !config->device || !error_cb) {
+        return NULL;
+    }
+
+    struct raw_socket_backend* backend = calloc(1, sizeof(struct raw_socket_backend));
+    if (!backend) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    backend->base.private_data = backend;
+    backend->base.ops = &raw_socket_backend_ops;
+    backend->base.type = CAPTURE_BACKEND_RAW_SOCKET;
+    backend->base.error_cb = error_cb;
+    backend->base.error_user_data = error_user_data;
+
+    backend->fd = -1;
+    backend->wake_fd = -1;
+    backend->snaplen = config->snaplen > 0 ? config->snaplen : 65535;
+    backend->batch_size = config->batch_size ? config->batch_size : RAW_SOCKET_DEFAULT_BATCH_SIZE;
+    backend->device = strdup(config->device);
+    backend->filter = config->filter ? strdup(config->filter) : NULL;
+    atomic_init(&backend->running, false);
+    atomic_init(&backend->paused, false);
+
+    if (backend->batch_size > RAW_SOCKET_MAX_BATCH_SIZE) {
+        error_cb("Batch size exceeds RAW_SOCKET_MAX_BATCH_SIZE", error_user_data);
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    if (raw_socket_alloc_batch(backend) != CAPTURE_SUCCESS) {
+        error_cb("Failed to allocate receive buffers", error_user_data);
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    backend->ifindex = (int)if_nametoindex(backend->device);
+    if (backend->ifindex == 0) {
+        raw_socket_report(backend, backend->device);
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    // 协议为 0 的套接字在绑定前不接收任何数据包
+    backend->fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (backend->fd < 0) {
+        raw_socket_report(backend, "socket(AF_PACKET)");
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    backend->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (backend->wake_fd < 0) {
+        raw_socket_report(backend, "eventfd");
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    // 在绑定接口与协议之前挂上过滤器，接收队列中只会有本接口过滤后的数据包
+    if (backend->filter && raw_socket_attach_filter(backend, backend->filter) != CAPTURE_SUCCESS) {
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    int one = 1;
+    if (setsockopt(backend->fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) != 0) {
+        raw_socket_report(backend, "SO_TIMESTAMPNS");
+        raw_socket_release(backend);
+        return NULL;
+    }
+    if (setsockopt(backend->fd, SOL_PACKET, PACKET_AUXDATA, &one, sizeof(one)) != 0) {
+        raw_socket_report(backend, "PACKET_AUXDATA");
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    if (config->rcvbuf_size) {
+        int size = (int)config->rcvbuf_size;
+        // 有 CAP_NET_ADMIN 时可以突破 rmem_max
+        if (setsockopt(backend->fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0 &&
+            setsockopt(backend->fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) != 0) {
+            raw_socket_report(backend, "SO_RCVBUF");
+            raw_socket_release(backend);
+            return NULL;
+        }
+    }
+
+    // 绑定时才开始接收，协议与接口同时生效
+    struct sockaddr_ll addr = {
+        .sll_family = AF_PACKET,
+        .sll_protocol = htons(ETH_P_ALL),
+        .sll_ifindex = backend->ifindex,
+    };
+    if (bind(backend->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        raw_socket_report(backend, "bind(AF_PACKET)");
+        raw_socket_release(backend);
+        return NULL;
+    }
+
+    if (config->promiscuous) {
+        struct packet_mreq mreq = {
+            .mr_ifindex = backend->ifindex,
+            .mr_type = PACKET_MR_PROMISC,
+        };
+        if (setsockopt(backend->fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            raw_socket_report(backend, "PACKET_MR_PROMISC");
+            raw_socket_release(backend);
+            return NULL;
+        }
+    }
+
+    return &backend->base;
+}
+
+// 销毁原始套接字后端
+void raw_socket_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    raw_socket_release((struct raw_socket_backend*)backend);
+}
+
+static void raw_socket_cleanup(void* backend) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw) {
+        return;
+    }
+    if (atomic_load(&raw->running)) {
+        raw_socket_stop(raw);
+    }
+    raw_socket_release(raw);
+}
+
+// 由一条消息的来源地址和控制信息构造数据包
+static void raw_socket_fill_packet(struct raw_socket_backend* backend, uint32_t index, packet_t* pkt) {
+    const struct mmsghdr* msg = &backend->msgs[index];
+    uint32_t len = msg->msg_len;
+
+    // 以 MSG_TRUNC 接收时 msg_len 为原始长度
+    pkt->data = backend->iovs[index].iov_base;
+    pkt->len = len;
+    pkt->caplen = len < (uint32_t)backend->snaplen ? len : (uint32_t)backend->snaplen;
+    pkt->ts.tv_sec = 0;
+    pkt->ts.tv_nsec = 0;
+    pkt->if_index = (uint32_t)backend->addrs[index].sll_ifindex;
+    pkt->device_index = 0;
+    pkt->flags = 0;
+    pkt->protocol = 0;
+    pkt->vlan_tci = 0;
+    pkt->hash = 0;
+
+    struct msghdr* hdr = (struct msghdr*)&msg->msg_hdr;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            memcpy(&pkt->ts, CMSG_DATA(cmsg), sizeof(struct timespec));
+        } else if (cmsg->cmsg_level == SOL_PACKET && cmsg->cmsg_type == PACKET_AUXDATA) {
+            struct tpacket_auxdata aux;
+            memcpy(&aux, CMSG_DATA(cmsg), sizeof(aux));
+            if (aux.tp_status & TP_STATUS_VLAN_VALID) {
+                pkt->vlan_tci = aux.tp_vlan_tci;
+            }
+        }
+    }
+    packet_decode(pkt, packet_linktype_arphrd(backend->addrs[index].sll_hatype));
+}
+
+// 接收循环，数据包经 raw->sink 交付；批量模式下每批 recvmmsg 结束时交付剩余部分
+static int raw_socket_run(struct raw_socket_backend* raw) {
+    clock_gettime(CLOCK_REALTIME, &raw->start_time);
+    capture_backend_enter(&raw->base, &raw->running);
+
+    struct pollfd pfds[2] = {
+        { .fd = raw->fd, .events = POLLIN | POLLERR },
+        { .fd = raw->wake_fd, .events = POLLIN },
+    };
+
+    int ret = CAPTURE_SUCCESS;
+    while (atomic_load_explicit(&raw->running, memory_order_relaxed)) {
+        raw_socket_reset_batch(raw);
+        int n = recvmmsg(raw->fd, raw->msgs, raw->batch_size, MSG_DONTWAIT | MSG_TRUNC, NULL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                // 套接字已读空，等待新数据或停止信号
+                if (poll(pfds, 2, -1) < 0 && errno != EINTR) {
+                    raw_socket_report(raw, "poll");
+                    ret = CAPTURE_ERROR_BACKEND;
+                    break;
+                }
+                if (pfds[1].revents & POLLIN) {
+                    // 读掉唤醒事件，残留的事件会让 poll 一直立即返回；是否停止由运行标志决定
+                    uint64_t drain;
+                    while (read(raw->wake_fd, &drain, sizeof(drain)) > 0) {
+                    }
+                }
+                continue;
+            }
+            raw_socket_report(raw, "recvmmsg");
+            ret = CAPTURE_ERROR_BACKEND;
+            break;
+        }
+
+        // 暂停期间继续读取，避免套接字缓冲区溢出，但不再交付数据包
+        if (atomic_load_explicit(&raw->paused, memory_order_relaxed)) {
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) {
+            packet_t pkt;
+            raw_socket_fill_packet(raw, (uint32_t)i, &pkt);
+            if (!capture_sink_push(&raw->sink, &pkt)) {
+                atomic_store(&raw->running, false);
+                break;
+            }
+        }
+
+        // 下一次 recvmmsg 会复用接收缓冲区
+        if (!capture_sink_flush(&raw->sink)) {
+            atomic_store(&raw->running, false);
+        }
+    }
+
+    atomic_store(&raw->running, false);
+
+    // 清除唤醒事件，便于再次启动
+    uint64_t drain;
+    while (read(raw->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+
+    clock_gettime(CLOCK_REALTIME, &raw->end_time);
+    return ret;
+}
+
+static int raw_socket_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw || !callback || raw->fd < 0) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_sink_init(&raw->sink, callback, NULL, 0, user_data, &raw->counters);
+    return raw_socket_run(raw);
+}
+
+static int raw_socket_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw || !callback || raw->fd < 0) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (capture_sink_init(&raw->sink, NULL, callback, burst_size, user_data, &raw->counters) != CAPTURE_SUCCESS) {
+        raw->base.error_cb("Failed to allocate packet batch", raw->base.error_user_data);
+        return CAPTURE_ERROR_MEMORY;
+    }
+    int ret = raw_socket_run(raw);
+    capture_sink_destroy(&raw->sink);
+    return ret;
+}
+
+// 拉取模式：一次 recvmmsg 最多取 max 个数据包，接收缓冲区在下一次调用时复用
+static int raw_socket_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw || !packets || max == 0 || raw->fd < 0) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (raw->start_time.tv_sec == 0) {
+        clock_gettime(CLOCK_REALTIME, &raw->start_time);
+    }
+
+    uint32_t want = max < raw->batch_size ? max : raw->batch_size;
+    bool waited = false;
+    for (;;) {
+        raw_socket_reset_batch(raw);
+        int n = recvmmsg(raw->fd, raw->msgs, want, MSG_DONTWAIT | MSG_TRUNC, NULL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                raw_socket_report(raw, "recvmmsg");
+                return -CAPTURE_ERROR_BACKEND;
+            }
+            if (timeout_ms == 0 || waited) {
+                return 0;
+            }
+
+            struct pollfd pfds[2] = {
+                { .fd = raw->fd, .events = POLLIN | POLLERR },
+                { .fd = raw->wake_fd, .events = POLLIN },
+            };
+            if (poll(pfds, 2, timeout_ms) < 0 && errno != EINTR) {
+                raw_socket_report(raw, "poll");
+                return -CAPTURE_ERROR_BACKEND;
+            }
+            if (pfds[1].revents & POLLIN) {
+                // 被 stop 打断
+                uint64_t drain;
+                while (read(raw->wake_fd, &drain, sizeof(drain)) > 0) {
+                }
+                return 0;
+            }
+            waited = true;
+            continue;
+        }
+
+        if (atomic_load_explicit(&raw->paused, memory_order_relaxed)) {
+            return 0;
+        }
+
+        uint64_t bytes = 0;
+        for (int i = 0; i < n; i++) {
+            raw_socket_fill_packet(raw, (uint32_t)i, &packets[i]);
+            bytes += packets[i].len;
+        }
+        if (n > 0) {
+            capture_counters_batch(&raw->counters, (uint32_t)n, bytes);
+        }
+        return n;
+    }
+}
+
+static int raw_socket_get_fd(void* backend) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    return raw ? raw->fd : -1;
+}
+
+static int raw_socket_stop(void* backend) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&raw->base, &raw->running);
+
+    // 唤醒阻塞在 poll 中的抓包线程
+    uint64_t one = 1;
+    if (write(raw->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        raw_socket_report(raw, "eventfd write");
+        return CAPTURE_ERROR_STOP_FAILED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static int raw_socket_pause(void* backend) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&raw->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int raw_socket_resume(void* backend) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&raw->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int raw_socket_set_filter(void* backend, const char* filter) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    // SO_ATTACH_FILTER 会在内核中原子替换旧过滤器
+    int ret = raw_socket_attach_filter(raw, filter);
+    if (ret == CAPTURE_SUCCESS) {
+        free(raw->filter);
+        raw->filter = strdup(filter);
+    }
+    return ret;
+}
+
+static int raw_socket_get_stats(void* backend, capture_stats_t* stats) {
+    struct raw_socket_backend* raw = (struct raw_socket_backend*)backend;
+    if (!raw || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    // PACKET_STATISTICS 读取后内核计数清零，这里累加保存；get_stats 可能
+    // 在多个线程上同时调用，各自取走的增量用原子加累加
+    struct tpacket_stats kstats;
+    socklen_t len = sizeof(kstats);
+    if (getsockopt(raw->fd, SOL_PACKET, PACKET_STATISTICS, &kstats, &len) != 0) {
+        raw_socket_report(raw, "PACKET_STATISTICS");
+        return CAPTURE_ERROR_GET_STATS;
+    }
+    stats->packets_dropped = atomic_fetch_add_explicit(&raw->kernel_drops, kstats.tp_drops,
+                                                       memory_order_relaxed) + kstats.tp_drops;
+    stats->packets_if_dropped = 0;
+    stats->start_time = raw->start_time;
+    stats->end_time = raw->end_time;
+    capture_counters_merge(&raw->counters, stats);
+    return CAPTURE_SUCCESS;
+}
+
+static const char* raw_socket_get_name(void* backend) {
+    return "raw_socket";
+}
+
+static const char* raw_socket_get_version(void* backend) {
+    return "recvmmsg";
+}
+
+static const char* raw_socket_get_description(void* backend) {
+    return "AF_PACKET raw socket backend with recvmmsg batching";
+}
+
+static bool raw_socket_is_feature_supported(void* backend, const char* feature) {
+    if (!feature) {
+        return false;
+    }
+    return strcmp(feature, "filter") == 0 ||
+           strcmp(feature, "batch") == 0;
+}
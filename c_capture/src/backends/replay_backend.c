@@ -0,0 +1,856 @@
+#include <pcap.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../../include/backends/replay_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/pcap_file.h"
+#include "../../include/packet_decode.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+// 限速状态：把文件时间轴对齐到单调时钟
+typedef struct {
+    int64_t file_base;               // 第一条数据包的文件时间
+    int64_t wall_base;               // 第一条数据包的交付时间
+    bool have_base;                  // 是否已对齐
+} replay_clock_t;
+
+struct replay_backend {
+    capture_backend_t base;          // 基础后端结构
+    pcap_t* handle;                  // libpcap 离线句柄
+    pcap_mmap_reader_t* reader;      // 内存映射读取器
+    pcap_uring_reader_t* uring;      // io_uring 流式读取器
+    pcap_uring_config_t uring_config; // io_uring 读取器配置
+    struct bpf_program program;      // 映射/io_uring 读取时在用户态执行的过滤程序
+    bool has_program;                // 是否已编译过滤程序
+    uint32_t linktype;               // 文件链路类型
+    pthread_mutex_t filter_lock;     // 保护过滤器与待换上的过滤程序
+    struct bpf_program pending;      // set_filter 编译好、等待读取线程换上的过滤程序
+    atomic_bool has_pending;         // 是否有待换上的过滤程序
+    replay_reader_t reader_type;     // 文件读取方式
+    uint64_t first_packet;           // 起始数据包索引
+    uint64_t packet_count;           // 重放的数据包数
+    int wake_fd;                     // 用于打断限速等待的 eventfd
+    char* path;                      // 文件路径
+    char* filter;                    // 过滤器
+    replay_speed_mode_t mode;        // 速度模式
+    double speed;                    // 倍速
+    uint32_t loops;                  // 重放次数
+    capture_sink_t sink;             // 数据包交付器
+    bool pull_started;               // 是否已开始拉取
+    bool pull_done;                  // 拉取模式下是否已重放完毕
+    bool pull_has_pending;           // 是否有已读出但尚未交付的数据包
+    packet_t pull_pending;           // 已读出但尚未到交付时间的数据包
+    uint32_t pull_pass;              // 拉取模式下的当前遍数
+    uint64_t pull_index;             // 拉取模式下映射读取的下一条索引
+    replay_clock_t pull_clock;       // 拉取模式下的限速状态
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    capture_counters_t counters;     // 交付计数
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// 内部函数声明
+static void replay_cleanup(void* backend);
+static int replay_start(void* backend, packet_callback_t callback, void* user_data);
+static int replay_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
+static int replay_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+static int replay_lease(void* backend, const packet_t* packet);
+static int replay_stop(void* backend);
+static int replay_pause(void* backend);
+static int replay_resume(void* backend);
+static int replay_set_filter(void* backend, const char* filter);
+static int replay_get_stats(void* backend, capture_stats_t* stats);
+static const char* replay_get_name(void* backend);
+static const char* replay_get_version(void* backend);
+static const char* replay_get_description(void* backend);
+static bool replay_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t replay_backend_ops = {
+    .cleanup = replay_cleanup,
+    .start = replay_start,
+    .start_batch = replay_start_batch,
+    .next_batch = replay_next_batch,
+    .lease = replay_lease,
+    .stop = replay_stop,
+    .pause = replay_pause,
+    .resume = replay_resume,
+    .set_filter = replay_set_filter,
+    .get_stats = replay_get_stats,
+    .get_name = replay_get_name,
+    .get_version = replay_get_version,
+    .get_description = replay_get_description,
+    .is_feature_supported = replay_is_feature_supported,
+};
+
+// 按文件链路类型编译过滤程序
+static int replay_compile(struct replay_backend* backend, uint32_t linktype, const char* filter, struct bpf_program* fp) {
+    pcap_t* dead = pcap_open_dead((int)linktype, 262144);
+    if (!dead) {
+        backend->base.error_cb("Failed to open dead pcap handle", backend->base.error_user_data);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    if (pcap_compile(dead, fp, filter, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        backend->base.error_cb(pcap_geterr(dead), backend->base.error_user_data);
+        pcap_close(dead);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    pcap_close(dead);
+    return CAPTURE_SUCCESS;
+}
+
+// 编译过滤程序，供绕过 libpcap 的读取器在用户态执行
+static int replay_compile_program(struct replay_backend* backend, uint32_t linktype, const char* filter) {
+    struct bpf_program fp;
+    int ret = replay_compile(backend, linktype, filter, &fp);
+    if (ret != CAPTURE_SUCCESS) {
+        return ret;
+    }
+
+    if (backend->has_program) {
+        pcap_freecode(&backend->program);
+    }
+    backend->program = fp;
+    backend->has_program = true;
+    return CAPTURE_SUCCESS;
+}
+
+// 读取线程在读下一个数据包之前换上 set_filter 编译好的过滤程序
+static void replay_take_filter(struct replay_backend* backend) {
+    if (!atomic_load_explicit(&backend->has_pending, memory_order_acquire)) {
+        return;
+    }
+
+    pthread_mutex_lock(&backend->filter_lock);
+    if (backend->reader_type == REPLAY_READER_MMAP || backend->reader_type == REPLAY_READER_IO_URING) {
+        if (backend->has_program) {
+            pcap_freecode(&backend->program);
+        }
+        backend->program = backend->pending;
+        backend->has_program = true;
+    } else {
+        if (pcap_setfilter(backend->handle, &backend->pending) != 0) {
+            backend->base.error_cb(pcap_geterr(backend->handle), backend->base.error_user_data);
+        }
+        pcap_freecode(&backend->pending);
+    }
+    atomic_store_explicit(&backend->has_pending, false, memory_order_relaxed);
+    pthread_mutex_unlock(&backend->filter_lock);
+}
+
+// 在离线句柄上编译并应用过滤器
+static int replay_apply_filter(struct replay_backend* backend, pcap_t* handle, const char* filter) {
+    struct bpf_program fp;
+    if (pcap_compile(handle, &fp, filter, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        backend->base.error_cb(pcap_geterr(handle), backend->base.error_user_data);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    if (pcap_setfilter(handle, &fp) != 0) {
+        backend->base.error_cb(pcap_geterr(handle), backend->base.error_user_data);
+        pcap_freecode(&fp);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    pcap_freecode(&fp);
+    return CAPTURE_SUCCESS;
+}
+
+// 打开内存映射读取器并检查重放区间
+static int replay_open_mmap(struct replay_backend* backend) {
+    int ret = pcap_mmap_reader_open(backend->path, &backend->reader);
+    if (ret != CAPTURE_SUCCESS) {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "Failed to map capture file %s", backend->path);
+        backend->base.error_cb(msg, backend->base.error_user_data);
+        return ret;
+    }
+
+    uint64_t total = pcap_mmap_reader_count(backend->reader);
+    if (backend->first_packet > total) {
+        backend->base.error_cb("Replay range starts beyond end of file", backend->base.error_user_data);
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    uint64_t remaining = total - backend->first_packet;
+    if (backend->packet_count == 0 || backend->packet_count > remaining) {
+        backend->packet_count = remaining;
+    }
+
+    if (backend->filter) {
+        return replay_compile_program(backend, pcap_mmap_reader_linktype(backend->reader), backend->filter);
+    }
+    return CAPTURE_SUCCESS;
+}
+
+// 打开（或重新打开）io_uring 读取器
+static int replay_open_uring(struct replay_backend* backend) {
+    pcap_uring_reader_t* reader;
+    int ret = pcap_uring_reader_open(backend->path, &backend->uring_config, &reader);
+    if (ret != CAPTURE_SUCCESS) {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "Failed to open capture file %s with io_uring", backend->path);
+        backend->base.error_cb(msg, backend->base.error_user_data);
+        return ret;
+    }
+
+    if (backend->uring) {
+        pcap_uring_reader_close(backend->uring);
+    } else if (backend->filter) {
+        ret = replay_compile_program(backend, pcap_uring_reader_linktype(reader), backend->filter);
+        if (ret != CAPTURE_SUCCESS) {
+            pcap_uring_reader_close(reader);
+            return ret;
+        }
+    }
+    backend->uring = reader;
+    return CAPTURE_SUCCESS;
+}
+
+// 打开（或重新打开）抓包文件，时间戳精度统一为纳秒
+static int replay_open(struct replay_backend* backend) {
+    char errbuf[PCAP_ERRBUF_SIZE];
+    pcap_t* handle = pcap_open_offline_with_tstamp_precision(
+        backend->path, PCAP_TSTAMP_PRECISION_NANO, errbuf);
+    if (!handle) {
+        backend->base.error_cb(errbuf, backend->base.error_user_data);
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    pthread_mutex_lock(&backend->filter_lock);
+    int ret = backend->filter ? replay_apply_filter(backend, handle, backend->filter) : CAPTURE_SUCCESS;
+    pthread_mutex_unlock(&backend->filter_lock);
+    if (ret != CAPTURE_SUCCESS) {
+        pcap_close(handle);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    if (backend->handle) {
+        pcap_close(backend->handle);
+    }
+    backend->handle = handle;
+    return CAPTURE_SUCCESS;
+}
+
+static void replay_release(struct replay_backend* backend) {
+    if (backend->handle) {
+        pcap_close(backend->handle);
+    }
+    if (backend->has_program) {
+        pcap_freecode(&backend->program);
+    }
+    if (atomic_load(&backend->has_pending)) {
+        pcap_freecode(&backend->pending);
+    }
+    pthread_mutex_destroy(&backend->filter_lock);
+    pcap_mmap_reader_close(backend->reader);
+    pcap_uring_reader_close(backend->uring);
+    if (backend->wake_fd >= 0) {
+        close(backend->wake_fd);
+    }
+    free(backend->path);
+    free(backend->filter);
+    free(backend);
+}
+
+// 创建文件重放后端
+capture_backend_t* replay_backend_create(
+    const replay_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !config->path || !error_cb) {
+        return NULL;
+    }
+
+    if (config->mode == REPLAY_SPEED_MULTIPLIER && !(config->speed > 0.0)) {
+        error_cb("Replay speed multiplier must be positive", error_user_data);
+        return NULL;
+    }
+
+    struct replay_backend* backend = calloc(1, sizeof(struct replay_backend));
+    if (!backend) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    backend->base.private_data = backend;
+    backend->base.ops = &replay_backend_ops;
+    backend->base.type = CAPTURE_BACKEND_REPLAY;
+    backend->base.error_cb = error_cb;
+    backend->base.error_user_data = error_user_data;
+
+    backend->path = strdup(config->path);
+    backend->filter = config->filter ? strdup(config->filter) : NULL;
+    backend->mode = config->mode;
+    backend->speed = config->mode == REPLAY_SPEED_MULTIPLIER ? config->speed : 1.0;
+    backend->loops = config->loops ? config->loops : 1;
+    backend->reader_type = config->reader;
+    backend->first_packet = config->first_packet;
+    backend->packet_count = config->packet_count;
+    backend->uring_config = config->uring;
+    atomic_init(&backend->running, false);
+    atomic_init(&backend->paused, false);
+    atomic_init(&backend->has_pending, false);
+    pthread_mutex_init(&backend->filter_lock, NULL);
+
+    backend->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (backend->wake_fd < 0) {
+        error_cb("Failed to create eventfd", error_user_data);
+        replay_release(backend);
+        return NULL;
+    }
+
+    int ret;
+    switch (backend->reader_type) {
+        case REPLAY_READER_MMAP:
+            ret = replay_open_mmap(backend);
+            break;
+        case REPLAY_READER_IO_URING:
+            ret = replay_open_uring(backend);
+            break;
+        default:
+            ret = replay_open(backend);
+            break;
+    }
+    if (ret != CAPTURE_SUCCESS) {
+        replay_release(backend);
+        return NULL;
+    }
+    switch (backend->reader_type) {
+        case REPLAY_READER_MMAP:
+            backend->linktype = pcap_mmap_reader_linktype(backend->reader);
+            break;
+        case REPLAY_READER_IO_URING:
+            backend->linktype = pcap_uring_reader_linktype(backend->uring);
+            break;
+        default:
+            backend->linktype = (uint32_t)pcap_datalink(backend->handle);
+            break;
+    }
+
+    return &backend->base;
+}
+
+// 销毁文件重放后端
+void replay_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    replay_release((struct replay_backend*)backend);
+}
+
+static void replay_cleanup(void* backend) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay) {
+        return;
+    }
+    if (atomic_load(&replay->running)) {
+        replay_stop(replay);
+    }
+    replay_release(replay);
+}
+
+static int64_t replay_ts_ns(const struct timespec* ts) {
+    return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+// 等待到单调时钟上的 deadline，被 stop 唤醒时返回 false
+// 推送与拉取共用，因此看停止请求而不是运行标志：拉取时不置位运行标志
+static bool replay_wait_until(struct replay_backend* backend, int64_t deadline_ns) {
+    struct pollfd pfd = { .fd = backend->wake_fd, .events = POLLIN };
+
+    while (!atomic_load_explicit(&backend->base.stop_requested, memory_order_relaxed)) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t remaining = deadline_ns - replay_ts_ns(&now);
+        if (remaining <= 0) {
+            return true;
+        }
+
+        struct timespec timeout = {
+            .tv_sec = remaining / NSEC_PER_SEC,
+            .tv_nsec = remaining % NSEC_PER_SEC,
+        };
+        if (ppoll(&pfd, 1, &timeout, NULL) > 0) {
+            // 读掉唤醒事件，残留的事件会让 ppoll 一直立即返回；是否停止由停止请求决定
+            uint64_t drain;
+            while (read(backend->wake_fd, &drain, sizeof(drain)) > 0) {
+            }
+        }
+    }
+    return false;
+}
+
+// 按速度模式等待到数据包的交付时间，被停止时返回 false
+static bool replay_pace(struct replay_backend* backend, replay_clock_t* clock, const struct timespec* ts) {
+    if (backend->mode == REPLAY_SPEED_FASTEST) {
+        return true;
+    }
+
+    int64_t pkt_ns = replay_ts_ns(ts);
+    if (!clock->have_base) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        clock->file_base = pkt_ns;
+        clock->wall_base = replay_ts_ns(&now);
+        clock->have_base = true;
+    }
+    int64_t offset = (int64_t)((double)(pkt_ns - clock->file_base) / backend->speed);
+    if (offset <= 0) {
+        return true;
+    }
+
+    // 需要等待时先交付已攒的数据包，避免其交付时间被推迟
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (replay_ts_ns(&now) < clock->wall_base + offset && !capture_sink_flush(&backend->sink)) {
+        return false;
+    }
+    return replay_wait_until(backend, clock->wall_base + offset);
+}
+
+// 交付一个数据包，返回 false 表示回调要求停止
+static bool replay_deliver(struct replay_backend* backend, packet_t* pkt) {
+    if (atomic_load_explicit(&backend->paused, memory_order_relaxed)) {
+        return true;
+    }
+    packet_decode(pkt, backend->linktype);
+    return capture_sink_push(&backend->sink, pkt);
+}
+
+// 在用户态执行过滤程序，未设置过滤器时全部通过
+static bool replay_match(const struct replay_backend* backend, const packet_t* pkt) {
+    if (!backend->has_program) {
+        return true;
+    }
+    struct pcap_pkthdr header = {
+        .caplen = pkt->caplen,
+        .len = pkt->len,
+    };
+    return pcap_offline_filter(&backend->program, &header, pkt->data) != 0;
+}
+
+// 通过 libpcap 重放一遍文件，返回 false 表示被停止或回调要求停止
+static bool replay_pass_libpcap(struct replay_backend* backend) {
+    struct pcap_pkthdr* header;
+    const u_char* data;
+    replay_clock_t clock = {0};
+    int ret = 0;
+
+    while (atomic_load_explicit(&backend->running, memory_order_relaxed)) {
+        replay_take_filter(backend);
+        if ((ret = pcap_next_ex(backend->handle, &header, &data)) != 1) {
+            break;
+        }
+        // 以纳秒精度打开，tv_usec 中实际存放的是纳秒
+        packet_t pkt = {
+            .data = data,
+            .len = header->len,
+            .caplen = header->caplen,
+            .ts = { .tv_sec = header->ts.tv_sec, .tv_nsec = header->ts.tv_usec },
+            .if_index = 0,
+            .flags = 0,
+            .protocol = 0,
+            .vlan_tci = 0,
+            .hash = 0,
+        };
+
+        // 下一次 pcap_next_ex 会覆盖数据包内容，不能跨数据包攒批
+        if (!replay_pace(backend, &clock, &pkt.ts) || !replay_deliver(backend, &pkt) ||
+            !capture_sink_flush(&backend->sink)) {
+            return false;
+        }
+    }
+
+    if (ret == -1) {
+        backend->base.error_cb(pcap_geterr(backend->handle), backend->base.error_user_data);
+        return false;
+    }
+    return atomic_load_explicit(&backend->running, memory_order_relaxed);
+}
+
+// 通过内存映射重放一遍指定区间，数据包直接指向映射内存
+static bool replay_pass_mmap(struct replay_backend* backend) {
+    replay_clock_t clock = {0};
+    uint64_t end = backend->first_packet + backend->packet_count;
+
+    for (uint64_t i = backend->first_packet; i < end; i++) {
+        if (!atomic_load_explicit(&backend->running, memory_order_relaxed)) {
+            return false;
+        }
+
+        replay_take_filter(backend);
+        packet_t pkt;
+        if (pcap_mmap_reader_get(backend->reader, (size_t)i, &pkt) != CAPTURE_SUCCESS) {
+            backend->base.error_cb("Corrupt record in mapped capture file", backend->base.error_user_data);
+            return false;
+        }
+
+        if (!replay_match(backend, &pkt)) {
+            continue;
+        }
+
+        if (!replay_pace(backend, &clock, &pkt.ts) || !replay_deliver(backend, &pkt)) {
+            return false;
+        }
+    }
+    return capture_sink_flush(&backend->sink);
+}
+
+// 通过 io_uring 流式重放一遍文件
+static bool replay_pass_uring(struct replay_backend* backend) {
+    replay_clock_t clock = {0};
+    packet_t pkt;
+    int ret = 0;
+
+    while (atomic_load_explicit(&backend->running, memory_order_relaxed) &&
+           (ret = pcap_uring_reader_next(backend->uring, &pkt)) == 1) {
+        replay_take_filter(backend);
+        if (!replay_match(backend, &pkt)) {
+            continue;
+        }
+        // 读取器推进后块缓冲区可能被复用，不能跨数据包攒批
+        if (!replay_pace(backend, &clock, &pkt.ts) || !replay_deliver(backend, &pkt) ||
+            !capture_sink_flush(&backend->sink)) {
+            return false;
+        }
+    }
+
+    if (!atomic_load_explicit(&backend->running, memory_order_relaxed)) {
+        return false;
+    }
+    if (ret < 0) {
+        backend->base.error_cb("Failed to read capture file with io_uring", backend->base.error_user_data);
+        return false;
+    }
+    return true;
+}
+
+// 重放 loops 遍，数据包经 replay->sink 交付
+static int replay_run(struct replay_backend* replay) {
+    clock_gettime(CLOCK_REALTIME, &replay->start_time);
+    capture_backend_enter(&replay->base, &replay->running);
+
+    int ret = CAPTURE_SUCCESS;
+    for (uint32_t pass = 0; pass < replay->loops; pass++) {
+        if (replay->reader_type == REPLAY_READER_MMAP) {
+            if (!replay_pass_mmap(replay)) {
+                break;
+            }
+            continue;
+        }
+
+        if (replay->reader_type == REPLAY_READER_IO_URING) {
+            if (pass > 0 && (ret = replay_open_uring(replay)) != CAPTURE_SUCCESS) {
+                break;
+            }
+            if (!replay_pass_uring(replay)) {
+                break;
+            }
+            continue;
+        }
+
+        // 第二遍起需要重新打开文件
+        if (pass > 0 && (ret = replay_open(replay)) != CAPTURE_SUCCESS) {
+            break;
+        }
+        if (!replay_pass_libpcap(replay)) {
+            break;
+        }
+    }
+
+    atomic_store(&replay->running, false);
+
+    uint64_t drain;
+    while (read(replay->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+
+    clock_gettime(CLOCK_REALTIME, &replay->end_time);
+    return ret;
+}
+
+static int replay_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_sink_init(&replay->sink, callback, NULL, 0, user_data, &replay->counters);
+    return replay_run(replay);
+}
+
+static int replay_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (capture_sink_init(&replay->sink, NULL, callback, burst_size, user_data, &replay->counters) != CAPTURE_SUCCESS) {
+        replay->base.error_cb("Failed to allocate packet batch", replay->base.error_user_data);
+        return CAPTURE_ERROR_MEMORY;
+    }
+    int ret = replay_run(replay);
+    capture_sink_destroy(&replay->sink);
+    return ret;
+}
+
+// 拉取模式下读出下一条通过过滤的数据包，必要时开始下一遍；返回 1 成功，0 重放完毕，负值为错误码
+static int replay_pull_read(struct replay_backend* backend, packet_t* pkt) {
+    for (;;) {
+        replay_take_filter(backend);
+        int ret;
+        if (backend->reader_type == REPLAY_READER_MMAP) {
+            if (backend->pull_index < backend->first_packet + backend->packet_count) {
+                if (pcap_mmap_reader_get(backend->reader, (size_t)backend->pull_index++, pkt) != CAPTURE_SUCCESS) {
+                    backend->base.error_cb("Corrupt record in mapped capture file", backend->base.error_user_data);
+                    return -CAPTURE_ERROR_BACKEND;
+                }
+                ret = 1;
+            } else {
+                ret = 0;
+            }
+        } else if (backend->reader_type == REPLAY_READER_IO_URING) {
+            ret = pcap_uring_reader_next(backend->uring, pkt);
+            if (ret < 0) {
+                backend->base.error_cb("Failed to read capture file with io_uring", backend->base.error_user_data);
+                return -CAPTURE_ERROR_BACKEND;
+            }
+        } else {
+            struct pcap_pkthdr* header;
+            const u_char* data;
+            ret = pcap_next_ex(backend->handle, &header, &data);
+            if (ret == -1) {
+                backend->base.error_cb(pcap_geterr(backend->handle), backend->base.error_user_data);
+                return -CAPTURE_ERROR_BACKEND;
+            }
+            if (ret == 1) {
+                memset(pkt, 0, sizeof(*pkt));
+                pkt->data = data;
+                pkt->len = header->len;
+                pkt->caplen = header->caplen;
+                pkt->ts.tv_sec = header->ts.tv_sec;
+                pkt->ts.tv_nsec = header->ts.tv_usec;
+                // libpcap 已在内核态过滤，无需再匹配
+                packet_decode(pkt, backend->linktype);
+                return 1;
+            }
+            ret = 0;
+        }
+
+        if (ret == 1) {
+            if (replay_match(backend, pkt)) {
+                packet_decode(pkt, backend->linktype);
+                return 1;
+            }
+            continue;
+        }
+
+        // 本遍结束，开始下一遍
+        if (++backend->pull_pass >= backend->loops) {
+            return 0;
+        }
+        memset(&backend->pull_clock, 0, sizeof(backend->pull_clock));
+        if (backend->reader_type == REPLAY_READER_MMAP) {
+            backend->pull_index = backend->first_packet;
+        } else if (backend->reader_type == REPLAY_READER_IO_URING) {
+            if ((ret = replay_open_uring(backend)) != CAPTURE_SUCCESS) {
+                return -ret;
+            }
+        } else if ((ret = replay_open(backend)) != CAPTURE_SUCCESS) {
+            return -ret;
+        }
+    }
+}
+
+// 拉取模式：按速度模式在超时内交付已到时间的数据包。映射读取的数据包在
+// 映射期间一直有效，可以一次返回多个；其余读取器下一次读取会覆盖缓冲区，
+// 每次最多返回一个
+static int replay_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || !packets || max == 0) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (!replay->pull_started) {
+        replay->pull_started = true;
+        replay->pull_index = replay->first_packet;
+        clock_gettime(CLOCK_REALTIME, &replay->start_time);
+    }
+    if (replay->pull_done) {
+        return -CAPTURE_ERROR_EOF;
+    }
+    if (atomic_load_explicit(&replay->paused, memory_order_relaxed)) {
+        return 0;
+    }
+
+    uint32_t n = 0;
+    uint64_t bytes = 0;
+    bool waited = false;
+    while (n < max && (n == 0 || replay->reader_type == REPLAY_READER_MMAP)) {
+        if (!replay->pull_has_pending) {
+            int ret = replay_pull_read(replay, &replay->pull_pending);
+            if (ret < 0) {
+                return n > 0 ? (int)n : ret;
+            }
+            if (ret == 0) {
+                replay->pull_done = true;
+                clock_gettime(CLOCK_REALTIME, &replay->end_time);
+                if (n == 0) {
+                    return -CAPTURE_ERROR_EOF;
+                }
+                break;
+            }
+            replay->pull_has_pending = true;
+        }
+
+        if (replay->mode != REPLAY_SPEED_FASTEST) {
+            replay_clock_t* clock = &replay->pull_clock;
+            int64_t pkt_ns = replay_ts_ns(&replay->pull_pending.ts);
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (!clock->have_base) {
+                clock->file_base = pkt_ns;
+                clock->wall_base = replay_ts_ns(&now);
+                clock->have_base = true;
+            }
+            int64_t due = clock->wall_base + (int64_t)((double)(pkt_ns - clock->file_base) / replay->speed);
+            if (due > replay_ts_ns(&now)) {
+                // 已有数据包时立即返回，否则在超时内等待交付时间
+                if (n > 0 || timeout_ms == 0 || waited) {
+                    break;
+                }
+                int64_t deadline = due;
+                if (timeout_ms > 0 && replay_ts_ns(&now) + (int64_t)timeout_ms * 1000000 < due) {
+                    deadline = replay_ts_ns(&now) + (int64_t)timeout_ms * 1000000;
+                }
+                // 停止请求由下一次 capture_next_batch 清除，stop 写入的唤醒事件由等待自行读掉
+                waited = true;
+                if (!replay_wait_until(replay, deadline)) {
+                    break;
+                }
+                continue;
+            }
+        }
+
+        packets[n++] = replay->pull_pending;
+        replay->pull_has_pending = false;
+        bytes += replay->pull_pending.len;
+    }
+    if (n > 0) {
+        capture_counters_batch(&replay->counters, n, bytes);
+    }
+    return (int)n;
+}
+
+// 映射读取的数据包直接指向文件映射，在后端销毁前一直有效，租用无需任何操作
+static int replay_lease(void* backend, const packet_t* packet) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || replay->reader_type != REPLAY_READER_MMAP) {
+        return CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static int replay_stop(void* backend) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&replay->base, &replay->running);
+
+    uint64_t one = 1;
+    if (write(replay->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        return CAPTURE_ERROR_STOP_FAILED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static int replay_pause(void* backend) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&replay->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int replay_resume(void* backend) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&replay->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int replay_set_filter(void* backend, const char* filter) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    struct bpf_program fp;
+    int ret = replay_compile(replay, replay->linktype, filter, &fp);
+    if (ret != CAPTURE_SUCCESS) {
+        return ret;
+    }
+
+    // 过滤程序由读取线程在读下一个数据包前换上，重放不中断
+    pthread_mutex_lock(&replay->filter_lock);
+    if (atomic_load_explicit(&replay->has_pending, memory_order_relaxed)) {
+        pcap_freecode(&replay->pending);
+    }
+    replay->pending = fp;
+    atomic_store_explicit(&replay->has_pending, true, memory_order_release);
+    free(replay->filter);
+    replay->filter = strdup(filter);
+    pthread_mutex_unlock(&replay->filter_lock);
+    return CAPTURE_SUCCESS;
+}
+
+static int replay_get_stats(void* backend, capture_stats_t* stats) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    stats->packets_dropped = 0;
+    stats->packets_if_dropped = 0;
+    stats->start_time = replay->start_time;
+    stats->end_time = replay->end_time;
+    capture_counters_merge(&replay->counters, stats);
+    return CAPTURE_SUCCESS;
+}
+
+static const char* replay_get_name(void* backend) {
+    return "replay";
+}
+
+static const char* replay_get_version(void* backend) {
+    return pcap_lib_version();
+}
+
+static const char* replay_get_description(void* backend) {
+    return "Offline pcap/pcapng file replay backend";
+}
+
+static bool replay_is_feature_supported(void* backend, const char* feature) {
+    struct replay_backend* replay = (struct replay_backend*)backend;
+    if (!replay || !feature) {
+        return false;
+    }
+    return strcmp(feature, "filter") == 0 ||
+           strcmp(feature, "offline") == 0 ||
+           strcmp(feature, "batch") == 0 ||
+           (strcmp(feature, "lease") == 0 && replay->reader_type == REPLAY_READER_MMAP);
+}
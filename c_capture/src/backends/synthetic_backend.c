@@ -0,0 +1,832 @@
+#include <pcap.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <stdatomic.h>
+#include "../../include/backends/synthetic_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+#define SYNTHETIC_ETH_HLEN      14
+#define SYNTHETIC_IPV4_HLEN     20
+#define SYNTHETIC_IPV6_HLEN     40
+#define SYNTHETIC_FRAG6_HLEN    8
+#define SYNTHETIC_TCP_HLEN      20
+#define SYNTHETIC_UDP_HLEN      8
+#define SYNTHETIC_QUEUE_SLOTS   128  // 一个数据报最多产生的帧数（MTU 下限 576 时约 120 片）
+#define SYNTHETIC_PACE_BATCH    32   // 每隔多少个数据包检查一次限速时钟
+#define SYNTHETIC_PAUSE_POLL_MS 10   // 暂停时的轮询间隔
+
+#define SYNTHETIC_TCP_FIN  0x01
+#define SYNTHETIC_TCP_SYN  0x02
+#define SYNTHETIC_TCP_PSH  0x08
+#define SYNTHETIC_TCP_ACK  0x10
+
+// 一条合成流
+typedef struct {
+    bool ipv6;                       // 是否为 IPv6
+    bool tcp;                        // 是否为 TCP
+    bool established;                // TCP 是否已发出 SYN
+    uint8_t src[16];                 // 源地址（IPv4 使用前 4 字节）
+    uint8_t dst[16];                 // 目的地址
+    uint16_t sport;                  // 源端口
+    uint16_t dport;                  // 目的端口
+    uint16_t ip_id;                  // IPv4 标识
+    uint32_t seq;                    // TCP 序列号
+    uint32_t remaining;              // 剩余数据包数
+} synthetic_flow_t;
+
+struct synthetic_backend {
+    capture_backend_t base;          // 基础后端结构
+    synthetic_backend_config_t config; // 归一化后的配置
+    char* filter;                    // 过滤器
+    struct bpf_program program;      // 用户态执行的过滤程序，只由生成线程访问
+    bool has_program;                // 是否已编译过滤程序
+    pthread_mutex_t filter_lock;     // 保护过滤器与待换上的过滤程序
+    struct bpf_program pending;      // set_filter 编译好、等待生成线程换上的过滤程序
+    atomic_bool has_pending;         // 是否有待换上的过滤程序
+    int wake_fd;                     // 用于打断限速等待的 eventfd
+    uint64_t rng;                    // 随机数状态
+    uint32_t frag6_id;               // IPv6 分片标识
+    synthetic_flow_t* flows;         // 流表
+    uint8_t* scratch;                // L4 数据报构造缓冲区
+    uint8_t* slab;                   // 帧缓冲区
+    uint8_t* frames[SYNTHETIC_QUEUE_SLOTS]; // 待交付帧
+    uint32_t frame_lens[SYNTHETIC_QUEUE_SLOTS]; // 待交付帧长度
+    uint32_t queued;                 // 待交付帧数
+    uint8_t* held;                   // 被推迟交付的帧
+    uint32_t held_len;               // 被推迟交付的帧长度
+    bool has_held;                   // 是否有被推迟的帧
+    uint32_t frame_capacity;         // 单帧缓冲区大小
+    packet_callback_t packet_cb;     // 数据包回调
+    void* user_data;                 // 用户数据
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    uint64_t generated;              // 已生成的数据包数
+    uint64_t run_base;               // 本次启动时的 generated
+    capture_counters_t counters;     // 交付计数
+    int64_t wall_base;               // 限速基准（单调时钟）
+    struct timespec ts_base;         // 时间戳基准（实时时钟）
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// 内部函数声明
+static void synthetic_cleanup(void* backend);
+static int synthetic_start(void* backend, packet_callback_t callback, void* user_data);
+static int synthetic_stop(void* backend);
+static int synthetic_pause(void* backend);
+static int synthetic_resume(void* backend);
+static int synthetic_set_filter(void* backend, const char* filter);
+static int synthetic_get_stats(void* backend, capture_stats_t* stats);
+static const char* synthetic_get_name(void* backend);
+static const char* synthetic_get_version(void* backend);
+static const char* synthetic_get_description(void* backend);
+static bool synthetic_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t synthetic_backend_ops = {
+    .cleanup = synthetic_cleanup,
+    .start = synthetic_start,
+    .stop = synthetic_stop,
+    .pause = synthetic_pause,
+    .resume = synthetic_resume,
+    .set_filter = synthetic_set_filter,
+    .get_stats = synthetic_get_stats,
+    .get_name = synthetic_get_name,
+    .get_version = synthetic_get_version,
+    .get_description = synthetic_get_description,
+    .is_feature_supported = synthetic_is_feature_supported,
+};
+
+// xorshift64* 伪随机数
+static uint64_t synthetic_rand(struct synthetic_backend* gen) {
+    uint64_t x = gen->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    gen->rng = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// [0, 1) 均匀分布
+static double synthetic_rand_unit(struct synthetic_backend* gen) {
+    return (double)(synthetic_rand(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static bool synthetic_chance(struct synthetic_backend* gen, double ratio) {
+    return ratio > 0.0 && synthetic_rand_unit(gen) < ratio;
+}
+
+static void synthetic_put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void synthetic_put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+// 以新的地址、端口和初始序列号重建一条流
+static void synthetic_flow_reset(struct synthetic_backend* gen, synthetic_flow_t* flow) {
+    static const uint16_t ports[] = { 80, 443, 53, 8080, 5060, 1935, 8443, 123 };
+    const synthetic_backend_config_t* cfg = &gen->config;
+
+    flow->ipv6 = synthetic_chance(gen, cfg->ipv6_ratio);
+    flow->tcp = synthetic_chance(gen, cfg->tcp_ratio);
+    flow->established = false;
+
+    uint64_t a = synthetic_rand(gen);
+    uint64_t b = synthetic_rand(gen);
+    memset(flow->src, 0, sizeof(flow->src));
+    memset(flow->dst, 0, sizeof(flow->dst));
+    if (flow->ipv6) {
+        // fd00::/8 唯一本地地址
+        flow->src[0] = 0xfd;
+        flow->dst[0] = 0xfd;
+        memcpy(flow->src + 8, &a, 8);
+        memcpy(flow->dst + 8, &b, 8);
+    } else {
+        // 10.0.0.0/8 私有地址
+        flow->src[0] = 10;
+        flow->dst[0] = 10;
+        memcpy(flow->src + 1, &a, 3);
+        memcpy(flow->dst + 1, &b, 3);
+    }
+
+    uint64_t r = synthetic_rand(gen);
+    flow->sport = (uint16_t)(1024 + r % 64000);
+    flow->dport = ports[(r >> 20) % (sizeof(ports) / sizeof(ports[0]))];
+    flow->ip_id = (uint16_t)(r >> 32);
+    flow->seq = (uint32_t)(r >> 24);
+    flow->remaining = 1 + (uint32_t)(synthetic_rand(gen) % (2 * (uint64_t)cfg->flow_packets));
+}
+
+// 按配置的分布抽取负载长度
+static uint32_t synthetic_payload_size(struct synthetic_backend* gen) {
+    const synthetic_backend_config_t* cfg = &gen->config;
+    switch (cfg->size_mode) {
+        case SYNTHETIC_SIZE_UNIFORM:
+            return cfg->min_payload +
+                   (uint32_t)(synthetic_rand(gen) % (cfg->max_payload - cfg->min_payload + 1));
+        case SYNTHETIC_SIZE_IMIX: {
+            uint32_t pick = (uint32_t)(synthetic_rand(gen) % 12);
+            return pick < 7 ? 18 : (pick < 11 ? 528 : 1472);
+        }
+        default:
+            return cfg->min_payload;
+    }
+}
+
+// 取得队尾帧缓冲区，写入后调用 synthetic_commit_frame
+static uint8_t* synthetic_tail_frame(struct synthetic_backend* gen) {
+    return gen->frames[gen->queued];
+}
+
+// 提交队尾帧；按乱序比例推迟到下一帧之后交付
+static void synthetic_commit_frame(struct synthetic_backend* gen, uint32_t len) {
+    uint32_t slot = gen->queued;
+
+    if (!gen->has_held && synthetic_chance(gen, gen->config.reorder_ratio)) {
+        // 与推迟缓冲区交换所有权，该帧会排在下一帧之后
+        uint8_t* tmp = gen->held;
+        gen->held = gen->frames[slot];
+        gen->held_len = len;
+        gen->frames[slot] = tmp;
+        gen->has_held = true;
+        return;
+    }
+
+    gen->frame_lens[slot] = len;
+    gen->queued++;
+
+    if (gen->has_held && gen->queued < SYNTHETIC_QUEUE_SLOTS) {
+        uint8_t* tmp = gen->frames[gen->queued];
+        gen->frames[gen->queued] = gen->held;
+        gen->frame_lens[gen->queued] = gen->held_len;
+        gen->held = tmp;
+        gen->has_held = false;
+        gen->queued++;
+    }
+}
+
+// 写以太网头和 IP 头，返回 IP 负载的起始位置
+static uint8_t* synthetic_write_headers(
+    struct synthetic_backend* gen,
+    synthetic_flow_t* flow,
+    uint8_t* frame,
+    uint8_t proto,
+    uint32_t ip_payload_len,
+    bool fragment,
+    uint32_t frag_offset,
+    bool more_fragments
+) {
+    static const uint8_t macs[12] = {
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x02,
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+    };
+    memcpy(frame, macs, sizeof(macs));
+    uint8_t* ip = frame + SYNTHETIC_ETH_HLEN;
+
+    if (flow->ipv6) {
+        synthetic_put16(frame + 12, 0x86DD);
+        uint32_t ext = fragment ? SYNTHETIC_FRAG6_HLEN : 0;
+        synthetic_put32(ip, 0x60000000u);
+        synthetic_put16(ip + 4, (uint16_t)(ip_payload_len + ext));
+        ip[6] = fragment ? 44 : proto;
+        ip[7] = 64;
+        memcpy(ip + 8, flow->src, 16);
+        memcpy(ip + 24, flow->dst, 16);
+        if (!fragment) {
+            return ip + SYNTHETIC_IPV6_HLEN;
+        }
+        uint8_t* frag = ip + SYNTHETIC_IPV6_HLEN;
+        frag[0] = proto;
+        frag[1] = 0;
+        synthetic_put16(frag + 2, (uint16_t)(frag_offset | (more_fragments ? 1 : 0)));
+        synthetic_put32(frag + 4, gen->frag6_id);
+        return frag + SYNTHETIC_FRAG6_HLEN;
+    }
+
+    synthetic_put16(frame + 12, 0x0800);
+    ip[0] = 0x45;
+    ip[1] = 0;
+    synthetic_put16(ip + 2, (uint16_t)(SYNTHETIC_IPV4_HLEN + ip_payload_len));
+    synthetic_put16(ip + 4, flow->ip_id);
+    synthetic_put16(ip + 6, (uint16_t)((more_fragments ? 0x2000 : 0) | (frag_offset >> 3)));
+    ip[8] = 64;
+    ip[9] = proto;
+    ip[10] = 0;
+    ip[11] = 0;
+    memcpy(ip + 12, flow->src, 4);
+    memcpy(ip + 16, flow->dst, 4);
+
+    uint32_t sum = 0;
+    for (int i = 0; i < SYNTHETIC_IPV4_HLEN; i += 2) {
+        sum += (uint32_t)(ip[i] << 8 | ip[i + 1]);
+    }
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    synthetic_put16(ip + 10, (uint16_t)~sum);
+    return ip + SYNTHETIC_IPV4_HLEN;
+}
+
+// 把 scratch 中的 L4 数据报封装成一个或多个帧
+static void synthetic_emit_datagram(struct synthetic_backend* gen, synthetic_flow_t* flow, uint8_t proto, uint32_t l4_len) {
+    uint32_t ip_hlen = flow->ipv6 ? SYNTHETIC_IPV6_HLEN : SYNTHETIC_IPV4_HLEN;
+    uint32_t frag_hlen = flow->ipv6 ? SYNTHETIC_FRAG6_HLEN : 0;
+    uint32_t mtu = gen->config.mtu;
+
+    bool oversize = ip_hlen + l4_len > mtu;
+    if (!oversize && (l4_len < 16 || !synthetic_chance(gen, gen->config.fragment_ratio))) {
+        uint8_t* frame = synthetic_tail_frame(gen);
+        uint8_t* payload = synthetic_write_headers(gen, flow, frame, proto, l4_len, false, 0, false);
+        memcpy(payload, gen->scratch, l4_len);
+        synthetic_commit_frame(gen, (uint32_t)(payload - frame) + l4_len);
+        flow->ip_id++;
+        return;
+    }
+
+    // 分片负载长度必须是 8 的整数倍
+    uint32_t max_piece = (mtu - ip_hlen - frag_hlen) & ~7u;
+    uint32_t piece = max_piece;
+    if (!oversize) {
+        // 主动分片时拆成 2~4 片
+        uint32_t parts = 2 + (uint32_t)(synthetic_rand(gen) % 3);
+        piece = ((l4_len + parts - 1) / parts + 7) & ~7u;
+        if (piece > max_piece) {
+            piece = max_piece;
+        }
+    }
+
+    gen->frag6_id++;
+    for (uint32_t offset = 0; offset < l4_len; offset += piece) {
+        uint32_t len = l4_len - offset < piece ? l4_len - offset : piece;
+        bool more = offset + len < l4_len;
+        uint8_t* frame = synthetic_tail_frame(gen);
+        uint8_t* payload = synthetic_write_headers(gen, flow, frame, proto, len, true, offset, more);
+        memcpy(payload, gen->scratch + offset, len);
+        synthetic_commit_frame(gen, (uint32_t)(payload - frame) + len);
+    }
+    flow->ip_id++;
+}
+
+// 写 TCP 段到 scratch，负载按流偏移填充
+static uint32_t synthetic_build_tcp(synthetic_flow_t* flow, uint8_t* out, uint8_t flags, uint32_t payload_len) {
+    synthetic_put16(out, flow->sport);
+    synthetic_put16(out + 2, flow->dport);
+    synthetic_put32(out + 4, flow->seq);
+    synthetic_put32(out + 8, (flags & SYNTHETIC_TCP_ACK) ? 1 : 0);
+    out[12] = (SYNTHETIC_TCP_HLEN / 4) << 4;
+    out[13] = flags;
+    synthetic_put16(out + 14, 65535);
+    synthetic_put16(out + 16, 0);
+    synthetic_put16(out + 18, 0);
+
+    uint8_t* payload = out + SYNTHETIC_TCP_HLEN;
+    for (uint32_t i = 0; i < payload_len; i++) {
+        payload[i] = (uint8_t)(flow->seq + i);
+    }
+    return SYNTHETIC_TCP_HLEN + payload_len;
+}
+
+// 写 UDP 数据报到 scratch
+static uint32_t synthetic_build_udp(synthetic_flow_t* flow, uint8_t* out, uint32_t payload_len) {
+    uint32_t len = SYNTHETIC_UDP_HLEN + payload_len;
+    synthetic_put16(out, flow->sport);
+    synthetic_put16(out + 2, flow->dport);
+    synthetic_put16(out + 4, (uint16_t)len);
+    synthetic_put16(out + 6, 0);
+    memset(out + SYNTHETIC_UDP_HLEN, (uint8_t)flow->ip_id, payload_len);
+    return len;
+}
+
+// 生成下一个数据报的帧到待交付队列
+static void synthetic_generate(struct synthetic_backend* gen) {
+    for (;;) {
+        synthetic_flow_t* flow = &gen->flows[synthetic_rand(gen) % gen->config.flow_count];
+
+        if (!flow->tcp) {
+            uint32_t len = synthetic_build_udp(flow, gen->scratch, synthetic_payload_size(gen));
+            synthetic_emit_datagram(gen, flow, 17, len);
+            if (--flow->remaining == 0) {
+                synthetic_flow_reset(gen, flow);
+            }
+            return;
+        }
+
+        if (!flow->established) {
+            uint32_t len = synthetic_build_tcp(flow, gen->scratch, SYNTHETIC_TCP_SYN, 0);
+            synthetic_emit_datagram(gen, flow, 6, len);
+            flow->seq++;
+            flow->established = true;
+            return;
+        }
+
+        if (flow->remaining == 0) {
+            uint32_t len = synthetic_build_tcp(flow, gen->scratch, SYNTHETIC_TCP_FIN | SYNTHETIC_TCP_ACK, 0);
+            synthetic_emit_datagram(gen, flow, 6, len);
+            synthetic_flow_reset(gen, flow);
+            return;
+        }
+
+        uint32_t payload_len = synthetic_payload_size(gen);
+        flow->remaining--;
+        if (synthetic_chance(gen, gen->config.tcp_gap_ratio)) {
+            // 跳过该段，只推进序列号，在流中留下空洞
+            flow->seq += payload_len;
+            continue;
+        }
+
+        uint32_t len = synthetic_build_tcp(flow, gen->scratch, SYNTHETIC_TCP_ACK | SYNTHETIC_TCP_PSH, payload_len);
+        synthetic_emit_datagram(gen, flow, 6, len);
+        flow->seq += payload_len;
+        return;
+    }
+}
+
+static int64_t synthetic_ts_ns(const struct timespec* ts) {
+    return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+// 读掉唤醒事件，残留的事件会让 poll 一直立即返回；是否停止由运行标志决定
+static void synthetic_drain_wake(struct synthetic_backend* gen) {
+    uint64_t drain;
+    while (read(gen->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+}
+
+// 等待到单调时钟上的 deadline，被 stop 唤醒时返回 false
+static bool synthetic_wait_until(struct synthetic_backend* gen, int64_t deadline_ns) {
+    struct pollfd pfd = { .fd = gen->wake_fd, .events = POLLIN };
+
+    while (atomic_load_explicit(&gen->running, memory_order_relaxed)) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t remaining = deadline_ns - synthetic_ts_ns(&now);
+        if (remaining <= 0) {
+            return true;
+        }
+
+        struct timespec timeout = {
+            .tv_sec = remaining / NSEC_PER_SEC,
+            .tv_nsec = remaining % NSEC_PER_SEC,
+        };
+        if (ppoll(&pfd, 1, &timeout, NULL) > 0) {
+            synthetic_drain_wake(gen);
+        }
+    }
+    return false;
+}
+
+// 计算第 index 个数据包的时间戳；限速时按虚拟时间轴，否则按实际时间
+static void synthetic_timestamp(struct synthetic_backend* gen, uint64_t index, struct timespec* ts) {
+    if (gen->config.rate_pps) {
+        int64_t ns = synthetic_ts_ns(&gen->ts_base) +
+                     (int64_t)((double)index * (double)NSEC_PER_SEC / (double)gen->config.rate_pps);
+        ts->tv_sec = ns / NSEC_PER_SEC;
+        ts->tv_nsec = ns % NSEC_PER_SEC;
+        return;
+    }
+    if (index % SYNTHETIC_PACE_BATCH == 0) {
+        clock_gettime(CLOCK_REALTIME, &gen->ts_base);
+    }
+    *ts = gen->ts_base;
+}
+
+// 按目标速率节流，被停止时返回 false
+static bool synthetic_pace(struct synthetic_backend* gen, uint64_t index) {
+    if (!gen->config.rate_pps || index % SYNTHETIC_PACE_BATCH != 0) {
+        return true;
+    }
+    int64_t offset = (int64_t)((double)index * (double)NSEC_PER_SEC / (double)gen->config.rate_pps);
+    return synthetic_wait_until(gen, gen->wall_base + offset);
+}
+
+// 生成线程在过滤下一个帧之前换上 set_filter 编译好的过滤程序
+static void synthetic_take_filter(struct synthetic_backend* gen) {
+    if (!atomic_load_explicit(&gen->has_pending, memory_order_acquire)) {
+        return;
+    }
+
+    pthread_mutex_lock(&gen->filter_lock);
+    if (gen->has_program) {
+        pcap_freecode(&gen->program);
+    }
+    gen->program = gen->pending;
+    gen->has_program = true;
+    atomic_store_explicit(&gen->has_pending, false, memory_order_relaxed);
+    pthread_mutex_unlock(&gen->filter_lock);
+}
+
+// 交付一个帧，返回 false 表示回调要求停止
+static bool synthetic_deliver(struct synthetic_backend* gen, const uint8_t* frame, uint32_t len) {
+    packet_t pkt = {
+        .data = frame,
+        .len = len,
+        .caplen = len,
+        .if_index = 0,
+        .flags = 0,
+        .protocol = 0,
+        .vlan_tci = 0,
+        .hash = 0,
+    };
+    synthetic_timestamp(gen, gen->generated - gen->run_base, &pkt.ts);
+    gen->generated++;
+
+    synthetic_take_filter(gen);
+    if (gen->has_program) {
+        struct pcap_pkthdr header = {
+            .caplen = pkt.caplen,
+            .len = pkt.len,
+        };
+        if (!pcap_offline_filter(&gen->program, &header, pkt.data)) {
+            return true;
+        }
+    }
+
+    packet_decode(&pkt, PACKET_LINKTYPE_ETHERNET);
+    capture_counters_packet(&gen->counters, len);
+    return gen->packet_cb(&pkt, gen->user_data);
+}
+
+// 为过滤器编译以太网链路类型的 BPF 程序
+static int synthetic_compile(struct synthetic_backend* gen, const char* filter, struct bpf_program* fp) {
+    pcap_t* dead = pcap_open_dead(DLT_EN10MB, 65535);
+    if (!dead) {
+        gen->base.error_cb("Failed to open dead pcap handle", gen->base.error_user_data);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+
+    if (pcap_compile(dead, fp, filter, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+        gen->base.error_cb(pcap_geterr(dead), gen->base.error_user_data);
+        pcap_close(dead);
+        return CAPTURE_ERROR_SET_FILTER;
+    }
+    pcap_close(dead);
+    return CAPTURE_SUCCESS;
+}
+
+static void synthetic_release(struct synthetic_backend* gen) {
+    if (gen->has_program) {
+        pcap_freecode(&gen->program);
+    }
+    if (atomic_load(&gen->has_pending)) {
+        pcap_freecode(&gen->pending);
+    }
+    pthread_mutex_destroy(&gen->filter_lock);
+    if (gen->wake_fd >= 0) {
+        close(gen->wake_fd);
+    }
+    free(gen->flows);
+    free(gen->scratch);
+    free(gen->slab);
+    free(gen->filter);
+    free(gen);
+}
+
+// 校验比例参数并填充默认值
+static bool synthetic_normalize(synthetic_backend_config_t* cfg, error_callback_t error_cb, void* error_user_data) {
+    const double ratios[] = {
+        cfg->ipv6_ratio, cfg->tcp_ratio, cfg->fragment_ratio, cfg->reorder_ratio, cfg->tcp_gap_ratio,
+    };
+    for (size_t i = 0; i < sizeof(ratios) / sizeof(ratios[0]); i++) {
+        if (!(ratios[i] >= 0.0 && ratios[i] <= 1.0)) {
+            error_cb("Synthetic traffic ratios must be within [0, 1]", error_user_data);
+            return false;
+        }
+    }
+
+    if (!cfg->flow_count) {
+        cfg->flow_count = SYNTHETIC_DEFAULT_FLOW_COUNT;
+    }
+    if (!cfg->flow_packets) {
+        cfg->flow_packets = SYNTHETIC_DEFAULT_FLOW_PACKETS;
+    }
+    if (!cfg->min_payload) {
+        cfg->min_payload = SYNTHETIC_DEFAULT_MIN_PAYLOAD;
+    }
+    if (!cfg->max_payload) {
+        cfg->max_payload = cfg->min_payload > SYNTHETIC_DEFAULT_MAX_PAYLOAD
+            ? cfg->min_payload : SYNTHETIC_DEFAULT_MAX_PAYLOAD;
+    }
+    if (!cfg->mtu) {
+        cfg->mtu = SYNTHETIC_DEFAULT_MTU;
+    }
+    if (!cfg->seed) {
+        cfg->seed = SYNTHETIC_DEFAULT_SEED;
+    }
+
+    if (cfg->min_payload > cfg->max_payload || cfg->max_payload > SYNTHETIC_MAX_PAYLOAD) {
+        error_cb("Invalid synthetic payload size range", error_user_data);
+        return false;
+    }
+    if (cfg->mtu < SYNTHETIC_MIN_MTU || cfg->mtu > SYNTHETIC_MAX_MTU) {
+        error_cb("Synthetic MTU out of range", error_user_data);
+        return false;
+    }
+    return true;
+}
+
+// 创建合成流量后端
+capture_backend_t* synthetic_backend_create(
+    const synthetic_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !error_cb) {
+        return NULL;
+    }
+
+    synthetic_backend_config_t cfg = *config;
+    if (!synthetic_normalize(&cfg, error_cb, error_user_data)) {
+        return NULL;
+    }
+
+    struct synthetic_backend* gen = calloc(1, sizeof(struct synthetic_backend));
+    if (!gen) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    gen->base.private_data = gen;
+    gen->base.ops = &synthetic_backend_ops;
+    gen->base.type = CAPTURE_BACKEND_SYNTHETIC;
+    gen->base.error_cb = error_cb;
+    gen->base.error_user_data = error_user_data;
+
+    gen->config = cfg;
+    gen->config.filter = NULL;
+    gen->filter = cfg.filter ? strdup(cfg.filter) : NULL;
+    gen->wake_fd = -1;
+    atomic_init(&gen->running, false);
+    atomic_init(&gen->paused, false);
+    atomic_init(&gen->has_pending, false);
+    pthread_mutex_init(&gen->filter_lock, NULL);
+
+    // 每个帧槽容纳一个 MTU 大小的以太网帧，另加一个推迟交付槽
+    gen->frame_capacity = cfg.mtu + SYNTHETIC_ETH_HLEN;
+    gen->flows = calloc(cfg.flow_count, sizeof(synthetic_flow_t));
+    gen->scratch = malloc(SYNTHETIC_TCP_HLEN + SYNTHETIC_MAX_PAYLOAD);
+    gen->slab = malloc((size_t)gen->frame_capacity * (SYNTHETIC_QUEUE_SLOTS + 1));
+    if (!gen->flows || !gen->scratch || !gen->slab) {
+        error_cb("Failed to allocate synthetic generator state", error_user_data);
+        synthetic_release(gen);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < SYNTHETIC_QUEUE_SLOTS; i++) {
+        gen->frames[i] = gen->slab + (size_t)i * gen->frame_capacity;
+    }
+    gen->held = gen->slab + (size_t)SYNTHETIC_QUEUE_SLOTS * gen->frame_capacity;
+
+    gen->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (gen->wake_fd < 0) {
+        error_cb("Failed to create eventfd", error_user_data);
+        synthetic_release(gen);
+        return NULL;
+    }
+
+    if (gen->filter) {
+        if (synthetic_compile(gen, gen->filter, &gen->program) != CAPTURE_SUCCESS) {
+            synthetic_release(gen);
+            return NULL;
+        }
+        gen->has_program = true;
+    }
+
+    gen->rng = cfg.seed;
+    for (uint32_t i = 0; i < cfg.flow_count; i++) {
+        synthetic_flow_reset(gen, &gen->flows[i]);
+    }
+
+    return &gen->base;
+}
+
+// 销毁合成流量后端
+void synthetic_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    synthetic_release((struct synthetic_backend*)backend);
+}
+
+static void synthetic_cleanup(void* backend) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen) {
+        return;
+    }
+    if (atomic_load(&gen->running)) {
+        synthetic_stop(gen);
+    }
+    synthetic_release(gen);
+}
+
+static int synthetic_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen || !callback) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    gen->packet_cb = callback;
+    gen->user_data = user_data;
+    clock_gettime(CLOCK_REALTIME, &gen->start_time);
+    gen->ts_base = gen->start_time;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    gen->wall_base = synthetic_ts_ns(&now);
+    capture_backend_enter(&gen->base, &gen->running);
+
+    uint64_t limit = gen->config.packet_count;
+    uint64_t base = gen->generated;
+    gen->run_base = base;
+    bool keep_going = true;
+
+    while (keep_going && atomic_load_explicit(&gen->running, memory_order_relaxed)) {
+        if (atomic_load_explicit(&gen->paused, memory_order_relaxed)) {
+            // 暂停期间不生成数据包
+            struct pollfd pfd = { .fd = gen->wake_fd, .events = POLLIN };
+            if (poll(&pfd, 1, SYNTHETIC_PAUSE_POLL_MS) > 0) {
+                synthetic_drain_wake(gen);
+            }
+            continue;
+        }
+
+        if (gen->queued == 0) {
+            if (limit && gen->generated - base >= limit) {
+                break;
+            }
+            synthetic_generate(gen);
+        }
+
+        // 交付队列中的帧，按 packet_count 截断
+        uint32_t i = 0;
+        for (; i < gen->queued && keep_going; i++) {
+            if (limit && gen->generated - base >= limit) {
+                break;
+            }
+            if (!synthetic_pace(gen, gen->generated - base)) {
+                keep_going = false;
+                break;
+            }
+            keep_going = synthetic_deliver(gen, gen->frames[i], gen->frame_lens[i]);
+        }
+        if (i < gen->queued) {
+            // 停止时丢弃剩余帧
+            gen->queued = 0;
+            gen->has_held = false;
+            break;
+        }
+        gen->queued = 0;
+    }
+
+    atomic_store(&gen->running, false);
+
+    uint64_t drain;
+    while (read(gen->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+
+    clock_gettime(CLOCK_REALTIME, &gen->end_time);
+    return CAPTURE_SUCCESS;
+}
+
+static int synthetic_stop(void* backend) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&gen->base, &gen->running);
+
+    uint64_t one = 1;
+    if (write(gen->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        return CAPTURE_ERROR_STOP_FAILED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static int synthetic_pause(void* backend) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&gen->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int synthetic_resume(void* backend) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&gen->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int synthetic_set_filter(void* backend, const char* filter) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen || !filter) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    struct bpf_program fp;
+    int ret = synthetic_compile(gen, filter, &fp);
+    if (ret != CAPTURE_SUCCESS) {
+        return ret;
+    }
+
+    // 过滤程序由生成线程在过滤下一个帧前换上，生成不中断
+    pthread_mutex_lock(&gen->filter_lock);
+    if (atomic_load_explicit(&gen->has_pending, memory_order_relaxed)) {
+        pcap_freecode(&gen->pending);
+    }
+    gen->pending = fp;
+    atomic_store_explicit(&gen->has_pending, true, memory_order_release);
+    free(gen->filter);
+    gen->filter = strdup(filter);
+    pthread_mutex_unlock(&gen->filter_lock);
+    return CAPTURE_SUCCESS;
+}
+
+static int synthetic_get_stats(void* backend, capture_stats_t* stats) {
+    struct synthetic_backend* gen = (struct synthetic_backend*)backend;
+    if (!gen || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    stats->packets_dropped = 0;
+    stats->packets_if_dropped = 0;
+    stats->start_time = gen->start_time;
+    stats->end_time = gen->end_time;
+    capture_counters_merge(&gen->counters, stats);
+    return CAPTURE_SUCCESS;
+}
+
+static const char* synthetic_get_name(void* backend) {
+    return "synthetic";
+}
+
+static const char* synthetic_get_version(void* backend) {
+    return "1.0";
+}
+
+static const char* synthetic_get_description(void* backend) {
+    return "In-memory synthetic traffic generator backend";
+}
+
+static bool synthetic_is_feature_supported(void* backend, const char* feature) {
+    if (!feature) {
+        return false;
+    }
+    return strcmp(feature, "filter") == 0 ||
+           strcmp(feature, "offline") == 0;
+}
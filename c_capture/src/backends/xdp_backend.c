@@ -0,0 +1,859 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <stdatomic.h>
+#include "../../include/backends/xdp_backend.h"
+#include "../../include/capture_types.h"
+#include "../../include/packet_decode.h"
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+// 映射到用户空间的单个 AF_XDP 环
+typedef struct {
+    uint32_t* producer;              // 生产者索引
+    uint32_t* consumer;              // 消费者索引
+    uint32_t* flags;                 // 环标志（XDP_RING_NEED_WAKEUP）
+    void* descs;                     // 描述符数组
+    uint32_t mask;                   // 索引掩码
+    uint32_t size;                   // 环大小
+    void* map;                       // 映射起始地址
+    size_t map_len;                  // 映射长度
+} xdp_ring_t;
+
+struct xdp_backend {
+    capture_backend_t base;          // 基础后端结构
+    int fd;                          // AF_XDP 套接字
+    int wake_fd;                     // 用于唤醒 poll 的 eventfd
+    int map_fd;                      // XSKMAP
+    int prog_fd;                     // 重定向 XDP 程序
+    int link_fd;                     // XDP 程序与网卡之间的 bpf_link
+    int ifindex;                     // 接口索引
+    char* device;                    // 设备名称
+    uint32_t queue_id;               // 接收队列
+    uint8_t* umem;                   // UMEM 区域
+    size_t umem_size;                // UMEM 大小
+    uint32_t frame_size;             // 帧大小
+    uint32_t frame_count;            // 帧数量
+    uint32_t batch_size;             // 单次处理的最大描述符数
+    int timeout_ms;                  // 等待超时
+    xdp_ring_t rx;                   // RX 环
+    xdp_ring_t fill;                 // 填充环
+    xdp_ring_t comp;                 // 完成环
+    uint64_t* free_frames;           // 尚未放入填充环的空闲帧
+    uint32_t free_count;             // 空闲帧数量
+    atomic_uint* frame_refs;         // 每个帧的引用计数：交付中或被租用时非 0
+    pthread_mutex_t returned_lock;   // 保护 returned_frames
+    uint64_t* returned_frames;       // 其他线程归还、等待放回空闲帧的帧
+    uint32_t returned_count;         // 已归还帧数量
+    atomic_bool has_returned;        // 是否有待收回的已归还帧
+    capture_sink_t sink;             // 数据包交付器
+    uint32_t pull_pending;           // 拉取模式下已借出、尚未归还的描述符数
+    atomic_bool running;             // 是否正在运行
+    atomic_bool paused;              // 是否暂停
+    capture_counters_t counters;     // 交付计数
+    struct timespec start_time;      // 开始时间
+    struct timespec end_time;        // 结束时间
+};
+
+// 内部函数声明
+static void xdp_report(struct xdp_backend* backend, const char* what);
+static void xdp_release(struct xdp_backend* backend);
+static void xdp_cleanup(void* backend);
+static int xdp_start(void* backend, packet_callback_t callback, void* user_data);
+static int xdp_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data);
+static int xdp_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms);
+static int xdp_get_fd(void* backend);
+static int xdp_lease(void* backend, const packet_t* packet);
+static void xdp_release_packet(void* backend, const packet_t* packet);
+static int xdp_stop(void* backend);
+static int xdp_pause(void* backend);
+static int xdp_resume(void* backend);
+static int xdp_get_stats(void* backend, capture_stats_t* stats);
+static const char* xdp_get_name(void* backend);
+static const char* xdp_get_version(void* backend);
+static const char* xdp_get_description(void* backend);
+static bool xdp_is_feature_supported(void* backend, const char* feature);
+
+// 操作函数表
+static capture_backend_ops_t xdp_backend_ops = {
+    .cleanup = xdp_cleanup,
+    .start = xdp_start,
+    .start_batch = xdp_start_batch,
+    .next_batch = xdp_next_batch,
+    .get_fd = xdp_get_fd,
+    .lease = xdp_lease,
+    .release = xdp_release_packet,
+    .stop = xdp_stop,
+    .pause = xdp_pause,
+    .resume = xdp_resume,
+    .get_stats = xdp_get_stats,
+    .get_name = xdp_get_name,
+    .get_version = xdp_get_version,
+    .get_description = xdp_get_description,
+    .is_feature_supported = xdp_is_feature_supported,
+};
+
+static void xdp_report(struct xdp_backend* backend, const char* what) {
+    char msg[256];
+    snprintf(msg, sizeof(msg), "%s: %s", what, strerror(errno));
+    backend->base.error_cb(msg, backend->base.error_user_data);
+}
+
+static int xdp_bpf(int cmd, union bpf_attr* attr) {
+    return (int)syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+static bool xdp_is_pow2(uint32_t v) {
+    return v && !(v & (v - 1));
+}
+
+// 映射一个环，desc_size 为单个描述符的大小
+static int xdp_map_ring(struct xdp_backend* backend, xdp_ring_t* ring,
+                        const struct xdp_ring_offset* off, uint32_t size,
+                        size_t desc_size, off_t pgoff) {
+    ring->map_len = off->desc + (size_t)size * desc_size;
+    ring->map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, backend->fd, pgoff);
+    if (ring->map == MAP_FAILED) {
+        ring->map = NULL;
+        return -1;
+    }
+    ring->producer = (uint32_t*)((uint8_t*)ring->map + off->producer);
+    ring->consumer = (uint32_t*)((uint8_t*)ring->map + off->consumer);
+    ring->flags = (uint32_t*)((uint8_t*)ring->map + off->flags);
+    ring->descs = (uint8_t*)ring->map + off->desc;
+    ring->size = size;
+    ring->mask = size - 1;
+    return 0;
+}
+
+static void xdp_unmap_ring(xdp_ring_t* ring) {
+    if (ring->map) {
+        munmap(ring->map, ring->map_len);
+        ring->map = NULL;
+    }
+}
+
+// 收回租用者在其他线程归还的帧
+static void xdp_collect_returned(struct xdp_backend* backend) {
+    if (!atomic_load_explicit(&backend->has_returned, memory_order_acquire)) {
+        return;
+    }
+    pthread_mutex_lock(&backend->returned_lock);
+    for (uint32_t i = 0; i < backend->returned_count; i++) {
+        backend->free_frames[backend->free_count++] = backend->returned_frames[i];
+    }
+    backend->returned_count = 0;
+    atomic_store_explicit(&backend->has_returned, false, memory_order_relaxed);
+    pthread_mutex_unlock(&backend->returned_lock);
+}
+
+// 接收线程释放对帧的引用，没有租用者时直接放回空闲帧，否则由最后一次 release 归还
+static void xdp_frame_put(struct xdp_backend* backend, uint64_t addr) {
+    atomic_uint* refs = &backend->frame_refs[addr / backend->frame_size];
+    // 计数为 1 时只有接收线程持有，不会与 release 并发
+    if (atomic_load_explicit(refs, memory_order_acquire) == 1) {
+        atomic_store_explicit(refs, 0, memory_order_relaxed);
+        backend->free_frames[backend->free_count++] = addr;
+    } else if (atomic_fetch_sub_explicit(refs, 1, memory_order_acq_rel) == 1) {
+        backend->free_frames[backend->free_count++] = addr;
+    }
+}
+
+// 把空闲帧尽可能多地放回填充环
+static void xdp_refill(struct xdp_backend* backend) {
+    xdp_collect_returned(backend);
+
+    xdp_ring_t* fill = &backend->fill;
+    uint32_t prod = *fill->producer;
+    uint32_t cons = __atomic_load_n(fill->consumer, __ATOMIC_ACQUIRE);
+    uint32_t room = fill->size - (prod - cons);
+    uint32_t n = room < backend->free_count ? room : backend->free_count;
+    if (n == 0) {
+        return;
+    }
+
+    uint64_t* addrs = (uint64_t*)fill->descs;
+    for (uint32_t i = 0; i < n; i++) {
+        addrs[(prod + i) & fill->mask] = backend->free_frames[--backend->free_count];
+    }
+    __atomic_store_n(fill->producer, prod + n, __ATOMIC_RELEASE);
+}
+
+// 回收完成环中的帧（本后端不发包，正常情况下完成环为空）
+static void xdp_drain_completion(struct xdp_backend* backend) {
+    xdp_ring_t* comp = &backend->comp;
+    uint32_t cons = *comp->consumer;
+    uint32_t prod = __atomic_load_n(comp->producer, __ATOMIC_ACQUIRE);
+    if (prod == cons) {
+        return;
+    }
+
+    const uint64_t* addrs = (const uint64_t*)comp->descs;
+    for (; cons != prod; cons++) {
+        backend->free_frames[backend->free_count++] = addrs[cons & comp->mask];
+    }
+    __atomic_store_n(comp->consumer, cons, __ATOMIC_RELEASE);
+}
+
+// 创建 XSKMAP 与重定向程序，并通过 bpf_link 挂载到网卡
+static int xdp_attach_program(struct xdp_backend* backend, xdp_attach_mode_t mode) {
+    union bpf_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = backend->queue_id + 1;
+    backend->map_fd = xdp_bpf(BPF_MAP_CREATE, &attr);
+    if (backend->map_fd < 0) {
+        xdp_report(backend, "BPF_MAP_CREATE(XSKMAP)");
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+
+    // return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS);
+    struct bpf_insn insns[] = {
+        { .code = BPF_LDX | BPF_W | BPF_MEM, .dst_reg = BPF_REG_2, .src_reg = BPF_REG_1,
+          .off = offsetof(struct xdp_md, rx_queue_index) },
+        { .code = BPF_LD | BPF_DW | BPF_IMM, .dst_reg = BPF_REG_1, .src_reg = BPF_PSEUDO_MAP_FD,
+          .imm = backend->map_fd },
+        { .code = 0 },
+        { .code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_3, .imm = XDP_PASS },
+        { .code = BPF_JMP | BPF_CALL, .imm = BPF_FUNC_redirect_map },
+        { .code = BPF_JMP | BPF_EXIT },
+    };
+    char log[1024] = {0};
+
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.expected_attach_type = BPF_XDP;
+    attr.insns = (uint64_t)(uintptr_t)insns;
+    attr.insn_cnt = sizeof(insns) / sizeof(insns[0]);
+    attr.license = (uint64_t)(uintptr_t)"Dual MIT/GPL";
+    attr.log_buf = (uint64_t)(uintptr_t)log;
+    attr.log_size = sizeof(log);
+    attr.log_level = 1;
+    backend->prog_fd = xdp_bpf(BPF_PROG_LOAD, &attr);
+    if (backend->prog_fd < 0) {
+        xdp_report(backend, log[0] ? log : "BPF_PROG_LOAD(XDP)");
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = backend->prog_fd;
+    attr.link_create.target_ifindex = backend->ifindex;
+    attr.link_create.attach_type = BPF_XDP;
+    if (mode == XDP_ATTACH_GENERIC) {
+        attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+    } else if (mode == XDP_ATTACH_NATIVE) {
+        attr.link_create.flags = XDP_FLAGS_DRV_MODE;
+    }
+    backend->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+    if (backend->link_fd < 0) {
+        xdp_report(backend, "BPF_LINK_CREATE(XDP)");
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+
+    return CAPTURE_SUCCESS;
+}
+
+// 将 AF_XDP 套接字登记到 XSKMAP，使对应队列的数据包重定向过来
+static int xdp_register_socket(struct xdp_backend* backend) {
+    union bpf_attr attr;
+    uint32_t key = backend->queue_id;
+    uint32_t value = (uint32_t)backend->fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = backend->map_fd;
+    attr.key = (uint64_t)(uintptr_t)&key;
+    attr.value = (uint64_t)(uintptr_t)&value;
+    attr.flags = BPF_ANY;
+    if (xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr) != 0) {
+        xdp_report(backend, "BPF_MAP_UPDATE_ELEM(XSKMAP)");
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static void xdp_release(struct xdp_backend* backend) {
+    // 先断开 bpf_link，网卡上的程序随之卸载
+    if (backend->link_fd >= 0) {
+        close(backend->link_fd);
+    }
+    if (backend->prog_fd >= 0) {
+        close(backend->prog_fd);
+    }
+    if (backend->map_fd >= 0) {
+        close(backend->map_fd);
+    }
+    xdp_unmap_ring(&backend->rx);
+    xdp_unmap_ring(&backend->fill);
+    xdp_unmap_ring(&backend->comp);
+    if (backend->fd >= 0) {
+        close(backend->fd);
+    }
+    if (backend->wake_fd >= 0) {
+        close(backend->wake_fd);
+    }
+    if (backend->umem) {
+        munmap(backend->umem, backend->umem_size);
+    }
+    free(backend->free_frames);
+    free(backend->frame_refs);
+    free(backend->returned_frames);
+    pthread_mutex_destroy(&backend->returned_lock);
+    free(backend->device);
+    free(backend);
+}
+
+// 创建 AF_XDP 后端
+capture_backend_t* xdp_backend_create(
+    const xdp_backend_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !config->device || !error_cb) {
+        return NULL;
+    }
+
+    struct xdp_backend* backend = calloc(1, sizeof(struct xdp_backend));
+    if (!backend) {
+        return NULL;
+    }
+
+    // 初始化基础后端结构
+    backend->base.private_data = backend;
+    backend->base.ops = &xdp_backend_ops;
+    backend->base.type = CAPTURE_BACKEND_EBPF;
+    backend->base.error_cb = error_cb;
+    backend->base.error_user_data = error_user_data;
+
+    pthread_mutex_init(&backend->returned_lock, NULL);
+    backend->fd = -1;
+    backend->wake_fd = -1;
+    backend->map_fd = -1;
+    backend->prog_fd = -1;
+    backend->link_fd = -1;
+    backend->device = strdup(config->device);
+    backend->queue_id = config->queue_id;
+    backend->frame_size = config->frame_size ? config->frame_size : XDP_DEFAULT_FRAME_SIZE;
+    backend->frame_count = config->frame_count ? config->frame_count : XDP_DEFAULT_FRAME_COUNT;
+    backend->batch_size = config->batch_size ? config->batch_size : XDP_DEFAULT_BATCH_SIZE;
+    backend->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : 1000;
+    uint32_t ring_size = config->ring_size ? config->ring_size : XDP_DEFAULT_RING_SIZE;
+    atomic_init(&backend->running, false);
+    atomic_init(&backend->paused, false);
+
+    if (!xdp_is_pow2(backend->frame_size) || !xdp_is_pow2(ring_size)) {
+        error_cb("AF_XDP frame_size and ring_size must be powers of two", error_user_data);
+        xdp_release(backend);
+        return NULL;
+    }
+
+    backend->ifindex = (int)if_nametoindex(backend->device);
+    if (backend->ifindex == 0) {
+        xdp_report(backend, backend->device);
+        xdp_release(backend);
+        return NULL;
+    }
+
+    // 分配 UMEM，所有帧初始时都是空闲的
+    backend->umem_size = (size_t)backend->frame_size * backend->frame_count;
+    backend->umem = mmap(NULL, backend->umem_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (backend->umem == MAP_FAILED) {
+        backend->umem = NULL;
+        xdp_report(backend, "mmap(UMEM)");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    backend->free_frames = calloc(backend->frame_count, sizeof(uint64_t));
+    backend->frame_refs = calloc(backend->frame_count, sizeof(atomic_uint));
+    backend->returned_frames = calloc(backend->frame_count, sizeof(uint64_t));
+    if (!backend->free_frames || !backend->frame_refs || !backend->returned_frames) {
+        xdp_release(backend);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < backend->frame_count; i++) {
+        backend->free_frames[i] = (uint64_t)(backend->frame_count - 1 - i) * backend->frame_size;
+    }
+    backend->free_count = backend->frame_count;
+
+    backend->fd = socket(AF_XDP, SOCK_RAW, 0);
+    if (backend->fd < 0) {
+        xdp_report(backend, "socket(AF_XDP)");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    backend->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (backend->wake_fd < 0) {
+        xdp_report(backend, "eventfd");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    struct xdp_umem_reg reg = {
+        .addr = (uint64_t)(uintptr_t)backend->umem,
+        .len = backend->umem_size,
+        .chunk_size = backend->frame_size,
+        .headroom = 0,
+        .flags = 0,
+    };
+    if (setsockopt(backend->fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) {
+        xdp_report(backend, "XDP_UMEM_REG");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    if (setsockopt(backend->fd, SOL_XDP, XDP_UMEM_FILL_RING, &ring_size, sizeof(ring_size)) != 0 ||
+        setsockopt(backend->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ring_size, sizeof(ring_size)) != 0 ||
+        setsockopt(backend->fd, SOL_XDP, XDP_RX_RING, &ring_size, sizeof(ring_size)) != 0) {
+        xdp_report(backend, "XDP ring setup");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    struct xdp_mmap_offsets off;
+    socklen_t optlen = sizeof(off);
+    if (getsockopt(backend->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) != 0) {
+        xdp_report(backend, "XDP_MMAP_OFFSETS");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    if (xdp_map_ring(backend, &backend->rx, &off.rx, ring_size,
+                     sizeof(struct xdp_desc), XDP_PGOFF_RX_RING) != 0 ||
+        xdp_map_ring(backend, &backend->fill, &off.fr, ring_size,
+                     sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING) != 0 ||
+        xdp_map_ring(backend, &backend->comp, &off.cr, ring_size,
+                     sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING) != 0) {
+        xdp_report(backend, "mmap(XDP ring)");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    // 绑定之前先把帧交给内核，避免开头的数据包因填充环为空而被丢弃
+    xdp_refill(backend);
+
+    struct sockaddr_xdp addr = {
+        .sxdp_family = AF_XDP,
+        .sxdp_ifindex = (uint32_t)backend->ifindex,
+        .sxdp_queue_id = backend->queue_id,
+        .sxdp_flags = XDP_USE_NEED_WAKEUP,
+    };
+    if (config->bind_mode == XDP_BIND_COPY) {
+        addr.sxdp_flags |= XDP_COPY;
+    } else if (config->bind_mode == XDP_BIND_ZEROCOPY) {
+        addr.sxdp_flags |= XDP_ZEROCOPY;
+    }
+    if (bind(backend->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        xdp_report(backend, "bind(AF_XDP)");
+        xdp_release(backend);
+        return NULL;
+    }
+
+    if (xdp_attach_program(backend, config->attach_mode) != CAPTURE_SUCCESS ||
+        xdp_register_socket(backend) != CAPTURE_SUCCESS) {
+        xdp_release(backend);
+        return NULL;
+    }
+
+    return &backend->base;
+}
+
+// 销毁 AF_XDP 后端
+void xdp_backend_destroy(capture_backend_t* backend) {
+    if (!backend) {
+        return;
+    }
+    xdp_release((struct xdp_backend*)backend);
+}
+
+static void xdp_cleanup(void* backend) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp) {
+        return;
+    }
+    if (atomic_load(&xdp->running)) {
+        xdp_stop(xdp);
+    }
+    xdp_release(xdp);
+}
+
+// 处理一批 RX 描述符，返回 false 表示回调要求停止
+static bool xdp_process_rx(struct xdp_backend* backend, uint32_t* processed) {
+    xdp_ring_t* rx = &backend->rx;
+    uint32_t cons = *rx->consumer;
+    uint32_t prod = __atomic_load_n(rx->producer, __ATOMIC_ACQUIRE);
+    uint32_t avail = prod - cons;
+    uint32_t n = avail < backend->batch_size ? avail : backend->batch_size;
+    bool deliver = !atomic_load_explicit(&backend->paused, memory_order_relaxed);
+    bool keep_going = true;
+
+    *processed = n;
+    if (n == 0) {
+        return true;
+    }
+
+    // AF_XDP 描述符不带时间戳，同一批数据包共用一个接收时间
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    const struct xdp_desc* descs = (const struct xdp_desc*)rx->descs;
+    uint64_t frame_mask = ~((uint64_t)backend->frame_size - 1);
+
+    for (uint32_t i = 0; i < n; i++) {
+        const struct xdp_desc* desc = &descs[(cons + i) & rx->mask];
+
+        // 交付期间持有一个引用，回调中的租用在此基础上累加
+        atomic_store_explicit(&backend->frame_refs[(desc->addr & frame_mask) / backend->frame_size], 1,
+                              memory_order_relaxed);
+
+        if (deliver && keep_going) {
+            packet_t pkt = {
+                .data = backend->umem + desc->addr,
+                .len = desc->len,
+                .caplen = desc->len,
+                .ts = ts,
+                .if_index = 0,
+                .flags = 0,
+                .protocol = 0,
+                .vlan_tci = 0,
+                .hash = 0,
+            };
+            packet_decode(&pkt, PACKET_LINKTYPE_ETHERNET);
+            if (!capture_sink_push(&backend->sink, &pkt)) {
+                keep_going = false;
+            }
+        }
+    }
+
+    if (keep_going && !capture_sink_flush(&backend->sink)) {
+        keep_going = false;
+    }
+
+    // 所有回调返回后才释放帧，被租用的帧等到 release 时再复用
+    for (uint32_t i = 0; i < n; i++) {
+        xdp_frame_put(backend, descs[(cons + i) & rx->mask].addr & frame_mask);
+    }
+
+    __atomic_store_n(rx->consumer, cons + n, __ATOMIC_RELEASE);
+    xdp_refill(backend);
+    return keep_going;
+}
+
+// 归还拉取模式下借出的帧
+static void xdp_pull_release(struct xdp_backend* xdp) {
+    if (xdp->pull_pending == 0) {
+        return;
+    }
+
+    xdp_ring_t* rx = &xdp->rx;
+    uint32_t cons = *rx->consumer;
+    const struct xdp_desc* descs = (const struct xdp_desc*)rx->descs;
+    uint64_t frame_mask = ~((uint64_t)xdp->frame_size - 1);
+    for (uint32_t i = 0; i < xdp->pull_pending; i++) {
+        xdp_frame_put(xdp, descs[(cons + i) & rx->mask].addr & frame_mask);
+    }
+    __atomic_store_n(rx->consumer, cons + xdp->pull_pending, __ATOMIC_RELEASE);
+    xdp->pull_pending = 0;
+    xdp_refill(xdp);
+}
+
+// 拉取模式：数据包直接指向 UMEM，帧在下一次调用时才归还填充环
+static int xdp_next_batch(void* backend, packet_t* packets, uint32_t max, int timeout_ms) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp || !packets || max == 0 || xdp->fd < 0) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (xdp->start_time.tv_sec == 0) {
+        clock_gettime(CLOCK_REALTIME, &xdp->start_time);
+    }
+
+    xdp_pull_release(xdp);
+
+    xdp_ring_t* rx = &xdp->rx;
+    uint32_t cons = *rx->consumer;
+    uint32_t avail = __atomic_load_n(rx->producer, __ATOMIC_ACQUIRE) - cons;
+    if (avail == 0) {
+        xdp_drain_completion(xdp);
+        xdp_refill(xdp);
+        if (timeout_ms == 0) {
+            return 0;
+        }
+
+        struct pollfd pfds[2] = {
+            { .fd = xdp->fd, .events = POLLIN },
+            { .fd = xdp->wake_fd, .events = POLLIN },
+        };
+        if (poll(pfds, 2, timeout_ms) < 0 && errno != EINTR) {
+            xdp_report(xdp, "poll");
+            return -CAPTURE_ERROR_BACKEND;
+        }
+        if (pfds[1].revents & POLLIN) {
+            // 被 stop 打断
+            uint64_t drain;
+            while (read(xdp->wake_fd, &drain, sizeof(drain)) > 0) {
+            }
+            return 0;
+        }
+        avail = __atomic_load_n(rx->producer, __ATOMIC_ACQUIRE) - cons;
+        if (avail == 0) {
+            return 0;
+        }
+    } else if (__atomic_load_n(xdp->fill.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) {
+        recvfrom(xdp->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+    }
+
+    uint32_t n = avail < max ? avail : max;
+    xdp->pull_pending = n;
+
+    const struct xdp_desc* descs = (const struct xdp_desc*)rx->descs;
+    uint64_t frame_mask = ~((uint64_t)xdp->frame_size - 1);
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t addr = descs[(cons + i) & rx->mask].addr & frame_mask;
+        atomic_store_explicit(&xdp->frame_refs[addr / xdp->frame_size], 1, memory_order_relaxed);
+    }
+    if (atomic_load_explicit(&xdp->paused, memory_order_relaxed)) {
+        return 0;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const struct xdp_desc* desc = &descs[(cons + i) & rx->mask];
+        packet_t* pkt = &packets[i];
+        pkt->data = xdp->umem + desc->addr;
+        pkt->len = desc->len;
+        pkt->caplen = desc->len;
+        pkt->ts = ts;
+        pkt->if_index = 0;
+        pkt->device_index = 0;
+        pkt->flags = 0;
+        pkt->protocol = 0;
+        pkt->vlan_tci = 0;
+        pkt->hash = 0;
+        packet_decode(pkt, PACKET_LINKTYPE_ETHERNET);
+        bytes += desc->len;
+    }
+    if (n > 0) {
+        capture_counters_batch(&xdp->counters, n, bytes);
+    }
+    return (int)n;
+}
+
+// 租用回调中（或拉取模式下借出）的数据包：增加其所在帧的引用计数
+static int xdp_lease(void* backend, const packet_t* packet) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp || packet->data < xdp->umem || packet->data >= xdp->umem + xdp->umem_size) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_uint* refs = &xdp->frame_refs[(size_t)(packet->data - xdp->umem) / xdp->frame_size];
+    if (atomic_load_explicit(refs, memory_order_relaxed) == 0) {
+        // 帧已回收，数据包已失效
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_fetch_add_explicit(refs, 1, memory_order_relaxed);
+    return CAPTURE_SUCCESS;
+}
+
+static void xdp_release_packet(void* backend, const packet_t* packet) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp || packet->data < xdp->umem || packet->data >= xdp->umem + xdp->umem_size) {
+        return;
+    }
+    size_t index = (size_t)(packet->data - xdp->umem) / xdp->frame_size;
+    if (atomic_fetch_sub_explicit(&xdp->frame_refs[index], 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    // 最后一个引用：交给接收线程在下次补充填充环时收回
+    pthread_mutex_lock(&xdp->returned_lock);
+    xdp->returned_frames[xdp->returned_count++] = (uint64_t)index * xdp->frame_size;
+    atomic_store_explicit(&xdp->has_returned, true, memory_order_release);
+    pthread_mutex_unlock(&xdp->returned_lock);
+}
+
+static int xdp_get_fd(void* backend) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    return xdp ? xdp->fd : -1;
+}
+
+// 接收循环，数据包经 xdp->sink 交付
+static int xdp_run(struct xdp_backend* xdp) {
+    xdp_pull_release(xdp);
+
+    clock_gettime(CLOCK_REALTIME, &xdp->start_time);
+    capture_backend_enter(&xdp->base, &xdp->running);
+
+    struct pollfd pfds[2] = {
+        { .fd = xdp->fd, .events = POLLIN },
+        { .fd = xdp->wake_fd, .events = POLLIN },
+    };
+
+    while (atomic_load_explicit(&xdp->running, memory_order_relaxed)) {
+        uint32_t processed;
+        bool keep_going = xdp_process_rx(xdp, &processed);
+        if (!keep_going) {
+            atomic_store(&xdp->running, false);
+            break;
+        }
+
+        if (processed == 0) {
+            xdp_drain_completion(xdp);
+            xdp_refill(xdp);
+
+            // RX 环为空，poll 同时在需要时唤醒驱动补充填充环
+            if (poll(pfds, 2, xdp->timeout_ms) < 0 && errno != EINTR) {
+                xdp_report(xdp, "poll");
+                atomic_store(&xdp->running, false);
+                return CAPTURE_ERROR_BACKEND;
+            }
+            if (pfds[1].revents & POLLIN) {
+                // 读掉唤醒事件，残留的事件会让 poll 一直立即返回；是否停止由运行标志决定
+                uint64_t drain;
+                while (read(xdp->wake_fd, &drain, sizeof(drain)) > 0) {
+                }
+            }
+        } else if (__atomic_load_n(xdp->fill.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) {
+            recvfrom(xdp->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+        }
+    }
+
+    // 清除唤醒事件，便于再次启动
+    uint64_t drain;
+    while (read(xdp->wake_fd, &drain, sizeof(drain)) > 0) {
+    }
+
+    clock_gettime(CLOCK_REALTIME, &xdp->end_time);
+    return CAPTURE_SUCCESS;
+}
+
+static int xdp_start(void* backend, packet_callback_t callback, void* user_data) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp || !callback || xdp->fd < 0) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_sink_init(&xdp->sink, callback, NULL, 0, user_data, &xdp->counters);
+    return xdp_run(xdp);
+}
+
+static int xdp_start_batch(void* backend, packet_batch_callback_t callback, uint32_t burst_size, void* user_data) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp || !callback || xdp->fd < 0) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (capture_sink_init(&xdp->sink, NULL, callback, burst_size, user_data, &xdp->counters) != CAPTURE_SUCCESS) {
+        xdp->base.error_cb("Failed to allocate packet batch", xdp->base.error_user_data);
+        return CAPTURE_ERROR_MEMORY;
+    }
+    int ret = xdp_run(xdp);
+    capture_sink_destroy(&xdp->sink);
+    return ret;
+}
+
+static int xdp_stop(void* backend) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    capture_backend_request_stop(&xdp->base, &xdp->running);
+
+    uint64_t one = 1;
+    if (write(xdp->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        xdp_report(xdp, "eventfd write");
+        return CAPTURE_ERROR_STOP_FAILED;
+    }
+    return CAPTURE_SUCCESS;
+}
+
+static int xdp_pause(void* backend) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    // 暂停期间继续回收帧，只是不再交付
+    atomic_store(&xdp->paused, true);
+    return CAPTURE_SUCCESS;
+}
+
+static int xdp_resume(void* backend) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+    atomic_store(&xdp->paused, false);
+    return CAPTURE_SUCCESS;
+}
+
+static int xdp_get_stats(void* backend, capture_stats_t* stats) {
+    struct xdp_backend* xdp = (struct xdp_backend*)backend;
+    if (!xdp || !stats) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    struct xdp_statistics xstats;
+    memset(&xstats, 0, sizeof(xstats));
+    socklen_t len = sizeof(xstats);
+    if (getsockopt(xdp->fd, SOL_XDP, XDP_STATISTICS, &xstats, &len) != 0) {
+        xdp_report(xdp, "XDP_STATISTICS");
+        return CAPTURE_ERROR_GET_STATS;
+    }
+
+    stats->packets_dropped = xstats.rx_dropped + xstats.rx_invalid_descs + xstats.rx_ring_full;
+    stats->packets_if_dropped = xstats.rx_fill_ring_empty_descs;
+    stats->start_time = xdp->start_time;
+    stats->end_time = xdp->end_time;
+    capture_counters_merge(&xdp->counters, stats);
+    return CAPTURE_SUCCESS;
+}
+
+static const char* xdp_get_name(void* backend) {
+    return "af_xdp";
+}
+
+static const char* xdp_get_version(void* backend) {
+    return "AF_XDP";
+}
+
+static const char* xdp_get_description(void* backend) {
+    return "AF_XDP socket backend with UMEM frame recycling";
+}
+
+static bool xdp_is_feature_supported(void* backend, const char* feature) {
+    if (!feature) {
+        return false;
+    }
+    return strcmp(feature, "zero_copy") == 0 ||
+           strcmp(feature, "kernel_bypass") == 0 ||
+           strcmp(feature, "batch") == 0 ||
+           strcmp(feature, "lease") == 0;
+}
@@ -1,34 +1,93 @@
 #include "capture.h"
 #include "backends/pcap_backend.h"
+#include "backends/af_packet_backend.h"
+#include "backends/xdp_backend.h"
+#include "backends/replay_backend.h"
+#include "backends/raw_socket_backend.h"
+#include "backends/synthetic_backend.h"
+#include "backends/multi_backend.h"
+#include "backends/dispatch_backend.h"
+#ifdef HAVE_DPDK
+#include "backends/dpdk_backend.h"
+#endif
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "capture_types.h"
 #include "backends/capture_backend.h"
 
+// 不支持批量交付的后端通过该适配器逐包调用批量回调
+typedef struct {
+    packet_batch_callback_t batch_cb; // 批量回调
+    void* user_data;                  // 用户数据
+} capture_batch_adapter_t;
+
+// 自有接收线程的启动参数
+typedef struct {
+    packet_callback_t packet_cb;       // 数据包回调，批量方式时为 NULL
+    packet_batch_callback_t batch_cb;  // 批量回调
+    uint32_t burst_size;               // 每次批量回调的最大数据包数
+    void* user_data;                   // 用户数据
+} capture_run_args_t;
+
 // 抓包句柄结构
 struct capture_handle {
     capture_backend_t* backend;  // 后端实例
-    bool is_running;            // 是否正在运行
+    capture_batch_adapter_t batch_adapter; // 批量回调适配器
+    atomic_bool is_running;     // 是否正在运行（接收循环退出时清除）
+    atomic_bool is_pulling;     // 是否以拉取方式使用（stop 可能从其他线程读取）
     bool is_paused;            // 是否暂停
+    packet_pool_t* lease_pool; // 租用拷贝使用的缓冲池
+    capture_affinity_t rx_affinity; // 接收线程放置
+    bool pin_caller;           // 调用 start 的线程是否为 0 号接收线程
+    bool background;           // capture_start 是否在自有接收线程上运行
+    bool has_thread;           // 自有接收线程已创建且尚未 join
+    pthread_t rx_thread;       // 自有接收线程
+    capture_run_args_t run_args; // 自有接收线程的启动参数
+    int run_result;            // 自有接收线程中后端 start 的返回值
+    pthread_mutex_t filter_lock; // 串行化过滤器更换
     capture_stats_t stats;     // 统计信息
 };
 
-capture_handle_t* capture_init(
-    const capture_config_t* config,
-    error_callback_t error_cb,
-    void* error_user_data
-) {
-    if (!config || !error_cb) {
-        return NULL;
+// 单个设备的接收线程数
+static uint32_t capture_rx_thread_count(const capture_config_t* config) {
+    uint32_t count = 1;
+    if (config->type == CAPTURE_BACKEND_AF_PACKET) {
+        count = config->fanout_count;
+        if (!count && config->backend_config) {
+            count = ((const af_packet_backend_config_t*)config->backend_config)->fanout_count;
+        }
     }
+    return count ? count : 1;
+}
 
-    // 创建句柄
-    capture_handle_t* handle = (capture_handle_t*)calloc(1, sizeof(capture_handle_t));
-    if (!handle) {
+// 从第 first 个接收线程开始取 count 个 CPU，未指定接收线程 CPU 时返回 NULL
+static uint32_t* capture_rx_cpus(const capture_config_t* config, uint32_t first, uint32_t count) {
+    const capture_placement_t* placement = &config->placement;
+    if (!placement->rx_cpus || !placement->rx_cpu_count) {
         return NULL;
     }
+    uint32_t* cpus = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    if (!cpus) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        cpus[i] = placement->rx_cpus[(first + i) % placement->rx_cpu_count];
+    }
+    return cpus;
+}
+
+// 为单个设备创建后端，rx_first 为该设备第一个接收线程的序号
+static capture_backend_t* capture_create_backend(
+    const capture_config_t* config,
+    const char* device,
+    uint32_t rx_first,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    capture_backend_t* backend = NULL;
 
-    // 根据配置创建后端
     switch (config->type) {
         case CAPTURE_BACKEND_PCAP: {
             pcap_backend_config_t pcap_config = {
@@ -38,30 +97,328 @@ capture_handle_t* capture_init(
                 .promiscuous = config->promiscuous,
                 .snaplen = config->snaplen,
                 .filter = config->filter,
-                .device = config->device
+                .device = device
             };
-            handle->backend = pcap_backend_create(&pcap_config, error_cb, error_user_data);
+            backend = pcap_backend_create(&pcap_config, error_cb, error_user_data);
+            break;
+        }
+        case CAPTURE_BACKEND_AF_PACKET: {
+            af_packet_backend_config_t af_config = {0};
+            if (config->backend_config) {
+                af_config = *(const af_packet_backend_config_t*)config->backend_config;
+            }
+            af_config.device = device;
+            af_config.filter = config->filter;
+            af_config.snaplen = config->snaplen;
+            af_config.timeout_ms = config->timeout_ms;
+            af_config.promiscuous = config->promiscuous;
+            if (config->fanout_count) {
+                af_config.fanout_count = config->fanout_count;
+            }
+            // 未显式指定块数量时按 buffer_size 推算
+            if (!af_config.block_count && config->buffer_size) {
+                uint32_t block_size = af_config.block_size ? af_config.block_size : AF_PACKET_DEFAULT_BLOCK_SIZE;
+                af_config.block_count = config->buffer_size / block_size;
+            }
+            uint32_t* rx_cpus = NULL;
+            if (!af_config.cpus) {
+                uint32_t rx_count = capture_rx_thread_count(config);
+                rx_cpus = capture_rx_cpus(config, rx_first, rx_count);
+                af_config.cpus = rx_cpus;
+                af_config.cpu_count = rx_cpus ? rx_count : 0;
+            }
+            if (!af_config.numa_nodes) {
+                af_config.numa_nodes = config->placement.numa_nodes;
+            }
+            backend = af_packet_backend_create(&af_config, error_cb, error_user_data);
+            free(rx_cpus);
+            break;
+        }
+        case CAPTURE_BACKEND_RAW_SOCKET: {
+            raw_socket_backend_config_t raw_config = {0};
+            if (config->backend_config) {
+                raw_config = *(const raw_socket_backend_config_t*)config->backend_config;
+            }
+            raw_config.device = device;
+            raw_config.filter = config->filter;
+            raw_config.snaplen = config->snaplen;
+            raw_config.promiscuous = config->promiscuous;
+            if (!raw_config.rcvbuf_size) {
+                raw_config.rcvbuf_size = config->buffer_size;
+            }
+            backend = raw_socket_backend_create(&raw_config, error_cb, error_user_data);
+            break;
+        }
+        case CAPTURE_BACKEND_EBPF: {
+            xdp_backend_config_t xdp_config = {0};
+            if (config->backend_config) {
+                xdp_config = *(const xdp_backend_config_t*)config->backend_config;
+            }
+            xdp_config.device = device;
+            xdp_config.timeout_ms = config->timeout_ms;
+            backend = xdp_backend_create(&xdp_config, error_cb, error_user_data);
+            break;
+        }
+        case CAPTURE_BACKEND_REPLAY: {
+            replay_backend_config_t replay_config = {0};
+            if (config->backend_config) {
+                replay_config = *(const replay_backend_config_t*)config->backend_config;
+            }
+            replay_config.path = device;
+            replay_config.filter = config->filter;
+            backend = replay_backend_create(&replay_config, error_cb, error_user_data);
+            break;
+        }
+        case CAPTURE_BACKEND_SYNTHETIC: {
+            synthetic_backend_config_t synthetic_config = {0};
+            if (config->backend_config) {
+                synthetic_config = *(const synthetic_backend_config_t*)config->backend_config;
+            }
+            synthetic_config.filter = config->filter;
+            backend = synthetic_backend_create(&synthetic_config, error_cb, error_user_data);
+            break;
+        }
+#ifdef HAVE_DPDK
+        case CAPTURE_BACKEND_DPDK: {
+            dpdk_backend_config_t dpdk_config = {0};
+            if (config->backend_config) {
+                dpdk_config = *(const dpdk_backend_config_t*)config->backend_config;
+            }
+            if (device) {
+                dpdk_config.device = device;
+            }
+            dpdk_config.promiscuous = config->promiscuous;
+            backend = dpdk_backend_create(&dpdk_config, error_cb, error_user_data);
             break;
         }
-        // TODO: 添加其他后端的支持
+#endif
         default:
             error_cb("Unsupported backend type", error_user_data);
-            free(handle);
             return NULL;
     }
 
+    return backend;
+}
+
+// 为每个设备创建一个后端，并用多设备聚合后端合并
+static capture_backend_t* capture_create_multi_backend(
+    const capture_config_t* config,
+    const capture_affinity_t* rx_affinity,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (config->device_count > MULTI_MAX_MEMBERS) {
+        error_cb("Too many capture devices", error_user_data);
+        return NULL;
+    }
+
+    // 第 i 个设备的接收线程从 i * rx_count 开始编号，成员线程即其 0 号接收线程
+    uint32_t rx_count = capture_rx_thread_count(config);
+    capture_backend_t* members[MULTI_MAX_MEMBERS];
+    uint32_t member_cpus[MULTI_MAX_MEMBERS];
+    const capture_placement_t* placement = &config->placement;
+    for (uint32_t i = 0; i < config->device_count; i++) {
+        if (placement->rx_cpus && placement->rx_cpu_count) {
+            member_cpus[i] = placement->rx_cpus[(i * rx_count) % placement->rx_cpu_count];
+        }
+
+        // 在成员的接收线程位置上创建，使其缓冲区分配在对应节点
+        capture_cpu_mask_t saved;
+        bool moved = capture_affinity_enter(rx_affinity, i * rx_count, &saved);
+        members[i] = capture_create_backend(config, config->devices[i], i * rx_count, error_cb, error_user_data);
+        if (moved) {
+            capture_affinity_leave(&saved);
+        }
+        if (!members[i]) {
+            while (i-- > 0) {
+                members[i]->ops->cleanup(members[i]);
+            }
+            return NULL;
+        }
+    }
+
+    multi_backend_config_t multi_config = {
+        .merge_window_us = config->merge_window_us,
+        .rx_threads = rx_count,
+        .filter = config->filter,
+        .cpus = (placement->rx_cpus && placement->rx_cpu_count) ? member_cpus : NULL,
+        .cpu_count = (placement->rx_cpus && placement->rx_cpu_count) ? config->device_count : 0,
+        .numa_nodes = placement->numa_nodes,
+        .overload = config->overload,
+    };
+    capture_backend_t* backend = multi_backend_create(members, config->device_count,
+                                                      &multi_config, error_cb, error_user_data);
+    if (!backend) {
+        for (uint32_t i = 0; i < config->device_count; i++) {
+            members[i]->ops->cleanup(members[i]);
+        }
+    }
+    return backend;
+}
+
+capture_handle_t* capture_init(
+    const capture_config_t* config,
+    error_callback_t error_cb,
+    void* error_user_data
+) {
+    if (!config || !error_cb) {
+        return NULL;
+    }
+
+    // 创建句柄
+    capture_handle_t* handle = (capture_handle_t*)calloc(1, sizeof(capture_handle_t));
+    if (!handle) {
+        return NULL;
+    }
+
+    const capture_placement_t* placement = &config->placement;
+    if (capture_affinity_init(&handle->rx_affinity, placement->rx_cpus, placement->rx_cpu_count,
+                              placement->numa_nodes, false) != CAPTURE_SUCCESS) {
+        error_cb("Invalid receive CPU placement", error_user_data);
+        free(handle);
+        return NULL;
+    }
+
+    // 根据配置创建后端
+    if (config->devices && config->device_count > 1) {
+        handle->backend = capture_create_multi_backend(config, &handle->rx_affinity, error_cb, error_user_data);
+    } else {
+        // 在 0 号接收线程的位置上创建，使缓冲区分配在对应节点
+        const char* device = (config->devices && config->device_count == 1) ? config->devices[0] : config->device;
+        capture_cpu_mask_t saved;
+        bool moved = capture_affinity_enter(&handle->rx_affinity, 0, &saved);
+        handle->backend = capture_create_backend(config, device, 0, error_cb, error_user_data);
+        if (moved) {
+            capture_affinity_leave(&saved);
+        }
+        handle->pin_caller = true;
+    }
+
     if (!handle->backend) {
+        capture_affinity_destroy(&handle->rx_affinity);
         free(handle);
         return NULL;
     }
 
-    handle->is_running = false;
+    // 多个工作线程或指定了过载策略时在接收线程之后加一级按流分发，
+    // 下游处理不过来时在用户态按策略处理，而不是让内核缓冲区溢出
+    if (config->worker_count > 1 || config->overload.policy != CAPTURE_OVERLOAD_NONE) {
+        dispatch_backend_config_t dispatch_config = {
+            .worker_count = config->worker_count ? config->worker_count : 1,
+            // 多设备时归并线程是唯一的生产者
+            .producer_count = (config->devices && config->device_count > 1) ? 1 : capture_rx_thread_count(config),
+            .cpus = placement->worker_cpus,
+            .cpu_count = placement->worker_cpu_count,
+            .numa_nodes = placement->numa_nodes,
+            .overload = config->overload,
+        };
+        capture_backend_t* dispatch = dispatch_backend_create(handle->backend, &dispatch_config,
+                                                              error_cb, error_user_data);
+        if (!dispatch) {
+            handle->backend->ops->cleanup(handle->backend);
+            capture_affinity_destroy(&handle->rx_affinity);
+            free(handle);
+            return NULL;
+        }
+        handle->backend = dispatch;
+    }
+
+    atomic_init(&handle->is_running, false);
     handle->is_paused = false;
+    handle->background = config->background;
+    handle->lease_pool = config->lease_pool;
+    pthread_mutex_init(&handle->filter_lock, NULL);
     memset(&handle->stats, 0, sizeof(capture_stats_t));
 
     return handle;
 }
 
+static bool capture_batch_adapter(const packet_t* packet, void* user_data) {
+    capture_batch_adapter_t* adapter = (capture_batch_adapter_t*)user_data;
+    return adapter->batch_cb(packet, 1, adapter->user_data);
+}
+
+// 在当前线程上运行后端的接收循环，直到停止或数据源结束
+static int capture_run(capture_handle_t* handle, const capture_run_args_t* args) {
+    // 单设备时调用线程就是 0 号接收线程，抓包期间按配置绑定
+    capture_cpu_mask_t saved;
+    bool moved = handle->pin_caller && capture_affinity_enter(&handle->rx_affinity, 0, &saved);
+
+    int ret;
+    if (args->packet_cb) {
+        ret = handle->backend->ops->start(handle->backend, args->packet_cb, args->user_data);
+    } else if (handle->backend->ops->start_batch) {
+        ret = handle->backend->ops->start_batch(handle->backend, args->batch_cb, args->burst_size,
+                                                args->user_data);
+    } else {
+        handle->batch_adapter.batch_cb = args->batch_cb;
+        handle->batch_adapter.user_data = args->user_data;
+        ret = handle->backend->ops->start(handle->backend, capture_batch_adapter, &handle->batch_adapter);
+    }
+    if (moved) {
+        capture_affinity_leave(&saved);
+    }
+    atomic_store(&handle->is_running, false);
+    return ret;
+}
+
+static void* capture_rx_thread(void* arg) {
+    capture_handle_t* handle = (capture_handle_t*)arg;
+    handle->run_result = capture_run(handle, &handle->run_args);
+    return NULL;
+}
+
+// 等待自有接收线程退出
+static void capture_join(capture_handle_t* handle) {
+    // 停止请求在后端置位运行标志之前到达时同样生效，通知一次即可
+    if (atomic_load(&handle->is_running)) {
+        handle->backend->ops->stop(handle->backend);
+    }
+    pthread_join(handle->rx_thread, NULL);
+    handle->has_thread = false;
+}
+
+// 按配置在当前线程或自有接收线程上开始抓包
+static int capture_launch(capture_handle_t* handle, const capture_run_args_t* args) {
+    // 自有接收线程已自行结束（如重放完毕）时先回收再重新启动
+    if (handle->has_thread && !atomic_load(&handle->is_running)) {
+        capture_join(handle);
+    }
+
+    if (atomic_load(&handle->is_running)) {
+        return CAPTURE_SUCCESS;
+    }
+
+    // 清除上一次的停止请求后置位运行标志再启动后端，此后其他线程的
+    // capture_stop 即使早于后端进入接收循环也不会丢失
+    capture_backend_rearm(handle->backend);
+    if (atomic_exchange(&handle->is_running, true)) {
+        return CAPTURE_SUCCESS;
+    }
+    handle->is_paused = false;
+
+    if (!handle->background) {
+        return capture_run(handle, args);
+    }
+
+    handle->run_args = *args;
+    handle->run_result = CAPTURE_SUCCESS;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (handle->pin_caller) {
+        capture_affinity_attr(&handle->rx_affinity, 0, &attr);
+    }
+    int err = pthread_create(&handle->rx_thread, &attr, capture_rx_thread, handle);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        atomic_store(&handle->is_running, false);
+        return CAPTURE_ERROR_START_FAILED;
+    }
+    handle->has_thread = true;
+    return CAPTURE_SUCCESS;
+}
+
 int capture_start(
     capture_handle_t* handle,
     packet_callback_t packet_cb,
@@ -71,18 +428,108 @@ int capture_start(
         return CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    if (handle->is_running) {
-        return CAPTURE_SUCCESS;
+    capture_run_args_t args = {
+        .packet_cb = packet_cb,
+        .user_data = user_data,
+    };
+    return capture_launch(handle, &args);
+}
+
+int capture_start_batch(
+    capture_handle_t* handle,
+    packet_batch_callback_t batch_cb,
+    uint32_t burst_size,
+    void* user_data
+) {
+    if (!handle || !handle->backend || !batch_cb) {
+        return CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    // 调用后端的启动函数
-    int ret = handle->backend->ops->start(handle->backend, packet_cb, user_data);
-    if (ret == 0) {
-        handle->is_running = true;
-        handle->is_paused = false;
+    capture_run_args_t args = {
+        .batch_cb = batch_cb,
+        .burst_size = burst_size,
+        .user_data = user_data,
+    };
+    return capture_launch(handle, &args);
+}
+
+int capture_next_batch(
+    capture_handle_t* handle,
+    packet_t* packets,
+    uint32_t max,
+    int timeout_ms
+) {
+    if (!handle || !handle->backend || !packets || max == 0) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    return ret;
+    // 推送模式运行期间不能再拉取
+    if (atomic_load(&handle->is_running) || handle->has_thread) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (!handle->backend->ops->next_batch) {
+        return -CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+    // 首次拉取时清除推送运行留下的停止请求，之后才对 capture_stop 可见
+    if (!atomic_load(&handle->is_pulling)) {
+        capture_backend_rearm(handle->backend);
+        atomic_store(&handle->is_pulling, true);
+    }
+    // stop 打断正在等待的调用，停止请求留到下一次调用立即返回 0 时清除，两次调用之间到达的 stop 不会丢失
+    if (atomic_exchange(&handle->backend->stop_requested, false)) {
+        return 0;
+    }
+    return handle->backend->ops->next_batch(handle->backend, packets, max, timeout_ms);
+}
+
+int capture_get_fd(capture_handle_t* handle) {
+    if (!handle || !handle->backend || !handle->backend->ops->get_fd) {
+        return -1;
+    }
+    return handle->backend->ops->get_fd(handle->backend);
+}
+
+int capture_lease(capture_handle_t* handle, packet_t* packet) {
+    if (!handle || !handle->backend || !packet || !packet->data) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    if (handle->backend->ops->lease) {
+        int ret = handle->backend->ops->lease(handle->backend, packet);
+        if (ret != CAPTURE_ERROR_NOT_SUPPORTED) {
+            return ret;
+        }
+    }
+
+    // 后端缓冲区无法保留时退回拷贝
+    size_t size = packet->caplen ? packet->caplen : 1;
+    uint8_t* copy = handle->lease_pool ? packet_pool_alloc(handle->lease_pool, size) : malloc(size);
+    if (!copy) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+    memcpy(copy, packet->data, packet->caplen);
+    packet->data = copy;
+    packet->flags |= PACKET_FLAG_LEASE_COPY;
+    return CAPTURE_SUCCESS;
+}
+
+void capture_release(capture_handle_t* handle, const packet_t* packet) {
+    if (!handle || !handle->backend || !packet) {
+        return;
+    }
+
+    if (packet->flags & PACKET_FLAG_LEASE_COPY) {
+        if (handle->lease_pool) {
+            packet_pool_free(handle->lease_pool, (void*)packet->data);
+        } else {
+            free((void*)packet->data);
+        }
+        return;
+    }
+    if (handle->backend->ops->release) {
+        handle->backend->ops->release(handle->backend, packet);
+    }
 }
 
 int capture_stop(capture_handle_t* handle) {
@@ -90,18 +537,21 @@ int capture_stop(capture_handle_t* handle) {
         return CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    if (!handle->is_running) {
-        return CAPTURE_SUCCESS;
+    // 自有接收线程：通知后端后 join，返回时回调已全部结束
+    if (handle->has_thread) {
+        capture_join(handle);
+        atomic_store(&handle->is_pulling, false);
+        handle->is_paused = false;
+        return handle->run_result;
     }
 
-    // 调用后端的停止函数
-    int ret = handle->backend->ops->stop(handle->backend);
-    if (ret == 0) {
-        handle->is_running = false;
-        handle->is_paused = false;
+    // 拉取模式下同样需要通知后端，以打断正在等待的 capture_next_batch
+    if (!atomic_load(&handle->is_running) && !atomic_load(&handle->is_pulling)) {
+        return CAPTURE_SUCCESS;
     }
 
-    return ret;
+    // 调用后端的停止函数；调用者线程上的接收循环退出时自行清除运行标志
+    return handle->backend->ops->stop(handle->backend);
 }
 
 int capture_pause(capture_handle_t* handle) {
@@ -109,10 +559,14 @@ int capture_pause(capture_handle_t* handle) {
         return CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    if (!handle->is_running || handle->is_paused) {
+    if (!atomic_load(&handle->is_running) || handle->is_paused) {
         return CAPTURE_SUCCESS;
     }
 
+    if (!handle->backend->ops->pause) {
+        return CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+
     // 调用后端的暂停函数
     int ret = handle->backend->ops->pause(handle->backend);
     if (ret == 0) {
@@ -127,10 +581,14 @@ int capture_resume(capture_handle_t* handle) {
         return CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    if (!handle->is_running || !handle->is_paused) {
+    if (!atomic_load(&handle->is_running) || !handle->is_paused) {
         return CAPTURE_SUCCESS;
     }
 
+    if (!handle->backend->ops->resume) {
+        return CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+
     // 调用后端的恢复函数
     int ret = handle->backend->ops->resume(handle->backend);
     if (ret == 0) {
@@ -145,17 +603,38 @@ int capture_get_stats(capture_handle_t* handle, capture_stats_t* stats) {
         return CAPTURE_ERROR_INVALID_PARAM;
     }
 
+    // 只填写部分字段的后端其余字段为 0
+    memset(stats, 0, sizeof(*stats));
+
     // 调用后端的获取统计信息函数
     return handle->backend->ops->get_stats(handle->backend, stats);
 }
 
+int capture_get_thread_stats(capture_handle_t* handle, capture_thread_stats_t* stats, uint32_t max) {
+    if (!handle || !handle->backend || (!stats && max)) {
+        return -CAPTURE_ERROR_INVALID_PARAM;
+    }
+    return capture_backend_thread_stats(handle->backend, stats, max);
+}
+
 int capture_set_filter(capture_handle_t* handle, const char* filter) {
     if (!handle || !handle->backend || !filter) {
         return CAPTURE_ERROR_INVALID_PARAM;
     }
 
-    // 调用后端的设置过滤器函数
-    return handle->backend->ops->set_filter(handle->backend, filter);
+    if (!handle->backend->ops->set_filter) {
+        return CAPTURE_ERROR_NOT_SUPPORTED;
+    }
+
+    // 抓包过程中也可以调用，后端原地更换过滤器，不重建环形缓冲区
+    pthread_mutex_lock(&handle->filter_lock);
+    int ret = handle->backend->ops->set_filter(handle->backend, filter);
+    pthread_mutex_unlock(&handle->filter_lock);
+    return ret;
+}
+
+int capture_worker_id(void) {
+    return dispatch_backend_worker_id();
 }
 
 void capture_cleanup(capture_handle_t* handle) {
@@ -163,8 +642,8 @@ void capture_cleanup(capture_handle_t* handle) {
         return;
     }
 
-    // 如果还在运行，先停止捕获
-    if (handle->is_running) {
+    // 如果还在运行，先停止捕获并回收自有接收线程
+    if (atomic_load(&handle->is_running) || handle->has_thread) {
         capture_stop(handle);
     }
 
@@ -175,5 +654,7 @@ void capture_cleanup(capture_handle_t* handle) {
     }
 
     // 清理句柄
+    capture_affinity_destroy(&handle->rx_affinity);
+    pthread_mutex_destroy(&handle->filter_lock);
     free(handle);
 } 
\ No newline at end of file
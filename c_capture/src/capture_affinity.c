@@ -0,0 +1,224 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "backends/capture_backend.h"
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+#define CAPTURE_MAX_NODES 64
+
+_Static_assert(sizeof(capture_cpu_mask_t) == sizeof(cpu_set_t), "capture_cpu_mask_t must match cpu_set_t");
+
+// 读取 CPU 所在的 NUMA 节点（/sys/devices/system/cpu/cpuN/nodeM），未知时返回 -1
+static int capture_cpu_node(uint32_t cpu) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return -1;
+    }
+    int node = -1;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+// 把 numa_nodes 中各节点的 CPU（/sys/devices/system/node/nodeN/cpulist）加入 set
+static void capture_node_cpus(uint64_t numa_nodes, cpu_set_t* set) {
+    CPU_ZERO(set);
+    for (int node = 0; node < CAPTURE_MAX_NODES; node++) {
+        if (!(numa_nodes & (1ULL << node))) {
+            continue;
+        }
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE* fp = fopen(path, "r");
+        if (!fp) {
+            continue;
+        }
+        char buf[1024];
+        if (fgets(buf, sizeof(buf), fp)) {
+            // 格式如 "0-3,8-11"
+            char* p = buf;
+            while (*p >= '0' && *p <= '9') {
+                unsigned long first = strtoul(p, &p, 10);
+                unsigned long last = first;
+                if (*p == '-') {
+                    last = strtoul(p + 1, &p, 10);
+                }
+                for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+                    CPU_SET(cpu, set);
+                }
+                if (*p == ',') {
+                    p++;
+                }
+            }
+        }
+        fclose(fp);
+    }
+}
+
+// 计算第 index 个线程的 CPU 掩码，不做限制时返回 false
+static bool capture_affinity_mask(const capture_affinity_t* affinity, uint32_t index, cpu_set_t* set) {
+    if (!affinity) {
+        return false;
+    }
+    if (affinity->cpu_count) {
+        uint32_t cpu = affinity->cpus[index % affinity->cpu_count];
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_ZERO(set);
+        CPU_SET(cpu, set);
+        return true;
+    }
+    if (affinity->numa_nodes) {
+        capture_node_cpus(affinity->numa_nodes, set);
+        return CPU_COUNT(set) > 0;
+    }
+    return false;
+}
+
+int capture_affinity_init(capture_affinity_t* affinity, const uint32_t* cpus, uint32_t cpu_count,
+                          uint64_t numa_nodes, bool spread) {
+    memset(affinity, 0, sizeof(*affinity));
+    affinity->numa_nodes = numa_nodes;
+
+    if (cpus && cpu_count) {
+        // 不在进程允许范围内的 CPU 会让线程创建失败，提前拒绝
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+            for (uint32_t i = 0; i < cpu_count; i++) {
+                if (cpus[i] >= CPU_SETSIZE || !CPU_ISSET(cpus[i], &allowed)) {
+                    return CAPTURE_ERROR_INVALID_PARAM;
+                }
+            }
+        }
+        affinity->cpus = (uint32_t*)malloc(sizeof(uint32_t) * cpu_count);
+        if (!affinity->cpus) {
+            return CAPTURE_ERROR_MEMORY;
+        }
+        memcpy(affinity->cpus, cpus, sizeof(uint32_t) * cpu_count);
+        affinity->cpu_count = cpu_count;
+        return CAPTURE_SUCCESS;
+    }
+    if (!spread) {
+        return CAPTURE_SUCCESS;
+    }
+
+    // 依次使用进程允许的 CPU，指定了节点时只取这些节点上的 CPU
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return CAPTURE_SUCCESS;
+    }
+    if (numa_nodes) {
+        cpu_set_t on_nodes;
+        capture_node_cpus(numa_nodes, &on_nodes);
+        CPU_AND(&allowed, &allowed, &on_nodes);
+    }
+    int count = CPU_COUNT(&allowed);
+    if (count <= 0) {
+        return CAPTURE_SUCCESS;
+    }
+    affinity->cpus = (uint32_t*)malloc(sizeof(uint32_t) * (size_t)count);
+    if (!affinity->cpus) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE && affinity->cpu_count < (uint32_t)count; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            affinity->cpus[affinity->cpu_count++] = cpu;
+        }
+    }
+    return CAPTURE_SUCCESS;
+}
+
+void capture_affinity_destroy(capture_affinity_t* affinity) {
+    if (!affinity) {
+        return;
+    }
+    free(affinity->cpus);
+    affinity->cpus = NULL;
+    affinity->cpu_count = 0;
+}
+
+int capture_affinity_node(const capture_affinity_t* affinity, uint32_t index) {
+    if (!affinity) {
+        return -1;
+    }
+    if (affinity->cpu_count) {
+        return capture_cpu_node(affinity->cpus[index % affinity->cpu_count]);
+    }
+    if (affinity->numa_nodes) {
+        return __builtin_ctzll(affinity->numa_nodes);
+    }
+    return -1;
+}
+
+void capture_affinity_attr(const capture_affinity_t* affinity, uint32_t index, pthread_attr_t* attr) {
+    cpu_set_t set;
+    if (capture_affinity_mask(affinity, index, &set)) {
+        pthread_attr_setaffinity_np(attr, sizeof(set), &set);
+    }
+}
+
+bool capture_affinity_enter(const capture_affinity_t* affinity, uint32_t index, capture_cpu_mask_t* saved) {
+    cpu_set_t set;
+    if (!capture_affinity_mask(affinity, index, &set)) {
+        return false;
+    }
+    cpu_set_t old;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(old), &old) != 0) {
+        return false;
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+    memcpy(saved, &old, sizeof(old));
+    return true;
+}
+
+void capture_affinity_leave(const capture_cpu_mask_t* saved) {
+    cpu_set_t old;
+    memcpy(&old, saved, sizeof(old));
+    pthread_setaffinity_np(pthread_self(), sizeof(old), &old);
+}
+
+void* capture_numa_alloc(size_t size, int node) {
+    void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+#ifdef SYS_mbind
+    // 页面在第一次写入时按策略分配；内核不支持 NUMA 时保持默认策略
+    if (node >= 0 && node < CAPTURE_MAX_NODES) {
+        unsigned long mask[CAPTURE_MAX_NODES / (8 * sizeof(unsigned long))] = {0};
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        if (syscall(SYS_mbind, ptr, size, MPOL_PREFERRED, mask, CAPTURE_MAX_NODES + 1, 0) != 0) {
+            // 忽略失败
+        }
+    }
+#else
+    (void)node;
+#endif
+    return ptr;
+}
+
+void capture_numa_free(void* ptr, size_t size) {
+    if (ptr) {
+        munmap(ptr, size);
+    }
+}
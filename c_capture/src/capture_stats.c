@@ -0,0 +1,80 @@
+#include <string.h>
+#include "backends/capture_backend.h"
+
+_Thread_local uint32_t capture_rx_index;
+
+void capture_counters_merge(const capture_counters_t* counters, capture_stats_t* stats) {
+    uint64_t newest = capture_counter_get(&counters->dropped_newest);
+    uint64_t oldest = capture_counter_get(&counters->dropped_oldest);
+    uint64_t sampled = capture_counter_get(&counters->sampled_out);
+
+    stats->packets_received += capture_counter_get(&counters->packets);
+    stats->bytes_received += capture_counter_get(&counters->bytes);
+    stats->batches_delivered += capture_counter_get(&counters->batches);
+    for (uint32_t i = 0; i < CAPTURE_BATCH_HIST_BUCKETS; i++) {
+        stats->batch_size_hist[i] += capture_counter_get(&counters->batch_hist[i]);
+    }
+    stats->packets_dropped += newest + oldest + sampled;
+    stats->overload_dropped_newest += newest;
+    stats->overload_dropped_oldest += oldest;
+    stats->overload_sampled_out += sampled;
+    stats->overload_blocked += capture_counter_get(&counters->blocked);
+    stats->overload_blocked_ns += capture_counter_get(&counters->blocked_ns);
+}
+
+void capture_counters_read(const capture_counters_t* counters, capture_thread_role_t role,
+                           uint32_t index, capture_thread_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->role = role;
+    stats->index = index;
+    stats->packets = capture_counter_get(&counters->packets);
+    stats->bytes = capture_counter_get(&counters->bytes);
+    stats->batches = capture_counter_get(&counters->batches);
+    for (uint32_t i = 0; i < CAPTURE_BATCH_HIST_BUCKETS; i++) {
+        stats->batch_size_hist[i] = capture_counter_get(&counters->batch_hist[i]);
+    }
+    stats->dropped_newest = capture_counter_get(&counters->dropped_newest);
+    stats->dropped_oldest = capture_counter_get(&counters->dropped_oldest);
+    stats->sampled_out = capture_counter_get(&counters->sampled_out);
+    stats->blocked = capture_counter_get(&counters->blocked);
+    stats->blocked_ns = capture_counter_get(&counters->blocked_ns);
+}
+
+void capture_counters_add_overload(const capture_counters_t* counters, capture_thread_stats_t* stats) {
+    stats->dropped_newest += capture_counter_get(&counters->dropped_newest);
+    stats->dropped_oldest += capture_counter_get(&counters->dropped_oldest);
+    stats->sampled_out += capture_counter_get(&counters->sampled_out);
+    stats->blocked += capture_counter_get(&counters->blocked);
+    stats->blocked_ns += capture_counter_get(&counters->blocked_ns);
+}
+
+int capture_backend_thread_stats(capture_backend_t* backend, capture_thread_stats_t* stats, uint32_t max) {
+    if (backend->ops->get_thread_stats) {
+        return backend->ops->get_thread_stats(backend, stats, max);
+    }
+    if (!backend->ops->get_stats) {
+        return 0;
+    }
+
+    // 单接收线程的后端：整体统计即 0 号接收线程的统计
+    capture_stats_t total;
+    memset(&total, 0, sizeof(total));
+    int ret = backend->ops->get_stats(backend, &total);
+    if (ret != CAPTURE_SUCCESS) {
+        return -ret;
+    }
+    if (max > 0) {
+        memset(&stats[0], 0, sizeof(stats[0]));
+        stats[0].role = CAPTURE_THREAD_RECEIVE;
+        stats[0].packets = total.packets_received;
+        stats[0].bytes = total.bytes_received;
+        stats[0].batches = total.batches_delivered;
+        memcpy(stats[0].batch_size_hist, total.batch_size_hist, sizeof(total.batch_size_hist));
+        stats[0].dropped_newest = total.overload_dropped_newest;
+        stats[0].dropped_oldest = total.overload_dropped_oldest;
+        stats[0].sampled_out = total.overload_sampled_out;
+        stats[0].blocked = total.overload_blocked;
+        stats[0].blocked_ns = total.overload_blocked_ns;
+    }
+    return 1;
+}
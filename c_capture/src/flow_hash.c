@@ -0,0 +1,129 @@
+#include <string.h>
+#include "flow_hash.h"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define FLOW_HASH_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define FLOW_HASH_ARM 1
+#endif
+
+#define FLOW_HASH_SEED   0xffffffffu
+#define CRC32C_POLY      0x82f63b78u // CRC32C（Castagnoli）反射多项式
+#define FLOW_KEY_WORDS   5
+
+// 排序后的流键：IPv4 两个字，IPv6 五个字
+typedef struct {
+    uint64_t word[FLOW_KEY_WORDS];
+    uint32_t count;
+} flow_key_t;
+
+// 查表计算用的 slicing-by-8 表
+static uint32_t flow_crc_table[8][256];
+static bool flow_hash_hw = false;
+
+__attribute__((constructor)) static void flow_hash_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        flow_crc_table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            uint32_t prev = flow_crc_table[k - 1][i];
+            flow_crc_table[k][i] = (prev >> 8) ^ flow_crc_table[0][prev & 0xff];
+        }
+    }
+#if defined(FLOW_HASH_X86)
+    __builtin_cpu_init();
+    flow_hash_hw = __builtin_cpu_supports("sse4.2");
+#elif defined(FLOW_HASH_ARM)
+    flow_hash_hw = true;
+#endif
+}
+
+// 两个端点按（地址, 端口）排序，交换源和目的得到同一个键
+static inline void flow_key_build(flow_key_t* key, const uint8_t* src, const uint8_t* dst, uint32_t addr_len,
+                                  uint16_t sport, uint16_t dport, uint8_t proto) {
+    if (addr_len == 4) {
+        uint32_t a;
+        uint32_t b;
+        memcpy(&a, src, sizeof(a));
+        memcpy(&b, dst, sizeof(b));
+        uint64_t ka = (uint64_t)a << 16 | sport;
+        uint64_t kb = (uint64_t)b << 16 | dport;
+        key->word[0] = ka < kb ? ka : kb;
+        key->word[1] = (ka < kb ? kb : ka) | (uint64_t)proto << 48;
+        key->count = 2;
+        return;
+    }
+
+    uint64_t a[2];
+    uint64_t b[2];
+    memcpy(a, src, sizeof(a));
+    memcpy(b, dst, sizeof(b));
+    bool swap = a[0] != b[0] ? a[0] > b[0] : a[1] != b[1] ? a[1] > b[1] : sport > dport;
+    const uint64_t* lo = swap ? b : a;
+    const uint64_t* hi = swap ? a : b;
+    uint16_t lo_port = swap ? dport : sport;
+    uint16_t hi_port = swap ? sport : dport;
+    key->word[0] = lo[0];
+    key->word[1] = lo[1];
+    key->word[2] = hi[0];
+    key->word[3] = hi[1];
+    key->word[4] = (uint64_t)lo_port << 32 | (uint64_t)hi_port << 16 | proto;
+    key->count = 5;
+}
+
+static inline uint32_t flow_crc64_soft(uint32_t crc, uint64_t v) {
+    uint64_t x = crc ^ v;
+    return flow_crc_table[7][x & 0xff] ^ flow_crc_table[6][(x >> 8) & 0xff] ^
+           flow_crc_table[5][(x >> 16) & 0xff] ^ flow_crc_table[4][(x >> 24) & 0xff] ^
+           flow_crc_table[3][(x >> 32) & 0xff] ^ flow_crc_table[2][(x >> 40) & 0xff] ^
+           flow_crc_table[1][(x >> 48) & 0xff] ^ flow_crc_table[0][x >> 56];
+}
+
+static uint32_t flow_hash_soft(const flow_key_t* key) {
+    uint32_t crc = FLOW_HASH_SEED;
+    for (uint32_t i = 0; i < key->count; i++) {
+        crc = flow_crc64_soft(crc, key->word[i]);
+    }
+    return crc;
+}
+
+#if defined(FLOW_HASH_X86)
+__attribute__((target("sse4.2"))) static uint32_t flow_hash_crc(const flow_key_t* key) {
+    uint64_t crc = FLOW_HASH_SEED;
+    for (uint32_t i = 0; i < key->count; i++) {
+        crc = _mm_crc32_u64(crc, key->word[i]);
+    }
+    return (uint32_t)crc;
+}
+#elif defined(FLOW_HASH_ARM)
+static uint32_t flow_hash_crc(const flow_key_t* key) {
+    uint32_t crc = FLOW_HASH_SEED;
+    for (uint32_t i = 0; i < key->count; i++) {
+        crc = __crc32cd(crc, key->word[i]);
+    }
+    return crc;
+}
+#endif
+
+uint32_t flow_hash(const uint8_t* src, const uint8_t* dst, uint32_t addr_len,
+                   uint16_t sport, uint16_t dport, uint8_t proto) {
+    flow_key_t key;
+    flow_key_build(&key, src, dst, addr_len, sport, dport, proto);
+#if defined(FLOW_HASH_X86) || defined(FLOW_HASH_ARM)
+    if (flow_hash_hw) {
+        return flow_hash_crc(&key);
+    }
+#endif
+    return flow_hash_soft(&key);
+}
+
+bool flow_hash_accelerated(void) {
+    return flow_hash_hw;
+}
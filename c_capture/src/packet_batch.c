@@ -0,0 +1,80 @@
+#include <string.h>
+#include <stdbool.h>
+#include "packet_batch.h"
+#include "packet_decode.h"
+
+#define ETH_P_IPV4       0x0800
+#define ETH_P_IPV6       0x86dd
+#define IP_PROTO_TCP     6
+#define IP_PROTO_UDP     17
+#define IP_PROTO_SCTP    132
+#define IPV4_HEADER_LEN  20
+#define IPV6_HEADER_LEN  40
+#define BATCH_PREFETCH_AHEAD 8      // 预取提前的行数
+
+// IPv4 映射地址前缀 ::ffff:0:0/96
+static const uint8_t batch_v4_mapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+
+static inline uint16_t batch_read16(const uint8_t* p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+uint32_t packet_batch_parse(packet_batch_meta_t* meta, const packet_t* packets, uint32_t count) {
+    if (count > PACKET_BATCH_MAX) {
+        count = PACKET_BATCH_MAX;
+    }
+    meta->count = count;
+
+    // 第一遍：收集解码结果，同时预取后续数据包的网络层头部
+    for (uint32_t i = 0; i < count; i++) {
+        if (i + BATCH_PREFETCH_AHEAD < count) {
+            const packet_t* ahead = &packets[i + BATCH_PREFETCH_AHEAD];
+            __builtin_prefetch(ahead->data + ahead->l3_offset);
+        }
+        const packet_t* pkt = &packets[i];
+        packet_t decoded;
+        if (!(pkt->flags & PACKET_FLAG_DECODED)) {
+            decoded = *pkt;
+            packet_decode(&decoded, PACKET_LINKTYPE_ETHERNET);
+            pkt = &decoded;
+        }
+        meta->hash[i] = pkt->hash;
+        meta->flags[i] = pkt->flags;
+        meta->ethertype[i] = (uint16_t)pkt->protocol;
+        meta->l3_offset[i] = pkt->l3_offset;
+        meta->l4_offset[i] = pkt->l4_offset;
+        meta->l4_proto[i] = pkt->l4_proto;
+    }
+
+    // 第二遍：地址与端口，头部此时大多已在缓存中
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* data = packets[i].data;
+        uint32_t caplen = packets[i].caplen;
+        uint32_t l3 = meta->l3_offset[i];
+        uint32_t l4 = meta->l4_offset[i];
+        uint8_t proto = meta->l4_proto[i];
+        bool v4 = meta->ethertype[i] == ETH_P_IPV4 && caplen >= l3 + IPV4_HEADER_LEN;
+        bool v6 = meta->ethertype[i] == ETH_P_IPV6 && caplen >= l3 + IPV6_HEADER_LEN;
+
+        if (v6) {
+            memcpy(meta->src[i], data + l3 + 8, 16);
+            memcpy(meta->dst[i], data + l3 + 24, 16);
+        } else if (v4) {
+            memcpy(meta->src[i], batch_v4_mapped, sizeof(batch_v4_mapped));
+            memcpy(meta->src[i] + 12, data + l3 + 12, 4);
+            memcpy(meta->dst[i], batch_v4_mapped, sizeof(batch_v4_mapped));
+            memcpy(meta->dst[i] + 12, data + l3 + 16, 4);
+        } else {
+            memset(meta->src[i], 0, 16);
+            memset(meta->dst[i], 0, 16);
+        }
+
+        // 与解码器一致：分片与没有端口的协议不取端口
+        bool ports = (v4 || v6) && l4 != 0 && !(meta->flags[i] & PACKET_FLAG_FRAGMENT) &&
+                     (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP || proto == IP_PROTO_SCTP) &&
+                     caplen >= l4 + 4;
+        meta->sport[i] = ports ? batch_read16(data + l4) : 0;
+        meta->dport[i] = ports ? batch_read16(data + l4 + 2) : 0;
+    }
+    return count;
+}
@@ -0,0 +1,375 @@
+#include <stdbool.h>
+#include "packet_decode.h"
+#include "flow_hash.h"
+
+#define ETH_HEADER_LEN   14
+#define SLL_HEADER_LEN   16
+#define ETH_P_IPV4       0x0800
+#define ETH_P_IPV6       0x86dd
+#define ETH_P_8021Q      0x8100
+#define ETH_P_8021AD     0x88a8
+#define ETH_P_MPLS_UC    0x8847
+#define ETH_P_MPLS_MC    0x8848
+#define ETH_P_TEB        0x6558 // 透明以太网桥接，后面是内层以太网帧
+#define IP_PROTO_IPIP    4
+#define IP_PROTO_TCP     6
+#define IP_PROTO_UDP     17
+#define IP_PROTO_SCTP    132
+#define IP_PROTO_IPV6    41
+#define IP_PROTO_FRAGMENT 44
+#define IP_PROTO_GRE     47
+#define IPV4_HEADER_LEN  20
+#define IPV6_HEADER_LEN  40
+#define IPV6_EXT_MAX     8      // 最多遍历的扩展头个数
+#define IPV6_EXT_MIN_LEN 8      // 扩展头最短 8 字节，分片头固定为 8 字节
+#define IPV6_EXT_HOPOPTS 0
+#define IPV6_EXT_ROUTING 43
+#define IPV6_EXT_AH      51
+#define IPV6_EXT_DSTOPTS 60
+#define IPV6_FRAG_OFFSET 0xfff8 // 分片偏移，非 0 表示非首片
+#define IPV6_FRAG_MORE   0x0001
+// 按 Next Header 取值索引的扩展头集合，一次移位判断
+#define IPV6_EXT_MASK    ((1ULL << IPV6_EXT_HOPOPTS) | (1ULL << IPV6_EXT_ROUTING) | (1ULL << IP_PROTO_FRAGMENT) | \
+                          (1ULL << IPV6_EXT_AH) | (1ULL << IPV6_EXT_DSTOPTS))
+#define MPLS_LABEL_LEN   4
+#define UDP_HEADER_LEN   8
+#define VXLAN_PORT       4789
+#define VXLAN_HEADER_LEN 8
+#define VXLAN_FLAG_VNI   0x08
+#define GENEVE_PORT      6081
+#define GENEVE_HEADER_LEN 8
+
+#define GRE_FLAG_CSUM    0x8000
+#define GRE_FLAG_ROUTING 0x4000
+#define GRE_FLAG_KEY     0x2000
+#define GRE_FLAG_SEQ     0x1000
+#define GRE_VERSION      0x0007
+
+#define ARPHRD_ETHER     1
+#define ARPHRD_LOOPBACK  772
+#define ARPHRD_RAWIP     519
+#define ARPHRD_NONE      0xfffe
+
+// 解码器写入的标志位，重新解码前清除
+#define PACKET_DECODE_FLAGS (PACKET_FLAG_DECODED | PACKET_FLAG_FRAGMENT)
+
+static inline uint16_t packet_read16(const uint8_t* p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+// 记录一层封装，栈已满时返回 false
+static inline bool packet_push_encap(packet_t* pkt, uint32_t* depth, uint32_t layer) {
+    if (*depth >= PACKET_ENCAP_MAX) {
+        return false;
+    }
+    pkt->encap |= layer << (*depth * 4);
+    (*depth)++;
+    return true;
+}
+
+/**
+ * 遍历 IPv6 扩展头（逐跳选项、路由、目的选项、分片、AH），找到上层协议
+ * @param offset 固定头部之后的偏移，返回上层协议头部偏移
+ * @param proto 固定头部的 Next Header，返回上层协议号
+ * @param frag 返回分片扩展头偏移，没有时不修改
+ * @return 到达上层协议返回 true；扩展头截断或超过 IPV6_EXT_MAX 个返回 false。
+ *         非首片分片在分片头处停止，之后是分片载荷
+ */
+static bool packet_ipv6_walk(const uint8_t* data, uint32_t caplen, uint32_t* offset, uint8_t* proto,
+                             uint32_t* frag) {
+    uint32_t off = *offset;
+    uint8_t next = *proto;
+    bool reached = false;
+    for (int i = 0; i <= IPV6_EXT_MAX; i++) {
+        if (next >= 64 || !((IPV6_EXT_MASK >> next) & 1)) {
+            reached = true;
+            break;
+        }
+        if (i == IPV6_EXT_MAX || caplen < off + IPV6_EXT_MIN_LEN) {
+            break;
+        }
+        const uint8_t* ext = data + off;
+        // AH 长度以 4 字节为单位且不含前 8 字节中的 2 个单位，其余以 8 字节为单位且不含前 8 字节
+        uint32_t len = next == IP_PROTO_FRAGMENT ? IPV6_EXT_MIN_LEN
+                       : next == IPV6_EXT_AH     ? ((uint32_t)ext[1] + 2) * 4
+                                                 : ((uint32_t)ext[1] + 1) * 8;
+        bool later = next == IP_PROTO_FRAGMENT && (packet_read16(ext + 2) & IPV6_FRAG_OFFSET);
+        if (next == IP_PROTO_FRAGMENT) {
+            *frag = off;
+        }
+        next = ext[0];
+        off += len;
+        if (later) {
+            reached = true;
+            break;
+        }
+    }
+    *offset = off;
+    *proto = next;
+    return reached;
+}
+
+/**
+ * 识别 IP 之上的隧道头部
+ * @param offset 传输层头部偏移，识别成功时更新为内层头部偏移
+ * @param layer 输出隧道封装类型，IP-in-IP 没有隧道头部时为 PACKET_ENCAP_NONE
+ * @return 内层 EtherType，不是隧道时返回 0
+ */
+static uint16_t packet_tunnel(const uint8_t* data, uint32_t caplen, uint8_t proto, uint32_t* offset,
+                              uint32_t* layer) {
+    const uint8_t* hdr = data + *offset;
+    *layer = PACKET_ENCAP_NONE;
+    switch (proto) {
+        case IP_PROTO_IPIP:
+            return ETH_P_IPV4;
+        case IP_PROTO_IPV6:
+            return ETH_P_IPV6;
+        case IP_PROTO_GRE: {
+            if (caplen < *offset + 4) {
+                return 0;
+            }
+            // 只处理版本 0 且不带源路由的 GRE，可选字段各 4 字节
+            uint16_t gre_flags = packet_read16(hdr);
+            if (gre_flags & (GRE_FLAG_ROUTING | GRE_VERSION)) {
+                return 0;
+            }
+            uint32_t len = 4 + ((gre_flags & GRE_FLAG_CSUM) ? 4 : 0) + ((gre_flags & GRE_FLAG_KEY) ? 4 : 0) +
+                           ((gre_flags & GRE_FLAG_SEQ) ? 4 : 0);
+            if (caplen < *offset + len) {
+                return 0;
+            }
+            *offset += len;
+            *layer = PACKET_ENCAP_GRE;
+            return packet_read16(hdr + 2);
+        }
+        case IP_PROTO_UDP: {
+            if (caplen < *offset + UDP_HEADER_LEN + 8) {
+                return 0;
+            }
+            uint16_t dport = packet_read16(hdr + 2);
+            const uint8_t* tun = hdr + UDP_HEADER_LEN;
+            if (dport == VXLAN_PORT && (tun[0] & VXLAN_FLAG_VNI)) {
+                *offset += UDP_HEADER_LEN + VXLAN_HEADER_LEN;
+                *layer = PACKET_ENCAP_VXLAN;
+                return ETH_P_TEB;
+            }
+            if (dport == GENEVE_PORT && (tun[0] >> 6) == 0) {
+                // 低 6 位为选项长度，单位 4 字节
+                *offset += UDP_HEADER_LEN + GENEVE_HEADER_LEN + (uint32_t)(tun[0] & 0x3f) * 4;
+                *layer = PACKET_ENCAP_GENEVE;
+                return packet_read16(tun + 2);
+            }
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+void packet_decode(packet_t* pkt, uint32_t linktype) {
+    const uint8_t* data = pkt->data;
+    uint32_t caplen = pkt->caplen;
+
+    pkt->flags = (pkt->flags & ~PACKET_DECODE_FLAGS) | PACKET_FLAG_DECODED;
+    pkt->protocol = 0;
+    pkt->hash = 0;
+    pkt->l3_offset = 0;
+    pkt->l4_offset = 0;
+    pkt->l4_proto = 0;
+    pkt->frag_hdr_offset = 0;
+    pkt->encap = 0;
+
+    // 链路层：得到网络层的 EtherType 与偏移
+    uint32_t offset;
+    uint16_t ethertype;
+    switch (linktype) {
+        case PACKET_LINKTYPE_ETHERNET:
+            if (caplen < ETH_HEADER_LEN) {
+                return;
+            }
+            ethertype = packet_read16(data + 12);
+            offset = ETH_HEADER_LEN;
+            break;
+        case PACKET_LINKTYPE_LINUX_SLL:
+            if (caplen < SLL_HEADER_LEN) {
+                return;
+            }
+            ethertype = packet_read16(data + 14);
+            offset = SLL_HEADER_LEN;
+            break;
+        case PACKET_LINKTYPE_RAW:
+        case PACKET_LINKTYPE_DLT_RAW:
+        case PACKET_LINKTYPE_IPV4:
+        case PACKET_LINKTYPE_IPV6:
+            // 按版本号区分 IPv4 与 IPv6
+            if (caplen < 1) {
+                return;
+            }
+            ethertype = (data[0] >> 4) == 6 ? ETH_P_IPV6 : (data[0] >> 4) == 4 ? ETH_P_IPV4 : 0;
+            offset = 0;
+            break;
+        default:
+            return;
+    }
+
+    // 最近一个完整 IP 头部的哈希输入，内层头部不完整时退回用它计算哈希
+    const uint8_t* src = NULL;
+    const uint8_t* dst = NULL;
+    uint32_t addr_len = 0;
+    uint8_t hash_proto = 0;
+    uint16_t sport = 0;
+    uint16_t dport = 0;
+
+    // 逐层剥离封装；每次循环要么记录一层封装，要么紧跟在记录之后，层数受 PACKET_ENCAP_MAX 限制
+    uint32_t depth = 0;
+    for (;;) {
+        pkt->protocol = ethertype;
+        pkt->l3_offset = (uint16_t)offset;
+
+        if (ethertype == ETH_P_8021Q || ethertype == ETH_P_8021AD) {
+            uint32_t layer = ethertype == ETH_P_8021AD ? PACKET_ENCAP_QINQ : PACKET_ENCAP_VLAN;
+            if (caplen < offset + 4 || !packet_push_encap(pkt, &depth, layer)) {
+                break;
+            }
+            // 后端已从带外信息（硬件剥离的标签）得到 vlan_tci 时保留
+            if (depth == 1 && pkt->vlan_tci == 0) {
+                pkt->vlan_tci = packet_read16(data + offset);
+            }
+            ethertype = packet_read16(data + offset + 2);
+            offset += 4;
+            continue;
+        }
+
+        if (ethertype == ETH_P_MPLS_UC || ethertype == ETH_P_MPLS_MC) {
+            if (!packet_push_encap(pkt, &depth, PACKET_ENCAP_MPLS)) {
+                break;
+            }
+            // 跳过整个标签栈，载荷类型按 IP 版本号猜测
+            bool bottom = false;
+            while (!bottom && caplen >= offset + MPLS_LABEL_LEN) {
+                bottom = data[offset + 2] & 0x01;
+                offset += MPLS_LABEL_LEN;
+            }
+            if (!bottom || caplen < offset + 1) {
+                break;
+            }
+            uint8_t version = data[offset] >> 4;
+            if (version != 4 && version != 6) {
+                break;
+            }
+            ethertype = version == 6 ? ETH_P_IPV6 : ETH_P_IPV4;
+            continue;
+        }
+
+        if (ethertype == ETH_P_TEB) {
+            if (caplen < offset + ETH_HEADER_LEN) {
+                break;
+            }
+            ethertype = packet_read16(data + offset + 12);
+            offset += ETH_HEADER_LEN;
+            continue;
+        }
+
+        // 网络层：地址、传输层协议与偏移
+        const uint8_t* ip = data + offset;
+        uint8_t proto;
+        uint32_t l4;
+        bool whole;  // 没有分片
+        bool first;  // 含传输层头部
+        uint32_t layer;
+        if (ethertype == ETH_P_IPV4) {
+            if (caplen < offset + IPV4_HEADER_LEN) {
+                break;
+            }
+            uint32_t ihl = (uint32_t)(ip[0] & 0x0f) * 4;
+            uint16_t frag = packet_read16(ip + 6) & 0x3fff;
+            proto = ip[9];
+            src = ip + 12;
+            dst = ip + 16;
+            addr_len = 4;
+            l4 = offset + ihl;
+            if (frag) {
+                pkt->flags |= PACKET_FLAG_FRAGMENT;
+            }
+            // 非首片不含传输层头部；首片也只按地址对哈希，与其余分片一致
+            whole = frag == 0 && ihl >= IPV4_HEADER_LEN;
+            first = (frag & 0x1fff) == 0 && ihl >= IPV4_HEADER_LEN;
+            layer = PACKET_ENCAP_IPV4;
+        } else if (ethertype == ETH_P_IPV6) {
+            if (caplen < offset + IPV6_HEADER_LEN) {
+                break;
+            }
+            proto = ip[6];
+            src = ip + 8;
+            dst = ip + 24;
+            addr_len = 16;
+            l4 = offset + IPV6_HEADER_LEN;
+            uint32_t frag = 0;
+            bool reached = packet_ipv6_walk(data, caplen, &l4, &proto, &frag);
+            whole = true;
+            first = reached;
+            if (frag) {
+                // 偏移为 0 且没有后续分片的原子分片按完整数据包处理
+                uint16_t frag_field = packet_read16(data + frag + 2);
+                pkt->frag_hdr_offset = (uint16_t)frag;
+                if (frag_field & (IPV6_FRAG_OFFSET | IPV6_FRAG_MORE)) {
+                    pkt->flags |= PACKET_FLAG_FRAGMENT;
+                    whole = false;
+                    first = reached && (frag_field & IPV6_FRAG_OFFSET) == 0;
+                }
+            }
+            layer = PACKET_ENCAP_IPV6;
+        } else {
+            break;
+        }
+
+        pkt->l4_proto = proto;
+        if (first && caplen >= l4) {
+            pkt->l4_offset = (uint16_t)l4;
+        }
+        sport = 0;
+        dport = 0;
+        hash_proto = 0;
+        if (whole && (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP || proto == IP_PROTO_SCTP) &&
+            caplen >= l4 + 4) {
+            sport = packet_read16(data + l4);
+            dport = packet_read16(data + l4 + 2);
+            hash_proto = proto;
+        }
+
+        // 隧道：记录外层 IP 与隧道头部，继续解码内层；分片的外层无法剥离
+        uint32_t tunnel_layer = PACKET_ENCAP_NONE;
+        uint32_t inner = l4;
+        uint16_t inner_type = whole && caplen >= l4 ? packet_tunnel(data, caplen, proto, &inner, &tunnel_layer) : 0;
+        uint32_t need = tunnel_layer != PACKET_ENCAP_NONE ? 2 : 1;
+        if (inner_type == 0 || depth + need > PACKET_ENCAP_MAX) {
+            break;
+        }
+        packet_push_encap(pkt, &depth, layer);
+        if (tunnel_layer != PACKET_ENCAP_NONE) {
+            packet_push_encap(pkt, &depth, tunnel_layer);
+        }
+        pkt->l4_offset = 0;
+        pkt->l4_proto = 0;
+        pkt->frag_hdr_offset = 0;
+        ethertype = inner_type;
+        offset = inner;
+    }
+
+    if (src != NULL) {
+        pkt->hash = flow_hash(src, dst, addr_len, sport, dport, hash_proto);
+    }
+}
+
+uint32_t packet_linktype_arphrd(uint16_t hatype) {
+    switch (hatype) {
+        case ARPHRD_ETHER:
+        case ARPHRD_LOOPBACK:
+            return PACKET_LINKTYPE_ETHERNET;
+        case ARPHRD_RAWIP:
+        case ARPHRD_NONE:
+            return PACKET_LINKTYPE_RAW;
+        default:
+            return PACKET_LINKTYPE_UNKNOWN;
+    }
+}
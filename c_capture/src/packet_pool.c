@@ -0,0 +1,510 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "packet_pool.h"
+
+#define POOL_SLAB_MAGIC   0x706b7470u  // "pktp"
+#define POOL_SLAB_HEADER  64           // slab 头部大小，对象从其后开始
+#define POOL_CLASS_LARGE  0xffff       // 大对象的尺寸类标记
+#define POOL_MIN_SHIFT    6
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+// slab 头部，位于 1 MiB 对齐的映射起始处
+typedef struct pool_slab {
+    uint32_t magic;                  // 魔数
+    uint16_t size_class;             // 尺寸类，大对象为 POOL_CLASS_LARGE
+    uint16_t node;                   // 所属 NUMA 节点
+    size_t length;                   // 映射长度
+    struct pool_slab* prev;          // 缓冲池 slab 链表
+    struct pool_slab* next;
+} pool_slab_t;
+
+// 某个节点某个尺寸类的全局仓库
+typedef struct {
+    _Alignas(64) pthread_mutex_t lock; // 仓库锁
+    void* free_list;                 // 空闲对象链表（对象首字存放后继指针）
+    uint8_t* carve;                  // 当前 slab 中尚未切分的位置
+    uint8_t* carve_end;              // 当前 slab 可切分的末尾
+} pool_depot_t;
+
+// 线程缓存中一个尺寸类的对象
+typedef struct {
+    void* head;                      // 空闲对象链表
+    uint32_t count;                  // 对象数
+    uint32_t limit;                  // 缓存上限
+} pool_bin_t;
+
+// 线程缓存
+typedef struct pool_cache {
+    struct packet_pool* pool;        // 所属缓冲池
+    uint32_t node;                   // 线程所在 NUMA 节点
+    struct pool_cache* prev;         // 缓冲池缓存链表
+    struct pool_cache* next;
+    pool_bin_t bins[PACKET_POOL_CLASS_COUNT]; // 各尺寸类的缓存
+} pool_cache_t;
+
+struct packet_pool {
+    pthread_key_t key;               // 线程缓存
+    uint32_t node_count;             // NUMA 节点数
+    uint32_t limits[PACKET_POOL_CLASS_COUNT]; // 各尺寸类的线程缓存上限
+    size_t max_bytes;                // 内存上限
+    size_t page_size;                // 页大小
+    pool_depot_t* depots;            // 仓库，按 [节点][尺寸类] 排列
+    pthread_mutex_t lock;            // 保护 slab 与缓存链表
+    pool_slab_t* slabs;              // 全部 slab 与大对象
+    pool_cache_t* caches;            // 全部线程缓存
+    atomic_uint_fast64_t bytes_reserved;
+    atomic_uint_fast64_t slab_count;
+    atomic_uint_fast64_t large_count;
+    atomic_uint_fast64_t depot_refills;
+    atomic_uint_fast64_t depot_flushes;
+    atomic_uint_fast64_t alloc_failures;
+};
+
+static uint32_t pool_size_class(size_t size) {
+    if (size <= PACKET_POOL_MIN_SIZE) {
+        return 0;
+    }
+    return (uint32_t)(64 - __builtin_clzll((unsigned long long)(size - 1))) - POOL_MIN_SHIFT;
+}
+
+static size_t pool_class_size(uint32_t size_class) {
+    return (size_t)PACKET_POOL_MIN_SIZE << size_class;
+}
+
+static pool_slab_t* pool_slab_of(const void* ptr) {
+    return (pool_slab_t*)((uintptr_t)ptr & ~(uintptr_t)(PACKET_POOL_SLAB_SIZE - 1));
+}
+
+// 读取系统可能的 NUMA 节点数（如 "0-3"），失败时视为单节点
+static uint32_t pool_detect_nodes(void) {
+    FILE* fp = fopen("/sys/devices/system/node/possible", "r");
+    if (!fp) {
+        return 1;
+    }
+    char buf[256];
+    uint32_t count = 1;
+    if (fgets(buf, sizeof(buf), fp)) {
+        // 取列表中的最大节点号
+        char* p = buf;
+        while (*p) {
+            if (*p >= '0' && *p <= '9') {
+                unsigned long id = strtoul(p, &p, 10);
+                if (id + 1 > count) {
+                    count = (uint32_t)(id + 1);
+                }
+            } else {
+                p++;
+            }
+        }
+    }
+    fclose(fp);
+    return count > PACKET_POOL_MAX_NODES ? PACKET_POOL_MAX_NODES : count;
+}
+
+static uint32_t pool_current_node(const packet_pool_t* pool) {
+    if (pool->node_count <= 1) {
+        return 0;
+    }
+    unsigned cpu = 0, node = 0;
+#ifdef SYS_getcpu
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) {
+        node = 0;
+    }
+#endif
+    return node % pool->node_count;
+}
+
+// 新映射的页面优先放在指定节点上；失败时保持默认策略
+static void pool_bind(void* addr, size_t length, uint32_t node) {
+#ifdef SYS_mbind
+    unsigned long mask[PACKET_POOL_MAX_NODES / (8 * sizeof(unsigned long)) + 1] = {0};
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    if (syscall(SYS_mbind, addr, length, MPOL_PREFERRED, mask, PACKET_POOL_MAX_NODES + 1, 0) != 0) {
+        // 内核不支持 NUMA 时退回默认分配
+    }
+#else
+    (void)addr;
+    (void)length;
+    (void)node;
+#endif
+}
+
+// 向系统申请按 slab 大小对齐的映射并挂入 slab 链表
+static pool_slab_t* pool_map(packet_pool_t* pool, size_t length, uint32_t node, uint16_t size_class) {
+    uint_fast64_t reserved = atomic_fetch_add(&pool->bytes_reserved, length) + length;
+    if (pool->max_bytes && reserved > pool->max_bytes) {
+        atomic_fetch_sub(&pool->bytes_reserved, length);
+        return NULL;
+    }
+
+    // 多映射一个 slab 大小，再裁掉首尾得到对齐的区域
+    size_t total = length + PACKET_POOL_SLAB_SIZE;
+    uint8_t* raw = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        atomic_fetch_sub(&pool->bytes_reserved, length);
+        return NULL;
+    }
+    uintptr_t aligned = ((uintptr_t)raw + PACKET_POOL_SLAB_SIZE - 1) & ~(uintptr_t)(PACKET_POOL_SLAB_SIZE - 1);
+    size_t head = aligned - (uintptr_t)raw;
+    if (head) {
+        munmap(raw, head);
+    }
+    if (total - head > length) {
+        munmap((uint8_t*)aligned + length, total - head - length);
+    }
+    if (pool->node_count > 1) {
+        pool_bind((void*)aligned, length, node);
+    }
+
+    pool_slab_t* slab = (pool_slab_t*)aligned;
+    slab->magic = POOL_SLAB_MAGIC;
+    slab->size_class = size_class;
+    slab->node = (uint16_t)node;
+    slab->length = length;
+    slab->prev = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    slab->next = pool->slabs;
+    if (pool->slabs) {
+        pool->slabs->prev = slab;
+    }
+    pool->slabs = slab;
+    pthread_mutex_unlock(&pool->lock);
+    return slab;
+}
+
+static void pool_unmap(packet_pool_t* pool, pool_slab_t* slab) {
+    size_t length = slab->length;
+
+    pthread_mutex_lock(&pool->lock);
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        pool->slabs = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    munmap(slab, length);
+    atomic_fetch_sub(&pool->bytes_reserved, length);
+}
+
+static pool_depot_t* pool_depot(packet_pool_t* pool, uint32_t node, uint32_t size_class) {
+    return &pool->depots[node * PACKET_POOL_CLASS_COUNT + size_class];
+}
+
+// 把 first..last 组成的对象链归还仓库
+static void pool_depot_push(pool_depot_t* depot, void* first, void* last) {
+    pthread_mutex_lock(&depot->lock);
+    *(void**)last = depot->free_list;
+    depot->free_list = first;
+    pthread_mutex_unlock(&depot->lock);
+}
+
+// 从仓库取一批对象放入线程缓存，仓库为空时切分新 slab
+static bool pool_refill(packet_pool_t* pool, pool_cache_t* cache, uint32_t size_class) {
+    pool_bin_t* bin = &cache->bins[size_class];
+    pool_depot_t* depot = pool_depot(pool, cache->node, size_class);
+    size_t size = pool_class_size(size_class);
+    uint32_t want = bin->limit / 2 ? bin->limit / 2 : 1;
+    uint32_t got = 0;
+
+    pthread_mutex_lock(&depot->lock);
+    while (got < want && depot->free_list) {
+        void* obj = depot->free_list;
+        depot->free_list = *(void**)obj;
+        *(void**)obj = bin->head;
+        bin->head = obj;
+        got++;
+    }
+    if (got < want && (size_t)(depot->carve_end - depot->carve) < size) {
+        pool_slab_t* slab = got ? NULL : pool_map(pool, PACKET_POOL_SLAB_SIZE, cache->node, (uint16_t)size_class);
+        if (slab) {
+            atomic_fetch_add(&pool->slab_count, 1);
+            depot->carve = (uint8_t*)slab + POOL_SLAB_HEADER;
+            depot->carve_end = (uint8_t*)slab + PACKET_POOL_SLAB_SIZE;
+        }
+    }
+    // 按需切分，未用到的部分不占用物理页
+    while (got < want && (size_t)(depot->carve_end - depot->carve) >= size) {
+        void* obj = depot->carve;
+        depot->carve += size;
+        *(void**)obj = bin->head;
+        bin->head = obj;
+        got++;
+    }
+    pthread_mutex_unlock(&depot->lock);
+
+    bin->count += got;
+    atomic_fetch_add(&pool->depot_refills, 1);
+    return got > 0;
+}
+
+// 把线程缓存中的 count 个对象归还仓库
+static void pool_flush_bin(packet_pool_t* pool, pool_cache_t* cache, uint32_t size_class, uint32_t count) {
+    pool_bin_t* bin = &cache->bins[size_class];
+    if (count == 0 || !bin->head) {
+        return;
+    }
+    void* first = bin->head;
+    void* last = first;
+    for (uint32_t i = 1; i < count && *(void**)last; i++) {
+        last = *(void**)last;
+        bin->count--;
+    }
+    bin->count--;
+    bin->head = *(void**)last;
+    pool_depot_push(pool_depot(pool, cache->node, size_class), first, last);
+    atomic_fetch_add(&pool->depot_flushes, 1);
+}
+
+// 线程退出时归还缓存
+static void pool_cache_release(void* arg) {
+    pool_cache_t* cache = (pool_cache_t*)arg;
+    packet_pool_t* pool = cache->pool;
+
+    for (uint32_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+        pool_flush_bin(pool, cache, i, cache->bins[i].count);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (cache->prev) {
+        cache->prev->next = cache->next;
+    } else {
+        pool->caches = cache->next;
+    }
+    if (cache->next) {
+        cache->next->prev = cache->prev;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    free(cache);
+}
+
+static pool_cache_t* pool_cache(packet_pool_t* pool) {
+    pool_cache_t* cache = (pool_cache_t*)pthread_getspecific(pool->key);
+    if (cache) {
+        return cache;
+    }
+
+    cache = (pool_cache_t*)calloc(1, sizeof(pool_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+    cache->pool = pool;
+    cache->node = pool_current_node(pool);
+    for (uint32_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+        cache->bins[i].limit = pool->limits[i];
+    }
+    if (pthread_setspecific(pool->key, cache) != 0) {
+        free(cache);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    cache->next = pool->caches;
+    if (pool->caches) {
+        pool->caches->prev = cache;
+    }
+    pool->caches = cache;
+    pthread_mutex_unlock(&pool->lock);
+    return cache;
+}
+
+packet_pool_t* packet_pool_create(const packet_pool_config_t* config) {
+    packet_pool_config_t cfg = {0};
+    if (config) {
+        cfg = *config;
+    }
+    if (!cfg.cache_count) {
+        cfg.cache_count = PACKET_POOL_DEFAULT_CACHE_COUNT;
+    }
+    if (!cfg.cache_bytes) {
+        cfg.cache_bytes = PACKET_POOL_DEFAULT_CACHE_BYTES;
+    }
+
+    packet_pool_t* pool = (packet_pool_t*)calloc(1, sizeof(packet_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->node_count = pool_detect_nodes();
+    pool->max_bytes = cfg.max_bytes;
+    pool->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    for (uint32_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+        size_t by_bytes = cfg.cache_bytes / pool_class_size(i);
+        uint32_t limit = by_bytes < cfg.cache_count ? (uint32_t)by_bytes : cfg.cache_count;
+        pool->limits[i] = limit < 2 ? 2 : limit;
+    }
+
+    size_t depot_count = (size_t)pool->node_count * PACKET_POOL_CLASS_COUNT;
+    pool->depots = (pool_depot_t*)aligned_alloc(_Alignof(pool_depot_t), depot_count * sizeof(pool_depot_t));
+    if (!pool->depots) {
+        free(pool);
+        return NULL;
+    }
+    memset(pool->depots, 0, depot_count * sizeof(pool_depot_t));
+    for (size_t i = 0; i < depot_count; i++) {
+        pthread_mutex_init(&pool->depots[i].lock, NULL);
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+
+    if (pthread_key_create(&pool->key, pool_cache_release) != 0) {
+        for (size_t i = 0; i < depot_count; i++) {
+            pthread_mutex_destroy(&pool->depots[i].lock);
+        }
+        pthread_mutex_destroy(&pool->lock);
+        free(pool->depots);
+        free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void packet_pool_destroy(packet_pool_t* pool) {
+    if (!pool) {
+        return;
+    }
+
+    // 删除键后线程退出时不再回调，剩余缓存在这里统一释放
+    pthread_key_delete(pool->key);
+    pool_cache_t* cache = pool->caches;
+    while (cache) {
+        pool_cache_t* next = cache->next;
+        free(cache);
+        cache = next;
+    }
+    pool_slab_t* slab = pool->slabs;
+    while (slab) {
+        pool_slab_t* next = slab->next;
+        munmap(slab, slab->length);
+        slab = next;
+    }
+
+    size_t depot_count = (size_t)pool->node_count * PACKET_POOL_CLASS_COUNT;
+    for (size_t i = 0; i < depot_count; i++) {
+        pthread_mutex_destroy(&pool->depots[i].lock);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->depots);
+    free(pool);
+}
+
+// 超过最大尺寸类的请求单独映射
+static void* pool_alloc_large(packet_pool_t* pool, size_t size) {
+    if (size > SIZE_MAX - POOL_SLAB_HEADER - PACKET_POOL_SLAB_SIZE - pool->page_size) {
+        atomic_fetch_add(&pool->alloc_failures, 1);
+        return NULL;
+    }
+    size_t length = (POOL_SLAB_HEADER + size + pool->page_size - 1) & ~(pool->page_size - 1);
+    pool_slab_t* slab = pool_map(pool, length, pool_current_node(pool), POOL_CLASS_LARGE);
+    if (!slab) {
+        atomic_fetch_add(&pool->alloc_failures, 1);
+        return NULL;
+    }
+    atomic_fetch_add(&pool->large_count, 1);
+    return (uint8_t*)slab + POOL_SLAB_HEADER;
+}
+
+void* packet_pool_alloc(packet_pool_t* pool, size_t size) {
+    if (!pool) {
+        return NULL;
+    }
+    if (size > PACKET_POOL_MAX_SIZE) {
+        return pool_alloc_large(pool, size);
+    }
+
+    uint32_t size_class = pool_size_class(size);
+    pool_cache_t* cache = pool_cache(pool);
+    if (!cache) {
+        atomic_fetch_add(&pool->alloc_failures, 1);
+        return NULL;
+    }
+
+    pool_bin_t* bin = &cache->bins[size_class];
+    if (!bin->head && !pool_refill(pool, cache, size_class)) {
+        atomic_fetch_add(&pool->alloc_failures, 1);
+        return NULL;
+    }
+    void* obj = bin->head;
+    bin->head = *(void**)obj;
+    bin->count--;
+    return obj;
+}
+
+void packet_pool_free(packet_pool_t* pool, void* ptr) {
+    if (!pool || !ptr) {
+        return;
+    }
+
+    pool_slab_t* slab = pool_slab_of(ptr);
+    if (slab->size_class == POOL_CLASS_LARGE) {
+        pool_unmap(pool, slab);
+        atomic_fetch_sub(&pool->large_count, 1);
+        return;
+    }
+
+    uint32_t size_class = slab->size_class;
+    pool_cache_t* cache = pool_cache(pool);
+    // 其他节点的对象直接归还所属节点，保持仓库的 NUMA 局部性
+    if (!cache || slab->node != cache->node) {
+        pool_depot_push(pool_depot(pool, slab->node, size_class), ptr, ptr);
+        return;
+    }
+
+    pool_bin_t* bin = &cache->bins[size_class];
+    *(void**)ptr = bin->head;
+    bin->head = ptr;
+    bin->count++;
+    if (bin->count > bin->limit) {
+        pool_flush_bin(pool, cache, size_class, bin->limit / 2 ? bin->limit / 2 : 1);
+    }
+}
+
+size_t packet_pool_usable_size(const void* ptr) {
+    if (!ptr) {
+        return 0;
+    }
+    const pool_slab_t* slab = pool_slab_of(ptr);
+    if (slab->size_class == POOL_CLASS_LARGE) {
+        return slab->length - POOL_SLAB_HEADER;
+    }
+    return pool_class_size(slab->size_class);
+}
+
+void packet_pool_thread_flush(packet_pool_t* pool) {
+    if (!pool) {
+        return;
+    }
+    pool_cache_t* cache = (pool_cache_t*)pthread_getspecific(pool->key);
+    if (!cache) {
+        return;
+    }
+    for (uint32_t i = 0; i < PACKET_POOL_CLASS_COUNT; i++) {
+        pool_flush_bin(pool, cache, i, cache->bins[i].count);
+    }
+}
+
+void packet_pool_get_stats(packet_pool_t* pool, packet_pool_stats_t* stats) {
+    if (!pool || !stats) {
+        return;
+    }
+    stats->bytes_reserved = atomic_load(&pool->bytes_reserved);
+    stats->slab_count = atomic_load(&pool->slab_count);
+    stats->large_count = atomic_load(&pool->large_count);
+    stats->depot_refills = atomic_load(&pool->depot_refills);
+    stats->depot_flushes = atomic_load(&pool->depot_flushes);
+    stats->alloc_failures = atomic_load(&pool->alloc_failures);
+}
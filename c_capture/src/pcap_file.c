@@ -0,0 +1,545 @@
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "pcap_file.h"
+
+// 经典 pcap 魔数
+#define PCAP_MAGIC_USEC          0xa1b2c3d4u
+#define PCAP_MAGIC_USEC_SWAPPED  0xd4c3b2a1u
+#define PCAP_MAGIC_NSEC          0xa1b23c4du
+#define PCAP_MAGIC_NSEC_SWAPPED  0x4d3cb2a1u
+
+#define PCAP_FILE_HEADER_LEN     24
+#define PCAP_RECORD_HEADER_LEN   16
+
+// pcapng 块类型
+#define PCAPNG_BLOCK_SHB         0x0a0d0d0au
+#define PCAPNG_BLOCK_IDB         0x00000001u
+#define PCAPNG_BLOCK_PB          0x00000002u
+#define PCAPNG_BLOCK_SPB         0x00000003u
+#define PCAPNG_BLOCK_EPB         0x00000006u
+#define PCAPNG_BYTE_ORDER_MAGIC  0x1a2b3c4du
+#define PCAPNG_OPT_IF_TSRESOL    9
+
+// 单条记录长度上限，超过视为文件损坏
+#define PCAP_FILE_MAX_RECORD     (64u << 20)
+
+static uint16_t pcap_file_rd16(const pcap_file_parser_t* parser, const uint8_t* p) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return parser->swapped ? __builtin_bswap16(v) : v;
+}
+
+static uint32_t pcap_file_rd32(const pcap_file_parser_t* parser, const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return parser->swapped ? __builtin_bswap32(v) : v;
+}
+
+// 按接口的时间戳精度把原始时间戳转换为 timespec
+static struct timespec pcap_file_ts(const pcap_file_iface_t* iface, uint64_t ts) {
+    struct timespec out;
+    if (iface->tsresol_base2) {
+        // 解析接口描述块时已保证指数不超过 63
+        uint64_t mask = (1ull << iface->tsresol_exp) - 1;
+        out.tv_sec = (time_t)(ts >> iface->tsresol_exp);
+        out.tv_nsec = (long)(((unsigned __int128)(ts & mask) * 1000000000u) >> iface->tsresol_exp);
+        return out;
+    }
+
+    uint64_t units = 1;
+    for (uint8_t i = 0; i < iface->tsresol_exp; i++) {
+        units *= 10;
+    }
+    out.tv_sec = (time_t)(ts / units);
+    uint64_t frac = ts % units;
+    if (iface->tsresol_exp <= 9) {
+        for (uint8_t i = iface->tsresol_exp; i < 9; i++) {
+            frac *= 10;
+        }
+    } else {
+        for (uint8_t i = 9; i < iface->tsresol_exp; i++) {
+            frac /= 10;
+        }
+    }
+    out.tv_nsec = (long)frac;
+    return out;
+}
+
+// 解析 pcapng 节头块，返回块长度（数据不足返回 0，错误返回 -1）
+static long pcapng_parse_shb(pcap_file_parser_t* parser, const uint8_t* buf, size_t len) {
+    if (len < 12) {
+        return 0;
+    }
+
+    uint32_t magic;
+    memcpy(&magic, buf + 8, sizeof(magic));
+    if (magic == PCAPNG_BYTE_ORDER_MAGIC) {
+        parser->swapped = false;
+    } else if (magic == __builtin_bswap32(PCAPNG_BYTE_ORDER_MAGIC)) {
+        parser->swapped = true;
+    } else {
+        return -1;
+    }
+
+    uint32_t block_len = pcap_file_rd32(parser, buf + 4);
+    if (block_len < 28 || (block_len & 3) || block_len > PCAP_FILE_MAX_RECORD) {
+        return -1;
+    }
+    if (len < block_len) {
+        return 0;
+    }
+
+    // 新节开始，接口编号重新计数
+    parser->format = PCAP_FILE_FORMAT_PCAPNG;
+    parser->section++;
+    parser->if_count = 0;
+    return (long)block_len;
+}
+
+// 解析 pcapng 接口描述块
+static int pcapng_parse_idb(pcap_file_parser_t* parser, const uint8_t* block, uint32_t block_len) {
+    if (block_len < 20) {
+        return -1;
+    }
+    if (parser->if_count >= PCAP_FILE_MAX_IFACES) {
+        return -1;
+    }
+
+    pcap_file_iface_t* iface = &parser->ifaces[parser->if_count];
+    iface->linktype = pcap_file_rd16(parser, block + 8);
+    iface->tsresol_base2 = 0;
+    iface->tsresol_exp = 6;  // 默认微秒
+
+    uint32_t snaplen = pcap_file_rd32(parser, block + 12);
+    if (parser->if_count == 0) {
+        parser->linktype = iface->linktype;
+        parser->snaplen = snaplen;
+    }
+
+    // 遍历选项，只关心 if_tsresol
+    const uint8_t* opt = block + 16;
+    const uint8_t* end = block + block_len - 4;
+    while (opt + 4 <= end) {
+        uint16_t code = pcap_file_rd16(parser, opt);
+        uint16_t opt_len = pcap_file_rd16(parser, opt + 2);
+        if (code == 0) {
+            break;
+        }
+        if (opt + 4 + opt_len > end) {
+            return -1;
+        }
+        if (code == PCAPNG_OPT_IF_TSRESOL && opt_len >= 1) {
+            uint8_t v = opt[4];
+            iface->tsresol_base2 = (v & 0x80) ? 1 : 0;
+            iface->tsresol_exp = v & 0x7f;
+            // 10^19 与 2^63 是 64 位时间戳能表示的最大精度，更大的指数在换算时会溢出或移位越界
+            if (iface->tsresol_exp > (iface->tsresol_base2 ? 63 : 19)) {
+                return -1;
+            }
+        }
+        opt += 4 + ((opt_len + 3u) & ~3u);
+    }
+
+    parser->if_count++;
+    return 0;
+}
+
+int pcap_file_parser_init(
+    pcap_file_parser_t* parser,
+    const uint8_t* buf,
+    size_t len,
+    size_t* consumed
+) {
+    if (!parser || !buf || !consumed) {
+        return -1;
+    }
+
+    memset(parser, 0, sizeof(*parser));
+    *consumed = 0;
+    if (len < 4) {
+        return 0;
+    }
+
+    uint32_t magic;
+    memcpy(&magic, buf, sizeof(magic));
+
+    if (magic == PCAPNG_BLOCK_SHB) {
+        long block_len = pcapng_parse_shb(parser, buf, len);
+        if (block_len <= 0) {
+            return (int)block_len;
+        }
+        *consumed = (size_t)block_len;
+        return 1;
+    }
+
+    switch (magic) {
+        case PCAP_MAGIC_USEC:
+            break;
+        case PCAP_MAGIC_USEC_SWAPPED:
+            parser->swapped = true;
+            break;
+        case PCAP_MAGIC_NSEC:
+            parser->nsec = true;
+            break;
+        case PCAP_MAGIC_NSEC_SWAPPED:
+            parser->swapped = true;
+            parser->nsec = true;
+            break;
+        default:
+            return -1;
+    }
+
+    if (len < PCAP_FILE_HEADER_LEN) {
+        return 0;
+    }
+
+    parser->format = PCAP_FILE_FORMAT_PCAP;
+    parser->snaplen = pcap_file_rd32(parser, buf + 16);
+    parser->linktype = pcap_file_rd32(parser, buf + 20) & 0x0fffffff;
+    parser->if_count = 1;
+    parser->ifaces[0].linktype = (uint16_t)parser->linktype;
+    parser->ifaces[0].tsresol_base2 = 0;
+    parser->ifaces[0].tsresol_exp = parser->nsec ? 9 : 6;
+    *consumed = PCAP_FILE_HEADER_LEN;
+    return 1;
+}
+
+// 解析一条经典 pcap 记录
+static int pcap_parse_record(
+    pcap_file_parser_t* parser,
+    const uint8_t* buf,
+    size_t len,
+    size_t* consumed,
+    packet_t* pkt
+) {
+    if (len < PCAP_RECORD_HEADER_LEN) {
+        return 0;
+    }
+
+    uint32_t caplen = pcap_file_rd32(parser, buf + 8);
+    if (caplen > PCAP_FILE_MAX_RECORD) {
+        return -1;
+    }
+    if (len < PCAP_RECORD_HEADER_LEN + (size_t)caplen) {
+        return 0;
+    }
+
+    uint32_t frac = pcap_file_rd32(parser, buf + 4);
+    memset(pkt, 0, sizeof(*pkt));
+    pkt->data = buf + PCAP_RECORD_HEADER_LEN;
+    pkt->caplen = caplen;
+    pkt->len = pcap_file_rd32(parser, buf + 12);
+    pkt->ts.tv_sec = (time_t)pcap_file_rd32(parser, buf);
+    pkt->ts.tv_nsec = parser->nsec ? (long)frac : (long)frac * 1000;
+
+    parser->record_offset = 0;
+    *consumed = PCAP_RECORD_HEADER_LEN + caplen;
+    return 1;
+}
+
+// 解析 pcapng 块，直到得到一个数据包或数据不足
+static int pcapng_parse_blocks(
+    pcap_file_parser_t* parser,
+    const uint8_t* buf,
+    size_t len,
+    size_t* consumed,
+    packet_t* pkt
+) {
+    size_t pos = 0;
+    *consumed = 0;
+
+    while (len - pos >= 12) {
+        const uint8_t* block = buf + pos;
+        uint32_t type;
+        memcpy(&type, block, sizeof(type));
+
+        if (type == PCAPNG_BLOCK_SHB) {
+            long shb_len = pcapng_parse_shb(parser, block, len - pos);
+            if (shb_len <= 0) {
+                return (int)shb_len;
+            }
+            pos += (size_t)shb_len;
+            *consumed = pos;
+            continue;
+        }
+
+        type = pcap_file_rd32(parser, block);
+        uint32_t block_len = pcap_file_rd32(parser, block + 4);
+        if (block_len < 12 || (block_len & 3) || block_len > PCAP_FILE_MAX_RECORD) {
+            return -1;
+        }
+        if (len - pos < block_len) {
+            return 0;
+        }
+
+        switch (type) {
+            case PCAPNG_BLOCK_IDB:
+                if (pcapng_parse_idb(parser, block, block_len) != 0) {
+                    return -1;
+                }
+                break;
+
+            case PCAPNG_BLOCK_EPB:
+            case PCAPNG_BLOCK_PB: {
+                if (block_len < 32) {
+                    return -1;
+                }
+                uint32_t if_id = (type == PCAPNG_BLOCK_EPB)
+                    ? pcap_file_rd32(parser, block + 8)
+                    : pcap_file_rd16(parser, block + 8);
+                uint32_t caplen = pcap_file_rd32(parser, block + 20);
+                if (if_id >= parser->if_count || 28 + (size_t)caplen > block_len - 4) {
+                    return -1;
+                }
+                uint64_t ts = ((uint64_t)pcap_file_rd32(parser, block + 12) << 32) |
+                              pcap_file_rd32(parser, block + 16);
+
+                memset(pkt, 0, sizeof(*pkt));
+                pkt->data = block + 28;
+                pkt->caplen = caplen;
+                pkt->len = pcap_file_rd32(parser, block + 24);
+                pkt->ts = pcap_file_ts(&parser->ifaces[if_id], ts);
+                pkt->if_index = if_id;
+
+                parser->record_offset = pos;
+                *consumed = pos + block_len;
+                return 1;
+            }
+
+            case PCAPNG_BLOCK_SPB: {
+                if (block_len < 16 || parser->if_count == 0) {
+                    return -1;
+                }
+                // 简单数据包块不带时间戳，捕获长度由块长度推算
+                uint32_t orig_len = pcap_file_rd32(parser, block + 8);
+                uint32_t caplen = block_len - 16;
+                if (caplen > orig_len) {
+                    caplen = orig_len;
+                }
+                if (parser->snaplen && caplen > parser->snaplen) {
+                    caplen = parser->snaplen;
+                }
+
+                memset(pkt, 0, sizeof(*pkt));
+                pkt->data = block + 12;
+                pkt->caplen = caplen;
+                pkt->len = orig_len;
+
+                parser->record_offset = pos;
+                *consumed = pos + block_len;
+                return 1;
+            }
+
+            default:
+                // 统计、名称解析等其他块直接跳过
+                break;
+        }
+
+        pos += block_len;
+        *consumed = pos;
+    }
+
+    return 0;
+}
+
+int pcap_file_parser_next(
+    pcap_file_parser_t* parser,
+    const uint8_t* buf,
+    size_t len,
+    size_t* consumed,
+    packet_t* pkt
+) {
+    if (!parser || !buf || !consumed || !pkt) {
+        return -1;
+    }
+
+    *consumed = 0;
+    if (parser->format == PCAP_FILE_FORMAT_PCAPNG) {
+        return pcapng_parse_blocks(parser, buf, len, consumed, pkt);
+    }
+    return pcap_parse_record(parser, buf, len, consumed, pkt);
+}
+
+// 解析器状态发生变化（新节或新接口）时记录快照，按索引读取时据此恢复状态
+typedef struct {
+    size_t first_index;              // 该快照适用的第一个数据包索引
+    pcap_file_parser_t parser;       // 解析器状态
+} pcap_mmap_section_t;
+
+struct pcap_mmap_reader {
+    int fd;                          // 文件描述符
+    const uint8_t* map;              // 文件映射
+    size_t size;                     // 文件大小
+    uint64_t* offsets;               // 每条记录相对文件起始的偏移
+    size_t count;                    // 数据包数量
+    size_t capacity;                 // 偏移数组容量
+    pcap_mmap_section_t* sections;   // 解析器状态快照
+    size_t section_count;            // 快照数量
+};
+
+static int pcap_mmap_reader_push_section(pcap_mmap_reader_t* reader, const pcap_file_parser_t* parser) {
+    pcap_mmap_section_t* sections = realloc(reader->sections,
+        (reader->section_count + 1) * sizeof(pcap_mmap_section_t));
+    if (!sections) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+    reader->sections = sections;
+    reader->sections[reader->section_count].first_index = reader->count;
+    reader->sections[reader->section_count].parser = *parser;
+    reader->section_count++;
+    return CAPTURE_SUCCESS;
+}
+
+// 线性扫描一次文件，建立记录偏移索引
+static int pcap_mmap_reader_index(pcap_mmap_reader_t* reader) {
+    pcap_file_parser_t parser;
+    size_t consumed;
+    int ret = pcap_file_parser_init(&parser, reader->map, reader->size, &consumed);
+    if (ret <= 0) {
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    // 按平均 256 字节一条记录预估容量
+    reader->capacity = reader->size / 256 + 16;
+    reader->offsets = malloc(reader->capacity * sizeof(uint64_t));
+    if (!reader->offsets) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+
+    uint32_t last_section = parser.section;
+    uint32_t last_if_count = parser.if_count;
+    bool have_section = false;
+    size_t pos = consumed;
+
+    while (pos < reader->size) {
+        packet_t pkt;
+        ret = pcap_file_parser_next(&parser, reader->map + pos, reader->size - pos, &consumed, &pkt);
+        if (ret <= 0) {
+            // 末尾被截断的记录直接忽略
+            break;
+        }
+
+        if (!have_section || parser.section != last_section || parser.if_count != last_if_count) {
+            if (pcap_mmap_reader_push_section(reader, &parser) != CAPTURE_SUCCESS) {
+                return CAPTURE_ERROR_MEMORY;
+            }
+            last_section = parser.section;
+            last_if_count = parser.if_count;
+            have_section = true;
+        }
+
+        if (reader->count == reader->capacity) {
+            size_t capacity = reader->capacity * 2;
+            uint64_t* offsets = realloc(reader->offsets, capacity * sizeof(uint64_t));
+            if (!offsets) {
+                return CAPTURE_ERROR_MEMORY;
+            }
+            reader->offsets = offsets;
+            reader->capacity = capacity;
+        }
+        reader->offsets[reader->count++] = pos + parser.record_offset;
+        pos += consumed;
+    }
+
+    return CAPTURE_SUCCESS;
+}
+
+int pcap_mmap_reader_open(const char* path, pcap_mmap_reader_t** reader) {
+    if (!path || !reader) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    pcap_mmap_reader_t* r = calloc(1, sizeof(pcap_mmap_reader_t));
+    if (!r) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+
+    r->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (r->fd < 0) {
+        free(r);
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    struct stat st;
+    if (fstat(r->fd, &st) != 0 || st.st_size <= 0) {
+        pcap_mmap_reader_close(r);
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+    r->size = (size_t)st.st_size;
+
+    void* map = mmap(NULL, r->size, PROT_READ, MAP_SHARED, r->fd, 0);
+    if (map == MAP_FAILED) {
+        pcap_mmap_reader_close(r);
+        return CAPTURE_ERROR_MEMORY;
+    }
+    r->map = map;
+
+    // 索引阶段与重放阶段都是顺序访问
+    madvise(map, r->size, MADV_SEQUENTIAL);
+
+    int ret = pcap_mmap_reader_index(r);
+    if (ret != CAPTURE_SUCCESS) {
+        pcap_mmap_reader_close(r);
+        return ret;
+    }
+
+    *reader = r;
+    return CAPTURE_SUCCESS;
+}
+
+void pcap_mmap_reader_close(pcap_mmap_reader_t* reader) {
+    if (!reader) {
+        return;
+    }
+    if (reader->map) {
+        munmap((void*)reader->map, reader->size);
+    }
+    if (reader->fd >= 0) {
+        close(reader->fd);
+    }
+    free(reader->offsets);
+    free(reader->sections);
+    free(reader);
+}
+
+size_t pcap_mmap_reader_count(const pcap_mmap_reader_t* reader) {
+    return reader ? reader->count : 0;
+}
+
+uint32_t pcap_mmap_reader_linktype(const pcap_mmap_reader_t* reader) {
+    if (!reader || reader->section_count == 0) {
+        return 0;
+    }
+    return reader->sections[0].parser.linktype;
+}
+
+int pcap_mmap_reader_get(const pcap_mmap_reader_t* reader, size_t index, packet_t* pkt) {
+    if (!reader || !pkt || index >= reader->count) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    // 二分查找该记录所属的解析器快照
+    size_t lo = 0;
+    size_t hi = reader->section_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (reader->sections[mid].first_index <= index) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    pcap_file_parser_t parser = reader->sections[lo].parser;
+    uint64_t offset = reader->offsets[index];
+    size_t consumed;
+    if (pcap_file_parser_next(&parser, reader->map + offset, reader->size - offset, &consumed, pkt) != 1) {
+        return CAPTURE_ERROR_INTERNAL;
+    }
+    return CAPTURE_SUCCESS;
+}
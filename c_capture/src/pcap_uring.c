@@ -0,0 +1,492 @@
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "pcap_file.h"
+
+#define PCAP_URING_ALIGN        4096
+#define PCAP_URING_CARRY_STEP   65536u       // 拼接跨块记录时每次追加的字节数
+#define PCAP_URING_CARRY_MAX    (64u << 20)  // 与解析器的单条记录上限一致
+
+// 一个注册缓冲区及其对应的文件块
+typedef struct {
+    uint8_t* data;                   // 缓冲区
+    uint64_t seq;                    // 文件块序号
+    uint32_t expected;               // 应读取的字节数
+    uint32_t filled;                 // 已读取的字节数
+    bool in_flight;                  // 是否有在途读请求
+    bool ready;                      // 是否已读完
+} pcap_uring_chunk_t;
+
+struct pcap_uring_reader {
+    int fd;                          // 文件描述符
+    uint64_t file_size;              // 文件大小
+    int ring_fd;                     // io_uring 实例
+    void* sq_map;                    // 提交队列映射
+    size_t sq_map_len;               // 提交队列映射长度
+    void* cq_map;                    // 完成队列映射
+    size_t cq_map_len;               // 完成队列映射长度
+    struct io_uring_sqe* sqes;       // 提交队列项
+    size_t sqes_len;                 // 提交队列项映射长度
+    uint32_t* sq_tail;               // 提交队列尾
+    uint32_t* sq_mask;               // 提交队列掩码
+    uint32_t* sq_array;              // 提交队列索引数组
+    uint32_t* cq_head;               // 完成队列头
+    uint32_t* cq_tail;               // 完成队列尾
+    uint32_t* cq_mask;               // 完成队列掩码
+    struct io_uring_cqe* cqes;       // 完成队列项
+    uint32_t pending_submit;         // 尚未提交给内核的请求数
+    uint32_t in_flight;              // 在途请求数
+    uint8_t* buffers;                // 注册缓冲区区域
+    uint32_t chunk_size;             // 单块大小
+    uint32_t queue_depth;            // 缓冲区数量
+    pcap_uring_chunk_t* chunks;      // 缓冲区状态
+    uint64_t chunk_total;            // 文件总块数
+    uint64_t cur_seq;                // 正在解析的块序号
+    size_t cur_pos;                  // 当前块内的解析位置
+    uint8_t* carry;                  // 跨块记录拼接缓冲区
+    size_t carry_len;                // 拼接缓冲区已有字节数
+    size_t carry_cap;                // 拼接缓冲区容量
+    size_t carry_prefix;             // 拼接缓冲区中来自之前块的字节数
+    bool in_carry;                   // 是否处于拼接状态
+    bool failed;                     // 是否发生读错误
+    pcap_file_parser_t parser;       // 记录解析器
+};
+
+static int pcap_uring_setup(uint32_t entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int pcap_uring_enter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int pcap_uring_register(int ring_fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+// 映射提交队列与完成队列
+static int pcap_uring_map_rings(pcap_uring_reader_t* r, const struct io_uring_params* p) {
+    r->sq_map_len = p->sq_off.array + p->sq_entries * sizeof(uint32_t);
+    r->cq_map_len = p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (p->features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && r->cq_map_len > r->sq_map_len) {
+        r->sq_map_len = r->cq_map_len;
+    }
+
+    r->sq_map = mmap(NULL, r->sq_map_len, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, r->ring_fd, IORING_OFF_SQ_RING);
+    if (r->sq_map == MAP_FAILED) {
+        r->sq_map = NULL;
+        return -1;
+    }
+
+    if (single) {
+        r->cq_map = r->sq_map;
+    } else {
+        r->cq_map = mmap(NULL, r->cq_map_len, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, r->ring_fd, IORING_OFF_CQ_RING);
+        if (r->cq_map == MAP_FAILED) {
+            r->cq_map = NULL;
+            return -1;
+        }
+    }
+
+    r->sqes_len = p->sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_len, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, r->ring_fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) {
+        r->sqes = NULL;
+        return -1;
+    }
+
+    uint8_t* sq = r->sq_map;
+    uint8_t* cq = r->cq_map;
+    r->sq_tail = (uint32_t*)(sq + p->sq_off.tail);
+    r->sq_mask = (uint32_t*)(sq + p->sq_off.ring_mask);
+    r->sq_array = (uint32_t*)(sq + p->sq_off.array);
+    r->cq_head = (uint32_t*)(cq + p->cq_off.head);
+    r->cq_tail = (uint32_t*)(cq + p->cq_off.tail);
+    r->cq_mask = (uint32_t*)(cq + p->cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe*)(cq + p->cq_off.cqes);
+    return 0;
+}
+
+// 为缓冲区 index 排队一个读请求，从块内已读位置继续读
+static void pcap_uring_queue_read(pcap_uring_reader_t* r, uint32_t index) {
+    pcap_uring_chunk_t* chunk = &r->chunks[index];
+    uint32_t tail = *r->sq_tail;
+    uint32_t slot = tail & *r->sq_mask;
+    struct io_uring_sqe* sqe = &r->sqes[slot];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = r->fd;
+    sqe->off = chunk->seq * r->chunk_size + chunk->filled;
+    sqe->addr = (uint64_t)(uintptr_t)(chunk->data + chunk->filled);
+    // 按缓冲区剩余容量请求，O_DIRECT 下文件末尾的不对齐长度由内核截短
+    sqe->len = r->chunk_size - chunk->filled;
+    sqe->buf_index = (uint16_t)index;
+    sqe->user_data = index;
+
+    r->sq_array[slot] = slot;
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    chunk->in_flight = true;
+    r->pending_submit++;
+    r->in_flight++;
+}
+
+// 把缓冲区分配给文件块 seq 并提交读取
+static void pcap_uring_assign(pcap_uring_reader_t* r, uint64_t seq) {
+    if (seq >= r->chunk_total) {
+        return;
+    }
+    uint32_t index = (uint32_t)(seq % r->queue_depth);
+    pcap_uring_chunk_t* chunk = &r->chunks[index];
+    uint64_t offset = seq * r->chunk_size;
+    uint64_t remaining = r->file_size - offset;
+
+    chunk->seq = seq;
+    chunk->expected = remaining < r->chunk_size ? (uint32_t)remaining : r->chunk_size;
+    chunk->filled = 0;
+    chunk->ready = false;
+    pcap_uring_queue_read(r, index);
+}
+
+// 收割完成事件；wait 为 true 时至少等待一个完成
+static int pcap_uring_reap(pcap_uring_reader_t* r, bool wait) {
+    uint32_t flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    if (r->pending_submit || wait) {
+        int ret = pcap_uring_enter(r->ring_fd, r->pending_submit, wait ? 1 : 0, flags);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                return 0;
+            }
+            return -1;
+        }
+        r->pending_submit -= (uint32_t)ret < r->pending_submit ? (uint32_t)ret : r->pending_submit;
+    }
+
+    uint32_t head = *r->cq_head;
+    uint32_t tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const struct io_uring_cqe* cqe = &r->cqes[head & *r->cq_mask];
+        pcap_uring_chunk_t* chunk = &r->chunks[cqe->user_data];
+        chunk->in_flight = false;
+        r->in_flight--;
+
+        if (cqe->res < 0) {
+            r->failed = true;
+            continue;
+        }
+        if (cqe->res == 0) {
+            // 文件在打开后被截短
+            chunk->expected = chunk->filled;
+        }
+        chunk->filled += (uint32_t)cqe->res;
+        if (chunk->filled >= chunk->expected) {
+            chunk->filled = chunk->expected;
+            chunk->ready = true;
+        } else {
+            // 短读，继续读取剩余部分
+            pcap_uring_queue_read(r, (uint32_t)cqe->user_data);
+        }
+    }
+    __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// 等待当前块读完
+static pcap_uring_chunk_t* pcap_uring_current(pcap_uring_reader_t* r) {
+    pcap_uring_chunk_t* chunk = &r->chunks[r->cur_seq % r->queue_depth];
+    while (!chunk->ready) {
+        if (r->failed || pcap_uring_reap(r, true) != 0) {
+            r->failed = true;
+            return NULL;
+        }
+    }
+    return chunk;
+}
+
+// 当前块解析完毕，缓冲区立即用于读取后面的块
+static void pcap_uring_advance(pcap_uring_reader_t* r) {
+    pcap_uring_assign(r, r->cur_seq + r->queue_depth);
+    r->cur_seq++;
+    r->cur_pos = 0;
+}
+
+static bool pcap_uring_is_last(const pcap_uring_reader_t* r) {
+    return r->cur_seq + 1 >= r->chunk_total;
+}
+
+// 向拼接缓冲区追加当前块中最多 limit 字节
+static int pcap_uring_carry_append(pcap_uring_reader_t* r, const pcap_uring_chunk_t* chunk, size_t limit) {
+    size_t take = chunk->filled - r->cur_pos;
+    if (take > limit) {
+        take = limit;
+    }
+
+    if (r->carry_len + take > r->carry_cap) {
+        size_t cap = r->carry_cap ? r->carry_cap * 2 : PCAP_URING_CARRY_STEP * 4;
+        while (cap < r->carry_len + take) {
+            cap *= 2;
+        }
+        if (cap > PCAP_URING_CARRY_MAX + PCAP_URING_CARRY_STEP) {
+            return -1;
+        }
+        uint8_t* carry = realloc(r->carry, cap);
+        if (!carry) {
+            return -1;
+        }
+        r->carry = carry;
+        r->carry_cap = cap;
+    }
+
+    memcpy(r->carry + r->carry_len, chunk->data + r->cur_pos, take);
+    r->carry_len += take;
+    r->cur_pos += take;
+    return 0;
+}
+
+// 在拼接缓冲区中解析跨块记录
+static int pcap_uring_next_carry(pcap_uring_reader_t* r, packet_t* pkt) {
+    for (;;) {
+        pcap_uring_chunk_t* chunk = pcap_uring_current(r);
+        if (!chunk) {
+            return -1;
+        }
+
+        if (r->cur_pos == chunk->filled) {
+            if (pcap_uring_is_last(r)) {
+                // 文件末尾的记录不完整
+                r->in_carry = false;
+                return 0;
+            }
+            r->carry_prefix = r->carry_len;
+            pcap_uring_advance(r);
+            continue;
+        }
+
+        if (pcap_uring_carry_append(r, chunk, PCAP_URING_CARRY_STEP) != 0) {
+            return -1;
+        }
+
+        size_t consumed;
+        int ret = pcap_file_parser_next(&r->parser, r->carry, r->carry_len, &consumed, pkt);
+        if (ret < 0) {
+            return -1;
+        }
+
+        if (ret == 1 || consumed >= r->carry_prefix) {
+            // 拼接缓冲区中剩余的字节都来自当前块，回退当前块的解析位置即可
+            r->cur_pos -= r->carry_len - consumed;
+            r->carry_len = 0;
+            r->carry_prefix = 0;
+            r->in_carry = false;
+            if (ret == 1) {
+                return 1;
+            }
+            return 2;
+        }
+
+        // 跳过了完整的非数据包块，但剩余部分仍跨块
+        memmove(r->carry, r->carry + consumed, r->carry_len - consumed);
+        r->carry_len -= consumed;
+        r->carry_prefix -= consumed;
+    }
+}
+
+int pcap_uring_reader_next(pcap_uring_reader_t* reader, packet_t* pkt) {
+    if (!reader || !pkt) {
+        return -1;
+    }
+    pcap_uring_reader_t* r = reader;
+
+    for (;;) {
+        if (r->in_carry) {
+            int ret = pcap_uring_next_carry(r, pkt);
+            if (ret != 2) {
+                return ret;
+            }
+            continue;
+        }
+
+        if (r->cur_seq >= r->chunk_total) {
+            return 0;
+        }
+
+        pcap_uring_chunk_t* chunk = pcap_uring_current(r);
+        if (!chunk) {
+            return -1;
+        }
+
+        size_t consumed;
+        int ret = pcap_file_parser_next(&r->parser, chunk->data + r->cur_pos,
+                                        chunk->filled - r->cur_pos, &consumed, pkt);
+        if (ret < 0) {
+            return -1;
+        }
+        r->cur_pos += consumed;
+        if (ret == 1) {
+            return 1;
+        }
+
+        // 当前块剩余部分不足一条记录
+        if (pcap_uring_is_last(r)) {
+            r->cur_seq = r->chunk_total;
+            return 0;
+        }
+
+        // 当前块随后交还给读请求，剩余部分必须一次全部拷走
+        size_t tail = chunk->filled - r->cur_pos;
+        if (tail > 0) {
+            if (pcap_uring_carry_append(r, chunk, tail) != 0) {
+                return -1;
+            }
+            r->carry_prefix = r->carry_len;
+            r->in_carry = true;
+        }
+        pcap_uring_advance(r);
+    }
+}
+
+int pcap_uring_reader_open(
+    const char* path,
+    const pcap_uring_config_t* config,
+    pcap_uring_reader_t** reader
+) {
+    if (!path || !reader) {
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    pcap_uring_reader_t* r = calloc(1, sizeof(pcap_uring_reader_t));
+    if (!r) {
+        return CAPTURE_ERROR_MEMORY;
+    }
+    r->fd = -1;
+    r->ring_fd = -1;
+    r->chunk_size = (config && config->chunk_size) ? config->chunk_size : PCAP_URING_DEFAULT_CHUNK_SIZE;
+    r->queue_depth = (config && config->queue_depth) ? config->queue_depth : PCAP_URING_DEFAULT_QUEUE_DEPTH;
+    if (r->chunk_size % PCAP_URING_ALIGN != 0 || r->queue_depth > UINT16_MAX) {
+        free(r);
+        return CAPTURE_ERROR_INVALID_PARAM;
+    }
+
+    int flags = O_RDONLY | O_CLOEXEC;
+    if (config && config->direct_io) {
+        flags |= O_DIRECT;
+    }
+    r->fd = open(path, flags);
+    if (r->fd < 0 && (flags & O_DIRECT) && errno == EINVAL) {
+        // 文件系统不支持 O_DIRECT 时退回页缓存读取
+        r->fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (r->fd < 0) {
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+
+    struct stat st;
+    if (fstat(r->fd, &st) != 0 || st.st_size <= 0) {
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+    r->file_size = (uint64_t)st.st_size;
+    r->chunk_total = (r->file_size + r->chunk_size - 1) / r->chunk_size;
+    posix_fadvise(r->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // 每个缓冲区最多一个在途请求，短读续读也复用同一个槽位
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    r->ring_fd = pcap_uring_setup(r->queue_depth, &params);
+    if (r->ring_fd < 0 || pcap_uring_map_rings(r, &params) != 0) {
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+
+    size_t region = (size_t)r->chunk_size * r->queue_depth;
+    if (posix_memalign((void**)&r->buffers, PCAP_URING_ALIGN, region) != 0) {
+        r->buffers = NULL;
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_MEMORY;
+    }
+
+    r->chunks = calloc(r->queue_depth, sizeof(pcap_uring_chunk_t));
+    struct iovec* iovs = calloc(r->queue_depth, sizeof(struct iovec));
+    if (!r->chunks || !iovs) {
+        free(iovs);
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_MEMORY;
+    }
+    for (uint32_t i = 0; i < r->queue_depth; i++) {
+        r->chunks[i].data = r->buffers + (size_t)i * r->chunk_size;
+        iovs[i].iov_base = r->chunks[i].data;
+        iovs[i].iov_len = r->chunk_size;
+    }
+
+    int ret = pcap_uring_register(r->ring_fd, IORING_REGISTER_BUFFERS, iovs, r->queue_depth);
+    free(iovs);
+    if (ret != 0) {
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_INIT_FAILED;
+    }
+
+    // 一次性把所有缓冲区投入读取
+    for (uint64_t seq = 0; seq < r->queue_depth; seq++) {
+        pcap_uring_assign(r, seq);
+    }
+
+    pcap_uring_chunk_t* first = pcap_uring_current(r);
+    size_t consumed;
+    if (!first || pcap_file_parser_init(&r->parser, first->data, first->filled, &consumed) != 1) {
+        pcap_uring_reader_close(r);
+        return CAPTURE_ERROR_OPEN_FAILED;
+    }
+    r->cur_pos = consumed;
+
+    *reader = r;
+    return CAPTURE_SUCCESS;
+}
+
+void pcap_uring_reader_close(pcap_uring_reader_t* reader) {
+    if (!reader) {
+        return;
+    }
+
+    // 缓冲区释放前必须等所有在途读请求完成
+    while (reader->ring_fd >= 0 && reader->in_flight > 0) {
+        if (pcap_uring_reap(reader, true) != 0) {
+            break;
+        }
+    }
+
+    if (reader->sqes) {
+        munmap(reader->sqes, reader->sqes_len);
+    }
+    if (reader->cq_map && reader->cq_map != reader->sq_map) {
+        munmap(reader->cq_map, reader->cq_map_len);
+    }
+    if (reader->sq_map) {
+        munmap(reader->sq_map, reader->sq_map_len);
+    }
+    if (reader->ring_fd >= 0) {
+        close(reader->ring_fd);
+    }
+    if (reader->fd >= 0) {
+        close(reader->fd);
+    }
+    free(reader->buffers);
+    free(reader->chunks);
+    free(reader->carry);
+    free(reader);
+}
+
+uint32_t pcap_uring_reader_linktype(const pcap_uring_reader_t* reader) {
+    return reader ? reader->parser.linktype : 0;
+}
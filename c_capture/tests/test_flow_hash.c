@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 直接包含实现，以便分别调用查表与硬件指令两种计算方式
+#include "../src/flow_hash.c"
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                         \
+        }                                                                    \
+    } while (0)
+
+#define TEST_RANDOM_KEYS 100000  // 随机流键的个数
+
+typedef struct {
+    const char* name;
+    uint32_t addr_len;
+    uint8_t src[16];
+    uint8_t dst[16];
+    uint16_t sport;
+    uint16_t dport;
+    uint8_t proto;
+} test_flow_t;
+
+static const test_flow_t test_flows[] = {
+    {"ipv4 tcp", 4, {10, 0, 0, 1}, {10, 0, 0, 2}, 1111, 80, 6},
+    {"ipv4 udp", 4, {192, 168, 1, 20}, {8, 8, 8, 8}, 53000, 53, 17},
+    {"ipv4 same address", 4, {10, 0, 0, 1}, {10, 0, 0, 1}, 5000, 53, 17},
+    {"ipv4 same endpoint", 4, {127, 0, 0, 1}, {127, 0, 0, 1}, 7, 7, 17},
+    {"ipv4 address only", 4, {10, 0, 0, 1}, {172, 16, 0, 9}, 0, 0, 0},
+    {"ipv4 extremes", 4, {255, 255, 255, 255}, {0, 0, 0, 0}, 65535, 0, 132},
+    {"ipv6 tcp", 16, {0x20, 0x01, 0x0d, 0xb8, [15] = 1}, {0x20, 0x01, 0x0d, 0xb8, [15] = 2}, 40000, 443, 6},
+    {"ipv6 high half differs", 16, {0x20, 0x01, [15] = 1}, {0xfe, 0x80, [15] = 1}, 1000, 2000, 17},
+    {"ipv6 same address", 16, {0xfe, 0x80, [15] = 5}, {0xfe, 0x80, [15] = 5}, 546, 547, 17},
+    {"ipv6 same endpoint", 16, {[15] = 1}, {[15] = 1}, 9, 9, 6},
+    {"ipv6 address only", 16, {0x20, 0x01, [8] = 0xff}, {0x20, 0x01, [7] = 0xff}, 0, 0, 0},
+    {"ipv6 extremes", 16, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+     {0}, 0, 65535, 132},
+};
+
+// 逐位计算的 CRC32C，作为两种实现的参照
+static uint32_t test_crc32c(uint32_t crc, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+    }
+    return crc;
+}
+
+// 流键的每个字按小端字节序参与计算，与 crc32 指令一致
+static uint32_t test_reference(const flow_key_t* key) {
+    uint32_t crc = FLOW_HASH_SEED;
+    for (uint32_t i = 0; i < key->count; i++) {
+        uint8_t bytes[8];
+        for (int k = 0; k < 8; k++) {
+            bytes[k] = (uint8_t)(key->word[i] >> (k * 8));
+        }
+        crc = test_crc32c(crc, bytes, sizeof(bytes));
+    }
+    return crc;
+}
+
+// 查表与硬件指令都应与参照一致
+static void test_kernels(const flow_key_t* key) {
+    uint32_t expected = test_reference(key);
+    CHECK(flow_hash_soft(key) == expected);
+#if defined(FLOW_HASH_X86) || defined(FLOW_HASH_ARM)
+    if (flow_hash_hw) {
+        CHECK(flow_hash_crc(key) == expected);
+    }
+#endif
+}
+
+static void test_table(void) {
+    for (size_t i = 0; i < sizeof(test_flows) / sizeof(test_flows[0]); i++) {
+        const test_flow_t* t = &test_flows[i];
+        uint32_t forward = flow_hash(t->src, t->dst, t->addr_len, t->sport, t->dport, t->proto);
+        uint32_t reverse = flow_hash(t->dst, t->src, t->addr_len, t->dport, t->sport, t->proto);
+        if (forward != reverse) {
+            fprintf(stderr, "%s: forward %08x reverse %08x\n", t->name, forward, reverse);
+        }
+        CHECK(forward == reverse);
+
+        flow_key_t key;
+        flow_key_build(&key, t->src, t->dst, t->addr_len, t->sport, t->dport, t->proto);
+        CHECK(key.count == (t->addr_len == 4 ? 2u : 5u));
+        test_kernels(&key);
+        flow_key_build(&key, t->dst, t->src, t->addr_len, t->dport, t->sport, t->proto);
+        test_kernels(&key);
+
+        // 协议号参与哈希
+        CHECK(flow_hash(t->src, t->dst, t->addr_len, t->sport, t->dport, (uint8_t)(t->proto ^ 1)) != forward);
+    }
+}
+
+static uint64_t test_rng = 0x9e3779b97f4a7c15ull;
+
+static uint64_t test_next(void) {
+    test_rng ^= test_rng << 13;
+    test_rng ^= test_rng >> 7;
+    test_rng ^= test_rng << 17;
+    return test_rng;
+}
+
+static void test_random(void) {
+    for (uint32_t i = 0; i < TEST_RANDOM_KEYS; i++) {
+        uint8_t src[16];
+        uint8_t dst[16];
+        uint64_t words[4] = {test_next(), test_next(), test_next(), test_next()};
+        memcpy(src, words, sizeof(src));
+        memcpy(dst, words + 2, sizeof(dst));
+        uint64_t extra = test_next();
+        uint32_t addr_len = (extra & 1) ? 16 : 4;
+        uint16_t sport = (uint16_t)(extra >> 8);
+        uint16_t dport = (uint16_t)(extra >> 24);
+        uint8_t proto = (uint8_t)(extra >> 40);
+        if (extra & 2) {
+            // 地址相同时按端口排序
+            memcpy(dst, src, sizeof(dst));
+        }
+
+        CHECK(flow_hash(src, dst, addr_len, sport, dport, proto) ==
+              flow_hash(dst, src, addr_len, dport, sport, proto));
+        flow_key_t key;
+        flow_key_build(&key, src, dst, addr_len, sport, dport, proto);
+        test_kernels(&key);
+    }
+}
+
+int main(void) {
+    // 参照实现本身按标准校验值验证
+    CHECK((test_crc32c(0xffffffffu, (const uint8_t*)"123456789", 9) ^ 0xffffffffu) == 0xe3069283u);
+
+    test_table();
+    test_random();
+    printf("test_flow_hash: ok (%s)\n", flow_hash_accelerated() ? "hardware and table" : "table only");
+    return 0;
+}
@@ -0,0 +1,428 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "packet_decode.h"
+#include "flow_hash.h"
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                         \
+        }                                                                    \
+    } while (0)
+
+#define TEST_FRAME_MAX 512
+#define TEST_SPORT     1111      // 内层流的客户端端口
+#define TEST_DPORT     80        // 内层流的服务端端口
+
+typedef struct {
+    uint8_t data[TEST_FRAME_MAX];
+    uint32_t len;
+    bool reverse;                // 内层流取反方向
+} test_frame_t;
+
+static void test_u8(test_frame_t* f, uint32_t v) {
+    CHECK(f->len < TEST_FRAME_MAX);
+    f->data[f->len++] = (uint8_t)v;
+}
+
+static void test_u16(test_frame_t* f, uint32_t v) {
+    test_u8(f, v >> 8);
+    test_u8(f, v & 0xff);
+}
+
+static void test_fill(test_frame_t* f, uint32_t count, uint32_t v) {
+    for (uint32_t i = 0; i < count; i++) {
+        test_u8(f, v);
+    }
+}
+
+static void test_eth(test_frame_t* f, uint32_t ethertype) {
+    for (uint32_t i = 0; i < 12; i++) {
+        test_u8(f, i);
+    }
+    test_u16(f, ethertype);
+}
+
+// 地址为 10.0.0.a 与 10.0.0.b
+static void test_ipv4(test_frame_t* f, uint32_t proto, uint32_t a, uint32_t b, uint32_t frag) {
+    test_u8(f, 0x45);
+    test_u8(f, 0);
+    test_u16(f, 60);
+    test_u16(f, 1);
+    test_u16(f, frag);
+    test_u8(f, 64);
+    test_u8(f, proto);
+    test_u16(f, 0);
+    test_u8(f, 10);
+    test_u8(f, 0);
+    test_u8(f, 0);
+    test_u8(f, a);
+    test_u8(f, 10);
+    test_u8(f, 0);
+    test_u8(f, 0);
+    test_u8(f, b);
+}
+
+// 地址为 2001:db8::a 与 2001:db8::b
+static void test_ipv6(test_frame_t* f, uint32_t next, uint32_t a, uint32_t b) {
+    test_u8(f, 0x60);
+    test_fill(f, 3, 0);
+    test_u16(f, 20);
+    test_u8(f, next);
+    test_u8(f, 64);
+    test_u16(f, 0x2001);
+    test_u16(f, 0x0db8);
+    test_fill(f, 11, 0);
+    test_u8(f, a);
+    test_u16(f, 0x2001);
+    test_u16(f, 0x0db8);
+    test_fill(f, 11, 0);
+    test_u8(f, b);
+}
+
+static void test_udp(test_frame_t* f, uint32_t sport, uint32_t dport) {
+    test_u16(f, sport);
+    test_u16(f, dport);
+    test_u16(f, 8);
+    test_u16(f, 0);
+}
+
+static void test_tcp(test_frame_t* f, uint32_t sport, uint32_t dport) {
+    test_u16(f, sport);
+    test_u16(f, dport);
+    test_fill(f, 16, 0);
+}
+
+// 按 reverse 选方向的内层 TCP 流
+static void test_inner4(test_frame_t* f) {
+    test_ipv4(f, 6, f->reverse ? 2 : 1, f->reverse ? 1 : 2, 0);
+    test_tcp(f, f->reverse ? TEST_DPORT : TEST_SPORT, f->reverse ? TEST_SPORT : TEST_DPORT);
+}
+
+static void test_inner6(test_frame_t* f, uint32_t next) {
+    test_ipv6(f, next, f->reverse ? 2 : 1, f->reverse ? 1 : 2);
+}
+
+static void test_inner6_tcp(test_frame_t* f) {
+    test_tcp(f, f->reverse ? TEST_DPORT : TEST_SPORT, f->reverse ? TEST_SPORT : TEST_DPORT);
+}
+
+// IPv6 扩展头：len8 为以 8 字节为单位、不含前 8 字节的长度
+static void test_ext(test_frame_t* f, uint32_t next, uint32_t len8) {
+    test_u8(f, next);
+    test_u8(f, len8);
+    test_fill(f, 6 + len8 * 8, 1);
+}
+
+// AH：长度以 4 字节为单位、不含前 8 字节中的 2 个单位，这里共 24 字节
+static void test_ah(test_frame_t* f, uint32_t next) {
+    test_u8(f, next);
+    test_u8(f, 4);
+    test_fill(f, 22, 0);
+}
+
+static void test_frag6(test_frame_t* f, uint32_t next, uint32_t offset, bool more) {
+    test_u8(f, next);
+    test_u8(f, 0);
+    test_u16(f, offset << 3 | (more ? 1 : 0));
+    test_u16(f, 0);
+    test_u16(f, 77);
+}
+
+static void test_vxlan(test_frame_t* f) {
+    test_udp(f, 5555, 4789);
+    test_u8(f, 0x08);
+    test_fill(f, 3, 0);
+    test_u16(f, 0);
+    test_u8(f, 1);
+    test_u8(f, 0);
+}
+
+static void build_plain4(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    test_inner4(f);
+}
+
+static void build_vlan_vxlan(test_frame_t* f) {
+    test_eth(f, 0x8100);
+    test_u16(f, 5);
+    test_u16(f, 0x0800);
+    test_ipv4(f, 17, 7, 8, 0);
+    test_vxlan(f);
+    test_eth(f, 0x0800);
+    test_inner4(f);
+}
+
+static void build_qinq(test_frame_t* f) {
+    test_eth(f, 0x88a8);
+    test_u16(f, 7);
+    test_u16(f, 0x8100);
+    test_u16(f, 9);
+    test_u16(f, 0x0800);
+    test_inner4(f);
+}
+
+static void build_mpls(test_frame_t* f) {
+    test_eth(f, 0x8847);
+    test_u16(f, 0);
+    test_u8(f, 0);
+    test_u8(f, 64);
+    test_u16(f, 0);
+    test_u8(f, 1);
+    test_u8(f, 64);
+    test_inner4(f);
+}
+
+static void build_gre_key(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    test_ipv4(f, 47, 7, 8, 0);
+    test_u16(f, 0x2000);
+    test_u16(f, 0x0800);
+    test_u16(f, 0);
+    test_u16(f, 42);
+    test_inner4(f);
+}
+
+static void build_gre_teb(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    test_ipv4(f, 47, 7, 8, 0);
+    test_u16(f, 0);
+    test_u16(f, 0x6558);
+    test_eth(f, 0x0800);
+    test_inner4(f);
+}
+
+static void build_geneve(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    test_ipv4(f, 17, 7, 8, 0);
+    test_udp(f, 5, 6081);
+    // 一个 4 字节的选项
+    test_u8(f, 1);
+    test_u8(f, 0);
+    test_u16(f, 0x6558);
+    test_fill(f, 8, 0);
+    test_eth(f, 0x0800);
+    test_inner4(f);
+}
+
+static void build_ipv4_in_ipv6(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_ipv6(f, 4, 1, 2);
+    test_inner4(f);
+}
+
+static void build_ipip_deep(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    for (uint32_t i = 0; i < 6; i++) {
+        test_ipv4(f, 4, 20 + i, 30 + i, 0);
+    }
+    test_inner4(f);
+}
+
+// 外层分片无法剥离，按外层地址对哈希
+static void build_outer_fragment(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    test_ipv4(f, 4, f->reverse ? 2 : 1, f->reverse ? 1 : 2, 0x2000);
+    test_inner4(f);
+}
+
+// 内层以太网帧后没有 IP 头部，哈希退回外层 IP 与 UDP 头部；外层端口固定，不取反方向
+static void build_vxlan_truncated(test_frame_t* f) {
+    test_eth(f, 0x0800);
+    test_ipv4(f, 17, 1, 2, 0);
+    test_udp(f, 5555, 4789);
+    test_u8(f, 0x08);
+    test_fill(f, 7, 0);
+    test_eth(f, 0x0800);
+}
+
+static void build_plain6(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 6);
+    test_inner6_tcp(f);
+}
+
+static void build_ext_chain(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 0);
+    test_ext(f, 60, 0);
+    test_ext(f, 43, 1);
+    test_ext(f, 51, 0);
+    test_ah(f, 6);
+    test_inner6_tcp(f);
+}
+
+static void build_frag_first(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 0);
+    test_ext(f, 44, 0);
+    test_frag6(f, 6, 0, true);
+    test_inner6_tcp(f);
+}
+
+static void build_frag_later(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 44);
+    test_frag6(f, 6, 100, false);
+    test_inner6_tcp(f);
+}
+
+static void build_frag_atomic(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 44);
+    test_frag6(f, 6, 0, false);
+    test_inner6_tcp(f);
+}
+
+static void build_ext_too_many(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 60);
+    for (uint32_t i = 0; i < 9; i++) {
+        test_ext(f, 60, 0);
+    }
+    test_inner6_tcp(f);
+}
+
+static void build_ext_truncated(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_inner6(f, 60);
+    test_u8(f, 6);
+}
+
+static void build_ext_then_ipip(test_frame_t* f) {
+    test_eth(f, 0x86dd);
+    test_ipv6(f, 60, 1, 2);
+    test_ext(f, 4, 0);
+    test_inner4(f);
+}
+
+typedef enum {
+    TEST_HASH_V4_PORTS,          // 内层 IPv4 五元组
+    TEST_HASH_V6_PORTS,          // 内层 IPv6 五元组
+    TEST_HASH_V6_ADDRS,          // 只有 IPv6 地址对
+    TEST_HASH_V4_ADDRS,          // 只有 IPv4 地址对
+    TEST_HASH_V4_VXLAN,          // 外层 IPv4 与 VXLAN 的 UDP 头部
+} test_hash_t;
+
+typedef struct {
+    const char* name;
+    void (*build)(test_frame_t* f);
+    uint32_t protocol;
+    uint16_t l3_offset;
+    uint16_t l4_offset;
+    uint8_t l4_proto;
+    uint32_t encap;
+    bool fragment;
+    uint16_t frag_hdr_offset;
+    test_hash_t hash;
+} test_case_t;
+
+#define L(index, layer) ((uint32_t)(layer) << ((index) * 4))
+
+static const test_case_t test_cases[] = {
+    // 隧道剥离
+    {"plain ipv4", build_plain4, 0x0800, 14, 34, 6, 0, false, 0, TEST_HASH_V4_PORTS},
+    {"vlan vxlan", build_vlan_vxlan, 0x0800, 68, 88, 6,
+     L(0, PACKET_ENCAP_VLAN) | L(1, PACKET_ENCAP_IPV4) | L(2, PACKET_ENCAP_VXLAN), false, 0, TEST_HASH_V4_PORTS},
+    {"qinq", build_qinq, 0x0800, 22, 42, 6, L(0, PACKET_ENCAP_QINQ) | L(1, PACKET_ENCAP_VLAN), false, 0,
+     TEST_HASH_V4_PORTS},
+    {"mpls", build_mpls, 0x0800, 22, 42, 6, L(0, PACKET_ENCAP_MPLS), false, 0, TEST_HASH_V4_PORTS},
+    {"gre key", build_gre_key, 0x0800, 42, 62, 6, L(0, PACKET_ENCAP_IPV4) | L(1, PACKET_ENCAP_GRE), false, 0,
+     TEST_HASH_V4_PORTS},
+    {"gre teb", build_gre_teb, 0x0800, 52, 72, 6, L(0, PACKET_ENCAP_IPV4) | L(1, PACKET_ENCAP_GRE), false, 0,
+     TEST_HASH_V4_PORTS},
+    {"geneve", build_geneve, 0x0800, 68, 88, 6, L(0, PACKET_ENCAP_IPV4) | L(1, PACKET_ENCAP_GENEVE), false, 0,
+     TEST_HASH_V4_PORTS},
+    {"ipv4 in ipv6", build_ipv4_in_ipv6, 0x0800, 54, 74, 6, L(0, PACKET_ENCAP_IPV6), false, 0, TEST_HASH_V4_PORTS},
+    {"ipip x6", build_ipip_deep, 0x0800, 134, 154, 6,
+     L(0, PACKET_ENCAP_IPV4) | L(1, PACKET_ENCAP_IPV4) | L(2, PACKET_ENCAP_IPV4) | L(3, PACKET_ENCAP_IPV4) |
+         L(4, PACKET_ENCAP_IPV4) | L(5, PACKET_ENCAP_IPV4),
+     false, 0, TEST_HASH_V4_PORTS},
+    {"outer fragment", build_outer_fragment, 0x0800, 14, 34, 4, 0, true, 0, TEST_HASH_V4_ADDRS},
+    {"vxlan truncated", build_vxlan_truncated, 0x0800, 64, 0, 0,
+     L(0, PACKET_ENCAP_IPV4) | L(1, PACKET_ENCAP_VXLAN), false, 0, TEST_HASH_V4_VXLAN},
+
+    // IPv6 扩展头
+    {"plain ipv6", build_plain6, 0x86dd, 14, 54, 6, 0, false, 0, TEST_HASH_V6_PORTS},
+    {"hbh dst rt ah", build_ext_chain, 0x86dd, 14, 110, 6, 0, false, 0, TEST_HASH_V6_PORTS},
+    {"first fragment", build_frag_first, 0x86dd, 14, 70, 6, 0, true, 62, TEST_HASH_V6_ADDRS},
+    {"later fragment", build_frag_later, 0x86dd, 14, 0, 6, 0, true, 54, TEST_HASH_V6_ADDRS},
+    {"atomic fragment", build_frag_atomic, 0x86dd, 14, 62, 6, 0, false, 54, TEST_HASH_V6_PORTS},
+    {"too many headers", build_ext_too_many, 0x86dd, 14, 0, 60, 0, false, 0, TEST_HASH_V6_ADDRS},
+    {"truncated header", build_ext_truncated, 0x86dd, 14, 0, 60, 0, false, 0, TEST_HASH_V6_ADDRS},
+    {"dst opts ipip", build_ext_then_ipip, 0x0800, 62, 82, 6, L(0, PACKET_ENCAP_IPV6), false, 0,
+     TEST_HASH_V4_PORTS},
+};
+
+static uint32_t test_expected_hash(test_hash_t kind) {
+    static const uint8_t v4_a[4] = {10, 0, 0, 1};
+    static const uint8_t v4_b[4] = {10, 0, 0, 2};
+    static const uint8_t v6_a[16] = {0x20, 0x01, 0x0d, 0xb8, [15] = 1};
+    static const uint8_t v6_b[16] = {0x20, 0x01, 0x0d, 0xb8, [15] = 2};
+    switch (kind) {
+        case TEST_HASH_V4_PORTS:
+            return flow_hash(v4_a, v4_b, 4, TEST_SPORT, TEST_DPORT, 6);
+        case TEST_HASH_V6_PORTS:
+            return flow_hash(v6_a, v6_b, 16, TEST_SPORT, TEST_DPORT, 6);
+        case TEST_HASH_V6_ADDRS:
+            return flow_hash(v6_a, v6_b, 16, 0, 0, 0);
+        case TEST_HASH_V4_VXLAN:
+            return flow_hash(v4_a, v4_b, 4, 5555, 4789, 17);
+        case TEST_HASH_V4_ADDRS:
+        default:
+            return flow_hash(v4_a, v4_b, 4, 0, 0, 0);
+    }
+}
+
+static void test_decode(const test_case_t* t, bool reverse) {
+    test_frame_t frame = {.reverse = reverse};
+    t->build(&frame);
+    packet_t pkt = {
+        .data = frame.data,
+        .len = frame.len,
+        .caplen = frame.len,
+    };
+    packet_decode(&pkt, PACKET_LINKTYPE_ETHERNET);
+
+    if (pkt.protocol != t->protocol || pkt.l3_offset != t->l3_offset || pkt.l4_offset != t->l4_offset ||
+        pkt.l4_proto != t->l4_proto || pkt.encap != t->encap || pkt.frag_hdr_offset != t->frag_hdr_offset) {
+        fprintf(stderr, "%s%s: protocol %04x l3 %u l4 %u l4_proto %u encap %08x frag_hdr %u\n", t->name,
+                reverse ? " (reverse)" : "", pkt.protocol, pkt.l3_offset, pkt.l4_offset, pkt.l4_proto,
+                pkt.encap, pkt.frag_hdr_offset);
+        exit(1);
+    }
+    CHECK(pkt.flags & PACKET_FLAG_DECODED);
+    CHECK(((pkt.flags & PACKET_FLAG_FRAGMENT) != 0) == t->fragment);
+    if (pkt.hash != test_expected_hash(t->hash)) {
+        fprintf(stderr, "%s%s: hash %08x expected %08x\n", t->name, reverse ? " (reverse)" : "", pkt.hash,
+                test_expected_hash(t->hash));
+        exit(1);
+    }
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
+        test_decode(&test_cases[i], false);
+        test_decode(&test_cases[i], true);
+    }
+
+    // 超过 PACKET_ENCAP_MAX 层时停在当前层
+    test_frame_t frame = {0};
+    test_eth(&frame, 0x0800);
+    for (uint32_t i = 0; i < PACKET_ENCAP_MAX + 1; i++) {
+        test_ipv4(&frame, 4, 20 + i, 30 + i, 0);
+    }
+    test_inner4(&frame);
+    packet_t pkt = {.data = frame.data, .len = frame.len, .caplen = frame.len};
+    packet_decode(&pkt, PACKET_LINKTYPE_ETHERNET);
+    for (uint32_t i = 0; i < PACKET_ENCAP_MAX; i++) {
+        CHECK(PACKET_ENCAP_LAYER(pkt.encap, i) == PACKET_ENCAP_IPV4);
+    }
+    CHECK(pkt.l3_offset == 14 + PACKET_ENCAP_MAX * 20);
+    CHECK(pkt.l4_proto == 4);
+
+    printf("test_packet_decode: ok\n");
+    return 0;
+}